@@ -0,0 +1,254 @@
+#ifndef ENBT_ASYNC_IO
+#define ENBT_ASYNC_IO
+#include "io.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace enbt {
+    namespace io_helper {
+        template <class T = void>
+        class task;
+
+        namespace __impl__ {
+            struct task_promise_base {
+                std::coroutine_handle<> continuation = std::noop_coroutine();
+                std::exception_ptr error;
+                //set by whichever of the awaiter and the ending body comes second, that one resumes the awaiter,
+                // so a body that ends without suspending returns to its awaiter instead of resuming it on top of the stack
+                std::atomic<bool> rendezvous = false;
+
+                struct final_awaiter {
+                    bool await_ready() const noexcept {
+                        return false;
+                    }
+
+                    template <class Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                        auto& promise = handle.promise();
+                        if (promise.rendezvous.exchange(true, std::memory_order_acq_rel))
+                            return promise.continuation;
+                        return std::noop_coroutine();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                std::suspend_always initial_suspend() const noexcept {
+                    return {};
+                }
+
+                final_awaiter final_suspend() const noexcept {
+                    return {};
+                }
+
+                void unhandled_exception() noexcept {
+                    error = std::current_exception();
+                }
+            };
+
+            template <class T>
+            struct task_promise : task_promise_base {
+                std::optional<T> result;
+
+                template <class U>
+                void return_value(U&& value) {
+                    result.emplace(std::forward<U>(value));
+                }
+
+                T take() {
+                    if (error)
+                        std::rethrow_exception(error);
+                    return std::move(*result);
+                }
+            };
+
+            template <>
+            struct task_promise<void> : task_promise_base {
+                void return_void() const noexcept {}
+
+                void take() {
+                    if (error)
+                        std::rethrow_exception(error);
+                }
+            };
+        }
+
+        //lazy coroutine, the body starts when the task is awaited or started and resumes its awaiter when it ends
+        // exceptions of the body are rethrown by co_await or result
+        template <class T>
+        class [[nodiscard]] task {
+        public:
+            struct promise_type : __impl__::task_promise<T> {
+                task get_return_object() noexcept {
+                    return task(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+            };
+
+            task(task&& other) noexcept
+                : handle(std::exchange(other.handle, {})) {}
+
+            task& operator=(task&& other) noexcept {
+                if (this != &other) {
+                    if (handle)
+                        handle.destroy();
+                    handle = std::exchange(other.handle, {});
+                }
+                return *this;
+            }
+
+            ~task() {
+                if (handle)
+                    handle.destroy();
+            }
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiter) noexcept {
+                handle.promise().continuation = awaiter;
+                handle.resume();
+                return !handle.promise().rendezvous.exchange(true, std::memory_order_acq_rel);
+            }
+
+            T await_resume() {
+                return handle.promise().take();
+            }
+
+            //runs the body from outside of a coroutine until its first suspension, for event loops that drive tasks themselves
+            void start() {
+                handle.promise().rendezvous.store(true, std::memory_order_relaxed);
+                handle.resume();
+            }
+
+            bool done() const noexcept {
+                return handle.done();
+            }
+
+            //only valid after done returns true
+            T result() {
+                return handle.promise().take();
+            }
+
+        private:
+            explicit task(std::coroutine_handle<promise_type> handle) noexcept
+                : handle(handle) {}
+
+            std::coroutine_handle<promise_type> handle;
+        };
+
+        //transport interfaces for the async reader and writer, implemented over sockets or pipes of an event loop
+        class async_byte_source {
+        public:
+            virtual ~async_byte_source() = default;
+            //reads at least one byte into buffer, 0 only at the end of input
+            virtual task<std::size_t> read_some(std::span<std::byte> buffer) = 0;
+        };
+
+        class async_byte_sink {
+        public:
+            virtual ~async_byte_sink() = default;
+            //completes when all of data is taken, data is not used after that
+            virtual task<> write(std::span<const std::byte> data) = 0;
+        };
+
+        //in process transport, bytes written to it are read back from it
+        // both ends must be used from one thread, a read of an empty pipe suspends until a write or close,
+        // a write to a full pipe suspends until a read makes room, the woken side runs when the other side
+        // suspends on the pipe or closes it, control is passed by symmetric transfer so the stack does not grow
+        class async_pipe : public async_byte_source, public async_byte_sink {
+            std::vector<std::byte> buffer;
+            std::size_t read_pos = 0;
+            std::size_t limit;
+            bool closed = false;
+            std::coroutine_handle<> waiting_reader;
+            std::coroutine_handle<> waiting_writer;
+            std::coroutine_handle<> ready;
+
+            struct wait {
+                std::coroutine_handle<>& slot;
+                std::coroutine_handle<>& ready;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle) noexcept {
+                    slot = handle;
+                    if (ready)
+                        return std::exchange(ready, {});
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            void wake(std::coroutine_handle<>& slot);
+
+        public:
+            //limit caps both the buffered bytes and the bytes one read_some returns
+            async_pipe(std::size_t limit = output_sink::staging_size);
+            async_pipe(const async_pipe&) = delete;
+            async_pipe& operator=(const async_pipe&) = delete;
+
+            task<std::size_t> read_some(std::span<std::byte> out) override;
+            task<> write(std::span<const std::byte> data) override;
+            //ends the input, reads return 0 once the buffered bytes are read, a woken side is resumed from here
+            void close();
+        };
+
+        //awaitable counterpart of value_read_stream, bytes are decoded by push_decoder as they arrive,
+        // so only the values are kept and never the encoded message
+        class async_value_reader {
+            async_byte_source& source;
+            std::vector<std::byte> buffer;
+            std::deque<value> ready;
+            push_decoder decoder;
+
+        public:
+            async_value_reader(async_byte_source& source, std::size_t chunk_size = output_sink::staging_size);
+            async_value_reader(const async_value_reader&) = delete;
+            async_value_reader& operator=(const async_value_reader&) = delete;
+
+            //empty at the end of input, throws enbt::exception when the input ends inside a token
+            task<std::optional<value>> try_read();
+            //throws enbt::exception at the end of input
+            task<value> read();
+            //throws enbt::exception when the token is not a compound
+            task<value> read_compound();
+        };
+
+        //awaitable counterpart of value_write_stream, tokens are encoded into a staging buffer that is handed to the sink
+        // once it reaches chunk_size, containers larger than that are split between their items and
+        // strings larger than that are handed to the sink straight from the value, other leaves are staged whole
+        class async_value_writer {
+            async_byte_sink& sink;
+            std::vector<std::uint8_t> staging;
+            std::size_t chunk_size;
+
+            bool splits(const value& val) const;
+            //returns the staged size
+            std::size_t stage(const value& val, bool with_type_id);
+            task<> write_part(const value& val, bool with_type_id);
+
+        public:
+            async_value_writer(async_byte_sink& sink, std::size_t chunk_size = output_sink::staging_size);
+            async_value_writer(const async_value_writer&) = delete;
+            async_value_writer& operator=(const async_value_writer&) = delete;
+
+            //the value must stay alive and unchanged until the write completes
+            task<> write(const value& val);
+            //hands the staged bytes to the sink, must be awaited after the last write
+            task<> flush();
+        };
+    }
+}
+
+#endif /* ENBT_ASYNC_IO */
@@ -0,0 +1,101 @@
+//lookup, iteration and build times of flat_compound against std::unordered_map<std::string, value>
+// build: g++ -std=c++20 -O2 -I.. flat_compound.cpp ../enbt.cpp -o flat_compound -lpthread
+#include "../enbt.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using map_type = std::unordered_map<std::string, enbt::value>;
+
+static volatile std::int64_t sink;
+
+template <class FN>
+static double measure(std::size_t operations, FN&& fn) {
+    fn(); //warm up
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / double(operations);
+}
+
+static std::vector<std::string> make_names(std::size_t count) {
+    static const char* common[] = {"id", "pos", "name", "type", "x", "y", "z", "owner", "health", "flags", "tags", "time", "rot", "vel", "data", "meta"};
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; i++)
+        names.push_back(i < std::size(common) ? std::string(common[i]) : "field_" + std::to_string(i));
+    return names;
+}
+
+static void run(std::size_t keys) {
+    constexpr std::size_t compounds = 20000;
+    auto names = make_names(keys);
+    std::vector<enbt::key> handles;
+    for (auto& name : names)
+        handles.emplace_back(name);
+
+    std::vector<map_type> maps(compounds);
+    std::vector<enbt::flat_compound> flats(compounds);
+    double build_map = measure(compounds * keys, [&] {
+        for (auto& map : maps) {
+            map.clear();
+            for (std::size_t i = 0; i < keys; i++)
+                map.insert_or_assign(names[i], enbt::value(std::int32_t(i)));
+        }
+    });
+    double build_flat = measure(compounds * keys, [&] {
+        for (auto& flat : flats) {
+            flat.clear();
+            for (std::size_t i = 0; i < keys; i++)
+                flat.insert_or_assign(names[i], enbt::value(std::int32_t(i)));
+        }
+    });
+
+    double find_map = measure(compounds * keys, [&] {
+        std::int64_t total = 0;
+        for (auto& map : maps)
+            for (auto& name : names)
+                total += (std::int32_t)map.find(name)->second;
+        sink = total;
+    });
+    double find_flat = measure(compounds * keys, [&] {
+        std::int64_t total = 0;
+        for (auto& flat : flats)
+            for (auto& name : names)
+                total += (std::int32_t)flat.find(std::string_view(name))->second;
+        sink = total;
+    });
+    double find_key = measure(compounds * keys, [&] {
+        std::int64_t total = 0;
+        for (auto& flat : flats)
+            for (auto& handle : handles)
+                total += (std::int32_t)flat.find(handle)->second;
+        sink = total;
+    });
+
+    double iterate_map = measure(compounds * keys, [&] {
+        std::int64_t total = 0;
+        for (auto& map : maps)
+            for (auto& [name, item] : map)
+                total += (std::int32_t)item;
+        sink = total;
+    });
+    double iterate_flat = measure(compounds * keys, [&] {
+        std::int64_t total = 0;
+        for (auto& flat : flats)
+            for (const auto& [name, item] : flat)
+                total += (std::int32_t)item;
+        sink = total;
+    });
+
+    std::printf("%6zu keys | build %7.2f %7.2f | find %7.2f %7.2f %7.2f | iterate %7.2f %7.2f\n",
+                keys, build_map, build_flat, find_map, find_flat, find_key, iterate_map, iterate_flat);
+}
+
+int main() {
+    std::printf("ns per key, unordered_map then flat_compound (find by string_view, then by enbt::key)\n");
+    for (std::size_t keys : {4, 8, 16, 32, 128})
+        run(keys);
+    return 0;
+}
@@ -0,0 +1,139 @@
+//var_integer and comp_integer codecs against the byte at a time loops they replaced
+// build: g++ -std=c++20 -O2 -I.. varint.cpp ../enbt.cpp -o varint -lpthread
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static volatile std::uint64_t sink;
+
+template <class FN>
+static double measure(std::size_t operations, FN&& fn) {
+    fn(); //warm up
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / double(operations);
+}
+
+static std::size_t byte_loop_decode_var(const std::uint8_t* data, std::uint64_t& value) {
+    value = 0;
+    std::size_t i = 0;
+    for (int shift = 0;; shift += 7) {
+        std::uint8_t byte = data[i++];
+        value |= std::uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return i;
+    }
+}
+
+static std::size_t byte_loop_encode_var(std::uint64_t value, std::uint8_t* out) {
+    std::size_t i = 0;
+    do {
+        std::uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[i++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return i;
+}
+
+static std::size_t byte_loop_decode_compress_len(const std::uint8_t* data, std::uint64_t& value) {
+    std::size_t len = std::size_t(1) << (data[0] >> 6);
+    value = data[0] & 0x3F;
+    for (std::size_t i = 1; i < len; i++)
+        value |= std::uint64_t(data[i]) << (6 + 8 * (i - 1));
+    return len;
+}
+
+static std::vector<std::uint64_t> make_values(std::size_t count, int bits) {
+    std::mt19937_64 random(bits);
+    std::vector<std::uint64_t> values(count);
+    for (auto& value : values)
+        value = bits == 64 ? random() : random() & ((std::uint64_t(1) << bits) - 1);
+    return values;
+}
+
+static void run_var(int bits) {
+    constexpr std::size_t count = 1 << 20;
+    auto values = make_values(count, bits);
+    std::vector<std::uint8_t> bytes(count * max_var_size + 16);
+    std::vector<std::uint64_t> out(count);
+
+    double encode_loop = measure(count, [&] {
+        std::size_t offset = 0;
+        for (auto value : values)
+            offset += byte_loop_encode_var(value, bytes.data() + offset);
+        sink = offset;
+    });
+    double encode_word = measure(count, [&] {
+        sink = encode_vars(values.data(), count, bytes.data());
+    });
+    std::size_t size = encode_vars(values.data(), count, bytes.data());
+
+    double decode_loop = measure(count, [&] {
+        std::size_t offset = 0;
+        for (auto& value : out)
+            offset += byte_loop_decode_var(bytes.data() + offset, value);
+        sink = offset;
+    });
+    double decode_word = measure(count, [&] {
+        sink = decode_vars(bytes.data(), size, out.data(), count);
+    });
+    double read_span = measure(count, [&] {
+        span_stream in(bytes.data(), size);
+        read_vars(in, out.data(), count);
+        sink = out.back();
+    });
+    std::string text((const char*)bytes.data(), size);
+    double read_istream = measure(count, [&] {
+        std::istringstream in(text);
+        read_vars(in, out.data(), count);
+        sink = out.back();
+    });
+    std::printf("var %2d bits | encode %6.2f %6.2f | decode %6.2f %6.2f | read_vars span %6.2f istream %6.2f\n",
+                bits, encode_loop, encode_word, decode_loop, decode_word, read_span, read_istream);
+}
+
+static void run_compress_len(int bits) {
+    constexpr std::size_t count = 1 << 20;
+    auto values = make_values(count, bits);
+    std::vector<std::uint8_t> bytes(count * 8 + 8);
+    std::size_t size = 0;
+    for (auto value : values)
+        size += encode_compress_len(value, bytes.data() + size);
+
+    double decode_loop = measure(count, [&] {
+        std::uint64_t value, total = 0;
+        for (std::size_t offset = 0; offset < size; total += value)
+            offset += byte_loop_decode_compress_len(bytes.data() + offset, value);
+        sink = total;
+    });
+    double decode_word = measure(count, [&] {
+        std::uint64_t value, total = 0;
+        for (std::size_t offset = 0; offset < size; total += value)
+            offset += decode_compress_len(bytes.data() + offset, size - offset, value);
+        sink = total;
+    });
+    double read_span = measure(count, [&] {
+        span_stream in(bytes.data(), size);
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < count; i++)
+            total += read_compress_len(in);
+        sink = total;
+    });
+    std::printf("compress_len %2d bits | decode %6.2f %6.2f | read_compress_len span %6.2f\n", bits, decode_loop, decode_word, read_span);
+}
+
+int main() {
+    std::printf("ns per value, byte loop then word codec\n");
+    for (int bits : {7, 14, 35, 64})
+        run_var(bits);
+    for (int bits : {6, 14, 30, 62})
+        run_compress_len(bits);
+    return 0;
+}
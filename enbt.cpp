@@ -1,17 +1,52 @@
 #include "enbt.hpp"
 #include "io.hpp"
+#include "async_io.hpp"
+#include "view.hpp"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <random>
 #include <sstream>
+#include <thread>
+#include <utility>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || (defined(_M_IX86) && !defined(_M_ARM64EC))
+    #define ENBT_SIMD_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define ENBT_TARGET_SSE42
+        #define ENBT_TARGET_AVX2
+    #else
+        #define ENBT_TARGET_SSE42 __attribute__((target("sse4.2")))
+        #define ENBT_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    //32 bit arm lacks the 64 bit compares and across vector adds the kernels use
+    #define ENBT_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 #pragma region value constructors
 
 namespace enbt {
     namespace endian_helpers {
         void endian_swap(void* value_ptr, std::size_t len) {
-            std::byte* prox = static_cast<std::byte*>(value_ptr);
-            std::reverse(prox, prox + len);
+            byteswap_items(value_ptr, value_ptr, len, 1);
         }
     }
 
@@ -60,40 +95,212 @@ namespace enbt {
             return enbt::type_len::Tiny;
     }
 
+    thread_local std::pmr::memory_resource* current_memory_resource = nullptr;
+
+    std::pmr::memory_resource* get_memory_resource() noexcept {
+        return current_memory_resource;
+    }
+
+    memory_scope::memory_scope(std::pmr::memory_resource* resource) noexcept
+        : previous(current_memory_resource) {
+        current_memory_resource = resource;
+    }
+
+    memory_scope::~memory_scope() {
+        current_memory_resource = previous;
+    }
+
+    key::key(std::string_view name)
+        : key(symbol_table::global().intern(name)) {}
+
+    key symbol_table::intern(std::string_view name) {
+        {
+            std::shared_lock lock(mutex);
+            auto it = names.find(name);
+            if (it != names.end())
+                return it->second.get();
+        }
+        auto entry = std::make_unique<__impl__::interned_name>(std::string(name), std::hash<std::string_view>{}(name));
+        std::unique_lock lock(mutex);
+        auto [it, inserted] = names.try_emplace(entry->name, nullptr);
+        if (inserted)
+            it->second = std::move(entry);
+        return it->second.get();
+    }
+
+    std::optional<key> symbol_table::find(std::string_view name) const {
+        std::shared_lock lock(mutex);
+        auto it = names.find(name);
+        if (it != names.end())
+            return key(it->second.get());
+        return std::nullopt;
+    }
+
+    std::size_t symbol_table::size() const {
+        std::shared_lock lock(mutex);
+        return names.size();
+    }
+
+    symbol_table& symbol_table::global() {
+        //never destroyed, keys may be used from static destructors
+        static symbol_table* table = new symbol_table();
+        return *table;
+    }
+
+    thread_local bool current_array_compaction = false;
+
+    bool get_array_compaction() noexcept {
+        return current_array_compaction;
+    }
+
+    compact_scope::compact_scope(bool enabled) noexcept
+        : previous(current_array_compaction) {
+        current_array_compaction = enabled;
+    }
+
+    compact_scope::~compact_scope() {
+        current_array_compaction = previous;
+    }
+
+    namespace __impl__ {
+        //precedes headed payloads
+        struct alignas(std::max_align_t) payload_header {
+            std::pmr::memory_resource* resource; //nullptr for global operator new
+            std::size_t size;
+            std::atomic<std::size_t> owners; //0 while the payload is not shared
+            std::atomic<std::uint64_t> hash; //0 if not memoized
+        };
+
+        bool allocates_headed() noexcept {
+            return current_memory_resource != nullptr;
+        }
+
+        void* allocate_payload(std::size_t size) {
+            std::pmr::memory_resource* resource = current_memory_resource;
+            if (!resource)
+                return ::operator new(size);
+            std::size_t total = sizeof(payload_header) + size;
+            return new (resource->allocate(total, alignof(payload_header))) payload_header{resource, total, 0, 0} + 1;
+        }
+
+        void* allocate_headed_payload(std::size_t size) {
+            std::size_t total = sizeof(payload_header) + size;
+            return new (::operator new(total)) payload_header{nullptr, total, 0, 0} + 1;
+        }
+
+        void deallocate_payload(void* payload, bool headed) noexcept {
+            if (!payload)
+                return;
+            if (!headed) {
+                ::operator delete(payload);
+                return;
+            }
+            payload_header* header = (payload_header*)payload - 1;
+            if (header->resource)
+                header->resource->deallocate(header, header->size, alignof(payload_header));
+            else
+                ::operator delete(header);
+        }
+
+        void share_payload(void* payload) noexcept {
+            std::size_t unshared = 0;
+            ((payload_header*)payload - 1)->owners.compare_exchange_strong(unshared, 1, std::memory_order_relaxed);
+        }
+
+        bool payload_counted(const void* payload) noexcept {
+            return ((const payload_header*)payload - 1)->owners.load(std::memory_order_acquire) != 0;
+        }
+
+        bool retain_payload(void* payload) noexcept {
+            payload_header* header = (payload_header*)payload - 1;
+            if (!header->owners.load(std::memory_order_relaxed))
+                return false;
+            header->owners.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool release_payload(void* payload) noexcept {
+            payload_header* header = (payload_header*)payload - 1;
+            if (!header->owners.load(std::memory_order_acquire))
+                return true;
+            return header->owners.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        bool payload_has_owners(const void* payload) noexcept {
+            return ((const payload_header*)payload - 1)->owners.load(std::memory_order_acquire) > 1;
+        }
+
+        bool cached_payload_hash(const void* payload, std::uint64_t& hash) noexcept {
+            if (!payload_has_owners(payload))
+                return false;
+            hash = ((const payload_header*)payload - 1)->hash.load(std::memory_order_relaxed);
+            return hash != 0;
+        }
+
+        void cache_payload_hash(const void* payload, std::uint64_t hash) noexcept {
+            if (payload_has_owners(payload))
+                const_cast<payload_header*>((const payload_header*)payload - 1)->hash.store(hash, std::memory_order_relaxed);
+        }
+
+        void forget_payload_hash(void* payload) noexcept {
+            ((payload_header*)payload - 1)->hash.store(0, std::memory_order_relaxed);
+        }
+    }
+
     value::value() {
         data = nullptr;
         data_len = 0;
         data_type_id = enbt::type_id{type::none, type_len::Tiny};
     }
 
-    value::value(std::string_view str) {
-        data_type_id.type = type::string;
+    void value::init_string(std::string_view str) {
+        static_assert(offsetof(value, data_len) == offsetof(value, data) + sizeof(data), "short strings need data and data_len to be adjacent");
+        data_type_id = enbt::type_id{type::string};
         data_len = 0;
-        data = (std::uint8_t*)new std::string(str);
+        if (str.size() <= short_string_capacity) {
+            data = nullptr;
+            char* chars = short_string();
+            std::memcpy(chars, str.data(), str.size());
+            chars[short_string_capacity] = (char)(short_string_capacity - str.size());
+            data_type_id.is_signed = true;
+        } else
+            data = (std::uint8_t*)__impl__::new_payload<std::string>(str);
     }
 
-    value::value(const std::string& str) {
-        data_type_id.type = type::string;
+    void value::box_short_string() {
+        if (!is_short_string())
+            return;
+        std::string* boxed = __impl__::new_payload<std::string>(as_string_view());
+        data = (std::uint8_t*)boxed;
+        data_headed = __impl__::allocates_headed();
         data_len = 0;
-        data = (std::uint8_t*)new std::string(str);
+        data_type_id.is_signed = false;
+    }
+
+    value::value(std::string_view str) {
+        init_string(str);
+    }
+
+    value::value(const std::string& str) {
+        init_string(str);
     }
 
     value::value(std::string&& str) {
-        data_type_id.type = type::string;
-        data_len = 0;
-        data = (std::uint8_t*)new std::string(std::move(str));
+        if (str.size() <= short_string_capacity)
+            init_string(str);
+        else {
+            data_type_id.type = type::string;
+            data_len = 0;
+            data = (std::uint8_t*)__impl__::new_payload<std::string>(std::move(str));
+        }
     }
 
     value::value(const char* str) {
-        data_type_id.type = type::string;
-        data_len = 0;
-        data = (std::uint8_t*)new std::string(str);
+        init_string(str);
     }
 
     value::value(const char* str, size_t len) {
-        data_type_id.type = type::string;
-        data_len = 0;
-        data = (std::uint8_t*)new std::string(str, len);
+        init_string(std::string_view(str, len));
     }
 
     value::value(std::initializer_list<value> arr)
@@ -115,18 +322,25 @@ namespace enbt {
         data_type_id = tid;
         data_type_id.length = calc_type_len(array.size());
         data_len = 0;
-        data = (std::uint8_t*)new std::vector<value>(array);
+        data = (std::uint8_t*)__impl__::new_payload<std::vector<value>>(array);
     }
 
     value::value(const std::unordered_map<std::string, value>& compound) {
         data_type_id = enbt::type_id{type::compound, calc_type_len(compound.size()), false};
-        data = (std::uint8_t*)new std::unordered_map<std::string, value>(compound);
+        data = (std::uint8_t*)__impl__::new_payload<std::unordered_map<std::string, value>>(compound);
         data_len = 0;
     }
 
     value::value(std::vector<value>&& array) {
+        bool as_array = array.size();
+        enbt::type_id tid_check = as_array ? array[0].type_id() : enbt::type_id{};
+        for (auto& check : array)
+            if (!check.type_equal(tid_check)) {
+                as_array = false;
+                break;
+            }
         data_len = array.size();
-        data_type_id.type = type::array;
+        data_type_id.type = as_array ? type::array : type::darray;
         data_type_id.is_signed = 0;
         data_type_id.endian = endian::native;
         if (data_len <= UINT8_MAX)
@@ -137,7 +351,7 @@ namespace enbt {
             data_type_id.length = type_len::Default;
         else
             data_type_id.length = type_len::Long;
-        data = (std::uint8_t*)new std::vector<value>(std::move(array));
+        data = (std::uint8_t*)__impl__::new_payload<std::vector<value>>(std::move(array));
     }
 
     value::value(std::vector<value>&& array, enbt::type_id tid) {
@@ -155,18 +369,18 @@ namespace enbt {
         data_type_id = tid;
         data_type_id.length = calc_type_len(array.size());
         data_len = 0;
-        data = (std::uint8_t*)new std::vector<value>(std::move(array));
+        data = (std::uint8_t*)__impl__::new_payload<std::vector<value>>(std::move(array));
     }
 
     value::value(std::unordered_map<std::string, value>&& compound) {
         data_type_id = enbt::type_id{type::compound, calc_type_len(compound.size()), false};
-        data = (std::uint8_t*)new std::unordered_map<std::string, value>(std::move(compound));
+        data = (std::uint8_t*)__impl__::new_payload<std::unordered_map<std::string, value>>(std::move(compound));
         data_len = 0;
     }
 
     value::value(const std::uint8_t* arr, std::size_t len) {
         data_type_id = enbt::type_id{type::sarray, type_len::Tiny, false};
-        std::uint8_t* carr = new std::uint8_t[len];
+        std::uint8_t* carr = __impl__::new_payload_array<std::uint8_t>(len);
         for (std::size_t i = 0; i < len; i++)
             carr[i] = arr[i];
         data = (std::uint8_t*)carr;
@@ -175,42 +389,31 @@ namespace enbt {
 
     value::value(const std::uint16_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Short, endian, false};
-        std::uint16_t* str = new std::uint16_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
-
-
+        std::uint16_t* str = __impl__::new_payload_array<std::uint16_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
 
     value::value(const std::uint32_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Default, endian, false};
-        std::uint32_t* str = new std::uint32_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
+        std::uint32_t* str = __impl__::new_payload_array<std::uint32_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
 
     value::value(const std::uint64_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Long, endian, false};
-        std::uint64_t* str = new std::uint64_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
+        std::uint64_t* str = __impl__::new_payload_array<std::uint64_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
 
     value::value(const std::int8_t* arr, std::size_t len) {
         data_type_id = enbt::type_id{type::sarray, type_len::Tiny, true};
-        std::int8_t* str = new std::int8_t[len];
+        std::int8_t* str = __impl__::new_payload_array<std::int8_t>(len);
         for (std::size_t i = 0; i < len; i++)
             str[i] = arr[i];
         data = (std::uint8_t*)str;
@@ -219,35 +422,24 @@ namespace enbt {
 
     value::value(const std::int16_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Short, endian, true};
-        std::int16_t* str = new std::int16_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
-
-
+        std::int16_t* str = __impl__::new_payload_array<std::int16_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
 
     value::value(const std::int32_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Default, endian, true};
-        std::int32_t* str = new std::int32_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
+        std::int32_t* str = __impl__::new_payload_array<std::int32_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
 
     value::value(const std::int64_t* arr, std::size_t len, std::endian endian, bool convert_endian) {
         data_type_id = enbt::type_id{type::sarray, type_len::Long, endian, true};
-        std::int64_t* str = new std::int64_t[len];
-        for (std::size_t i = 0; i < len; i++)
-            str[i] = arr[i];
-        if (convert_endian)
-            endian_helpers::convert_endian_arr(endian, str, len);
+        std::int64_t* str = __impl__::new_payload_array<std::int64_t>(len);
+        endian_helpers::convert_endian_arr(convert_endian ? endian : std::endian::native, arr, str, len);
         data = (std::uint8_t*)str;
         data_len = len;
     }
@@ -474,10 +666,10 @@ namespace enbt {
         }
         case type::array:
         case type::darray:
-            set_data(new std::vector<value>(*std::get<std::vector<value>*>(val)));
+            set_data(__impl__::new_payload<std::vector<value>>(*std::get<std::vector<value>*>(val)));
             break;
         case type::compound:
-            data = (std::uint8_t*)new std::unordered_map<std::string, value>(*std::get<std::unordered_map<std::string, value>*>(val));
+            data = (std::uint8_t*)__impl__::new_payload<std::unordered_map<std::string, value>>(*std::get<std::unordered_map<std::string, value>*>(val));
             break;
         case type::bit:
             set_data(clone_data((std::uint8_t*)std::get<bool>(val), tid, length));
@@ -488,7 +680,11 @@ namespace enbt {
             data_len = 0;
             break;
         case type::string:
-            data = (std::uint8_t*)new std::string(*std::get<std::string*>(val));
+            //content() of a const short string
+            if (std::holds_alternative<std::uint8_t*>(val))
+                init_string((const char*)std::get<std::uint8_t*>(val));
+            else
+                init_string(*std::get<std::string*>(val));
             break;
         case type::log_item:
             data = (std::uint8_t*)std::get<value*>(val);
@@ -520,16 +716,16 @@ namespace enbt {
             if (len) {
                 switch (tid.length) {
                 case type_len::Tiny:
-                    data = new std::uint8_t[len](0);
+                    data = __impl__::new_payload_array<std::uint8_t>(len, true);
                     break;
                 case type_len::Short:
-                    data = (std::uint8_t*)new std::uint16_t[len](0);
+                    data = (std::uint8_t*)__impl__::new_payload_array<std::uint16_t>(len, true);
                     break;
                 case type_len::Default:
-                    data = (std::uint8_t*)new std::uint32_t[len](0);
+                    data = (std::uint8_t*)__impl__::new_payload_array<std::uint32_t>(len, true);
                     break;
                 case type_len::Long:
-                    data = (std::uint8_t*)new std::uint64_t[len](0);
+                    data = (std::uint8_t*)__impl__::new_payload_array<std::uint64_t>(len, true);
                     break;
                 }
             }
@@ -574,7 +770,7 @@ namespace enbt {
     value::value(bool optional, value&& _value) {
         if (optional) {
             data_type_id = enbt::type_id(type::optional, type_len::Tiny, true);
-            data = (std::uint8_t*)new value(std::move(_value));
+            data = (std::uint8_t*)__impl__::new_payload<value>(std::move(_value));
         } else {
             data_type_id = enbt::type_id(type::optional, type_len::Tiny, false);
             data = nullptr;
@@ -585,7 +781,7 @@ namespace enbt {
     value::value(bool optional, const value& _value) {
         if (optional) {
             data_type_id = enbt::type_id(type::optional, type_len::Tiny, true);
-            data = (std::uint8_t*)new value(_value);
+            data = (std::uint8_t*)__impl__::new_payload<value>(_value);
         } else {
             data_type_id = enbt::type_id(type::optional, type_len::Tiny, false);
             data = nullptr;
@@ -682,275 +878,1081 @@ namespace enbt {
         : value(std::move(copy.holder)) {}
 
 #pragma endregion
+#pragma region sarray kernels
+
+    namespace __impl__ {
+        simd_level detect_simd_level() noexcept {
+#ifdef ENBT_SIMD_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int regs[4];
+            __cpuid(regs, 0);
+            int max_leaf = regs[0];
+            __cpuid(regs, 1);
+            bool sse42 = regs[2] & (1 << 20);
+            bool os_saves_ymm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+            if (os_saves_ymm && max_leaf >= 7) {
+                __cpuidex(regs, 7, 0);
+                if (regs[1] & (1 << 5))
+                    return simd_level::avx2;
+            }
+            if (sse42)
+                return simd_level::sse42;
+    #else
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return simd_level::avx2;
+            if (__builtin_cpu_supports("sse4.2"))
+                return simd_level::sse42;
+    #endif
+#elif defined(ENBT_SIMD_NEON)
+            return simd_level::neon;
+#endif
+            return simd_level::scalar;
+        }
+
+        //shuffle control that reverses every size wide item, indexes are relative to a 16 byte lane
+        template <std::size_t size>
+        constexpr std::array<std::uint8_t, 32> byteswap_order() noexcept {
+            std::array<std::uint8_t, 32> res{};
+            for (std::size_t i = 0; i < res.size(); i++)
+                res[i] = std::uint8_t(i % 16 / size * size + size - 1 - i % size);
+            return res;
+        }
 
-    value& value::operator[](std::size_t index) {
-        if (is_array())
-            return ((std::vector<value>*)data)->operator[](index);
-        throw std::invalid_argument("Invalid tid, cannot index array");
-    }
+        //kernels take unsigned items where the sign does not matter,
+        // loops are kept simple so compilers can vectorize them on other targets
+        namespace scalar {
+            template <class T>
+            inline T byteswap(T value) noexcept {
+    #ifdef __cpp_lib_byteswap
+                return std::byteswap(value);
+    #else
+                T res = 0;
+                for (std::size_t i = 0; i < sizeof(T); i++, value >>= 8)
+                    res = T(res << 8) | T(value & 0xFF);
+                return res;
+    #endif
+            }
 
-    value::value_variants value::get_content(std::uint8_t* data, enbt::type_id data_type_id) {
-        std::uint8_t* real_data = get_data(data, data_type_id);
-        switch (data_type_id.type) {
-        case type::integer:
-        case type::var_integer:
-            switch (data_type_id.length) {
-            case type_len::Tiny:
-                if (data_type_id.is_signed)
-                    return (std::int8_t)real_data[0];
-                else
-                    return (std::uint8_t)real_data[0];
-            case type_len::Short:
-                if (data_type_id.is_signed)
-                    return ((std::int16_t*)real_data)[0];
-                else
-                    return ((std::uint16_t*)real_data)[0];
-            case type_len::Default:
-                if (data_type_id.is_signed)
-                    return ((std::int32_t*)real_data)[0];
-                else
-                    return ((std::uint32_t*)real_data)[0];
-            case type_len::Long:
-                if (data_type_id.is_signed)
-                    return ((std::int64_t*)real_data)[0];
+            template <std::size_t size>
+            void byteswap(std::uint8_t* out, const std::uint8_t* in, std::size_t count) noexcept {
+                for (std::size_t i = 0; i < count; i++, in += size, out += size) {
+                    if constexpr (size == 16) {
+                        std::uint64_t low, high;
+                        std::memcpy(&low, in, 8);
+                        std::memcpy(&high, in + 8, 8);
+                        low = byteswap(low);
+                        high = byteswap(high);
+                        std::memcpy(out, &high, 8);
+                        std::memcpy(out + 8, &low, 8);
+                    } else {
+                        using word = std::conditional_t<size == 2, std::uint16_t, std::conditional_t<size == 4, std::uint32_t, std::uint64_t>>;
+                        word item;
+                        std::memcpy(&item, in, size);
+                        item = byteswap(item);
+                        std::memcpy(out, &item, size);
+                    }
+                }
+            }
+
+            template <class T>
+            std::size_t find(const T* data, std::size_t size, T value) noexcept {
+                for (std::size_t i = 0; i < size; i++)
+                    if (data[i] == value)
+                        return i;
+                return size;
+            }
+
+            template <class T>
+            std::size_t count(const T* data, std::size_t size, T value) noexcept {
+                std::size_t res = 0;
+                for (std::size_t i = 0; i < size; i++)
+                    res += data[i] == value;
+                return res;
+            }
+
+            inline std::size_t mismatch(const std::uint8_t* left, const std::uint8_t* right, std::size_t size) noexcept {
+                for (std::size_t i = 0; i < size; i++)
+                    if (left[i] != right[i])
+                        return i;
+                return size;
+            }
+
+            template <class T, bool is_max>
+            T extreme(const T* data, std::size_t size) noexcept {
+                T res = data[0];
+                for (std::size_t i = 1; i < size; i++)
+                    if constexpr (is_max)
+                        res = data[i] > res ? data[i] : res;
+                    else
+                        res = data[i] < res ? data[i] : res;
+                return res;
+            }
+
+            //negative items convert modulo 2^64, so the sum is right for signed items too
+            template <class T>
+            std::uint64_t sum(const T* data, std::size_t size) noexcept {
+                std::uint64_t res = 0;
+                for (std::size_t i = 0; i < size; i++)
+                    res += (std::uint64_t)data[i];
+                return res;
+            }
+        }
+
+#ifdef ENBT_SIMD_X86
+        namespace sse42 {
+            template <class T>
+            ENBT_TARGET_SSE42 inline __m128i broadcast(T value) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_set1_epi8((char)value);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_set1_epi16((short)value);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_set1_epi32((int)value);
                 else
-                    return ((std::uint64_t*)real_data)[0];
-            default:
-                return nullptr;
+                    return _mm_set1_epi64x((long long)value);
             }
-        case type::floating:
-            switch (data_type_id.length) {
-            case type_len::Default:
-                return ((float*)real_data)[0];
-            case type_len::Long:
-                return ((double*)real_data)[0];
-            default:
-                return nullptr;
+
+            template <class T>
+            ENBT_TARGET_SSE42 inline __m128i equal(__m128i left, __m128i right) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_cmpeq_epi8(left, right);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_cmpeq_epi16(left, right);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_cmpeq_epi32(left, right);
+                else
+                    return _mm_cmpeq_epi64(left, right);
             }
-        case type::uuid:
-            return *(raw_uuid*)real_data;
-        case type::sarray:
-            if (data_type_id.is_signed) {
-                switch (data_type_id.length) {
-                case type_len::Tiny:
-                    return (std::int8_t*)data;
-                case type_len::Short:
-                    return (std::int16_t*)data;
-                case type_len::Default:
-                    return (std::int32_t*)data;
-                case type_len::Long:
-                    return (std::int64_t*)data;
-                default:
-                    return data;
+
+            template <class T, bool is_max>
+            ENBT_TARGET_SSE42 inline __m128i pick(__m128i left, __m128i right) noexcept {
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (sizeof(T) == 8) {
+                    //no 64 bit min and max, unsigned items are compared with their sign bit flipped
+                    __m128i bias = _mm_set1_epi64x(is_signed ? 0 : (long long)(1ull << 63));
+                    __m128i greater = _mm_cmpgt_epi64(_mm_xor_si128(left, bias), _mm_xor_si128(right, bias));
+                    return is_max ? _mm_blendv_epi8(right, left, greater) : _mm_blendv_epi8(left, right, greater);
+                } else if constexpr (is_max) {
+                    if constexpr (sizeof(T) == 1)
+                        return is_signed ? _mm_max_epi8(left, right) : _mm_max_epu8(left, right);
+                    else if constexpr (sizeof(T) == 2)
+                        return is_signed ? _mm_max_epi16(left, right) : _mm_max_epu16(left, right);
+                    else
+                        return is_signed ? _mm_max_epi32(left, right) : _mm_max_epu32(left, right);
+                } else {
+                    if constexpr (sizeof(T) == 1)
+                        return is_signed ? _mm_min_epi8(left, right) : _mm_min_epu8(left, right);
+                    else if constexpr (sizeof(T) == 2)
+                        return is_signed ? _mm_min_epi16(left, right) : _mm_min_epu16(left, right);
+                    else
+                        return is_signed ? _mm_min_epi32(left, right) : _mm_min_epu32(left, right);
                 }
-            } else {
-                switch (data_type_id.length) {
-                case type_len::Tiny:
-                    return data;
-                case type_len::Short:
-                    return (std::uint16_t*)data;
-                case type_len::Default:
-                    return (std::uint32_t*)data;
-                case type_len::Long:
-                    return (std::uint64_t*)data;
-                default:
-                    return data;
+            }
+
+            template <class T>
+            ENBT_TARGET_SSE42 std::size_t find(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                __m128i needle = broadcast(value);
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    unsigned mask = _mm_movemask_epi8(equal<T>(_mm_loadu_si128((const __m128i*)(data + i)), needle));
+                    if (mask)
+                        return i + std::countr_zero(mask) / sizeof(T);
                 }
+                return i + scalar::find(data + i, size - i, value);
             }
-        case type::array:
-        case type::darray:
-            return ((std::vector<value>*)data);
-        case type::compound:
-            return ((std::unordered_map<std::string, value>*)data);
-        case type::optional:
-            if (data)
-                return (value*)data;
-            else
-                return nullptr;
-        case type::bit:
-            return (bool)data_type_id.is_signed;
-        case type::string:
-            return (std::string*)data;
-        case type::log_item:
-            return (value*)data;
-        default:
-            return nullptr;
-        }
-    }
 
-    uint8_t* value::clone_data(std::uint8_t* data, enbt::type_id data_type_id, std::size_t data_len) {
-        switch (data_type_id.type) {
-        case type::sarray: {
-            switch (data_type_id.length) {
-            case type_len::Tiny: {
-                std::uint8_t* res = new std::uint8_t[data_len];
-                for (std::size_t i = 0; i < data_len; i++)
-                    res[i] = data[i];
-                return res;
+            template <class T>
+            ENBT_TARGET_SSE42 std::size_t count(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                __m128i needle = broadcast(value);
+                std::size_t res = 0;
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes)
+                    res += std::popcount((unsigned)_mm_movemask_epi8(equal<T>(_mm_loadu_si128((const __m128i*)(data + i)), needle)));
+                return res / sizeof(T) + scalar::count(data + i, size - i, value);
             }
-            case type_len::Short: {
-                std::uint16_t* res = new std::uint16_t[data_len];
-                std::uint16_t* proxy = (std::uint16_t*)data;
-                for (std::size_t i = 0; i < data_len; i++)
-                    res[i] = proxy[i];
-                return (std::uint8_t*)res;
+
+            ENBT_TARGET_SSE42 std::size_t mismatch(const std::uint8_t* left, const std::uint8_t* right, std::size_t size) noexcept {
+                std::size_t i = 0;
+                for (; i + 16 <= size; i += 16) {
+                    __m128i l = _mm_loadu_si128((const __m128i*)(left + i));
+                    __m128i r = _mm_loadu_si128((const __m128i*)(right + i));
+                    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) ^ 0xFFFFu;
+                    if (mask)
+                        return i + std::countr_zero(mask);
+                }
+                return i + scalar::mismatch(left + i, right + i, size - i);
             }
-            case type_len::Default: {
-                std::uint32_t* res = new std::uint32_t[data_len];
-                std::uint32_t* proxy = (std::uint32_t*)data;
-                for (std::size_t i = 0; i < data_len; i++)
-                    res[i] = proxy[i];
-                return (std::uint8_t*)res;
+
+            template <class T, bool is_max>
+            ENBT_TARGET_SSE42 T extreme(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                if (size < lanes)
+                    return scalar::extreme<T, is_max>(data, size);
+                __m128i res = _mm_loadu_si128((const __m128i*)data);
+                for (std::size_t i = lanes; i + lanes <= size; i += lanes)
+                    res = pick<T, is_max>(res, _mm_loadu_si128((const __m128i*)(data + i)));
+                //the last block overlaps items already seen, which does not change min or max
+                res = pick<T, is_max>(res, _mm_loadu_si128((const __m128i*)(data + size - lanes)));
+                alignas(16) T items[lanes];
+                _mm_store_si128((__m128i*)items, res);
+                return scalar::extreme<T, is_max>(items, lanes);
             }
-            case type_len::Long: {
-                std::uint64_t* res = new std::uint64_t[data_len];
-                std::uint64_t* proxy = (std::uint64_t*)data;
-                for (std::size_t i = 0; i < data_len; i++)
-                    res[i] = proxy[i];
-                return (std::uint8_t*)res;
+
+            template <class T>
+            ENBT_TARGET_SSE42 std::uint64_t sum(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                //two 64 bit partial sums, 8 and 16 bit items are biased to unsigned or signed to use sad and madd
+                __m128i acc = _mm_setzero_si128();
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    __m128i items = _mm_loadu_si128((const __m128i*)(data + i));
+                    if constexpr (sizeof(T) == 1) {
+                        if constexpr (std::is_signed_v<T>)
+                            items = _mm_xor_si128(items, _mm_set1_epi8((char)0x80));
+                        acc = _mm_add_epi64(acc, _mm_sad_epu8(items, _mm_setzero_si128()));
+                    } else if constexpr (sizeof(T) == 2) {
+                        if constexpr (!std::is_signed_v<T>)
+                            items = _mm_xor_si128(items, _mm_set1_epi16((short)0x8000));
+                        __m128i pairs = _mm_madd_epi16(items, _mm_set1_epi16(1));
+                        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(pairs));
+                        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(pairs, 8)));
+                    } else if constexpr (sizeof(T) == 4) {
+                        if constexpr (std::is_signed_v<T>) {
+                            acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(items));
+                            acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(items, 8)));
+                        } else {
+                            acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(items));
+                            acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(_mm_srli_si128(items, 8)));
+                        }
+                    } else
+                        acc = _mm_add_epi64(acc, items);
+                }
+                alignas(16) std::uint64_t parts[2];
+                _mm_store_si128((__m128i*)parts, acc);
+                std::uint64_t res = parts[0] + parts[1];
+                if constexpr (sizeof(T) == 1 && std::is_signed_v<T>)
+                    res -= std::uint64_t(i) * 0x80;
+                else if constexpr (sizeof(T) == 2 && !std::is_signed_v<T>)
+                    res += std::uint64_t(i) * 0x8000;
+                return res + scalar::sum(data + i, size - i);
             }
-            default:
-                break;
+
+            template <std::size_t size>
+            ENBT_TARGET_SSE42 void byteswap(std::uint8_t* out, const std::uint8_t* in, std::size_t count) noexcept {
+                static constexpr auto order = byteswap_order<size>();
+                __m128i shuffle = _mm_loadu_si128((const __m128i*)order.data());
+                std::size_t bytes = count * size, i = 0;
+                for (; i + 16 <= bytes; i += 16)
+                    _mm_storeu_si128((__m128i*)(out + i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i)), shuffle));
+                scalar::byteswap<size>(out + i, in + i, (bytes - i) / size);
             }
-        } break;
-        case type::array:
-        case type::darray:
-            return (std::uint8_t*)new std::vector<value>(*(std::vector<value>*)data);
-        case type::compound:
-            if (data_type_id.is_signed)
-                return (std::uint8_t*)new std::unordered_map<std::uint16_t, value>(*(std::unordered_map<std::uint16_t, value>*)data);
-            else
-                return (std::uint8_t*)new std::unordered_map<std::string, value>(*(std::unordered_map<std::string, value>*)data);
-        case type::optional: {
-            if (data) {
-                value& source = *(value*)data;
-                return (std::uint8_t*)new value(source);
-            } else
-                return nullptr;
         }
-        case type::uuid:
-            return (std::uint8_t*)new raw_uuid(*(raw_uuid*)data);
-        case type::string:
-            return (std::uint8_t*)new std::string(*(std::string*)data);
-        case type::log_item:
-            return (std::uint8_t*)new value(*(value*)data);
-        default:
-            if (data_len > 8) {
-                std::uint8_t* data_cloned = new std::uint8_t[data_len];
-                for (std::size_t i = 0; i < data_len; i++)
-                    data_cloned[i] = data[i];
-                return data_cloned;
+
+        namespace avx2 {
+            template <class T>
+            ENBT_TARGET_AVX2 inline __m256i broadcast(T value) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm256_set1_epi8((char)value);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_set1_epi16((short)value);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_set1_epi32((int)value);
+                else
+                    return _mm256_set1_epi64x((long long)value);
             }
-        }
-        return data;
-    }
 
-    value& value::operator[](const char* index) {
-        if (is_compound()) {
-            return ((std::unordered_map<std::string, value>*)data)->operator[](index);
+            template <class T>
+            ENBT_TARGET_AVX2 inline __m256i equal(__m256i left, __m256i right) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm256_cmpeq_epi8(left, right);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_cmpeq_epi16(left, right);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_cmpeq_epi32(left, right);
+                else
+                    return _mm256_cmpeq_epi64(left, right);
+            }
+
+            template <class T, bool is_max>
+            ENBT_TARGET_AVX2 inline __m256i pick(__m256i left, __m256i right) noexcept {
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (sizeof(T) == 8) {
+                    __m256i bias = _mm256_set1_epi64x(is_signed ? 0 : (long long)(1ull << 63));
+                    __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(left, bias), _mm256_xor_si256(right, bias));
+                    return is_max ? _mm256_blendv_epi8(right, left, greater) : _mm256_blendv_epi8(left, right, greater);
+                } else if constexpr (is_max) {
+                    if constexpr (sizeof(T) == 1)
+                        return is_signed ? _mm256_max_epi8(left, right) : _mm256_max_epu8(left, right);
+                    else if constexpr (sizeof(T) == 2)
+                        return is_signed ? _mm256_max_epi16(left, right) : _mm256_max_epu16(left, right);
+                    else
+                        return is_signed ? _mm256_max_epi32(left, right) : _mm256_max_epu32(left, right);
+                } else {
+                    if constexpr (sizeof(T) == 1)
+                        return is_signed ? _mm256_min_epi8(left, right) : _mm256_min_epu8(left, right);
+                    else if constexpr (sizeof(T) == 2)
+                        return is_signed ? _mm256_min_epi16(left, right) : _mm256_min_epu16(left, right);
+                    else
+                        return is_signed ? _mm256_min_epi32(left, right) : _mm256_min_epu32(left, right);
+                }
+            }
+
+            template <class T>
+            ENBT_TARGET_AVX2 std::size_t find(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                __m256i needle = broadcast(value);
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    unsigned mask = (unsigned)_mm256_movemask_epi8(equal<T>(_mm256_loadu_si256((const __m256i*)(data + i)), needle));
+                    if (mask)
+                        return i + std::countr_zero(mask) / sizeof(T);
+                }
+                return i + scalar::find(data + i, size - i, value);
+            }
+
+            template <class T>
+            ENBT_TARGET_AVX2 std::size_t count(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                __m256i needle = broadcast(value);
+                std::size_t res = 0;
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes)
+                    res += std::popcount((unsigned)_mm256_movemask_epi8(equal<T>(_mm256_loadu_si256((const __m256i*)(data + i)), needle)));
+                return res / sizeof(T) + scalar::count(data + i, size - i, value);
+            }
+
+            ENBT_TARGET_AVX2 std::size_t mismatch(const std::uint8_t* left, const std::uint8_t* right, std::size_t size) noexcept {
+                std::size_t i = 0;
+                for (; i + 32 <= size; i += 32) {
+                    __m256i l = _mm256_loadu_si256((const __m256i*)(left + i));
+                    __m256i r = _mm256_loadu_si256((const __m256i*)(right + i));
+                    unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r));
+                    if (mask)
+                        return i + std::countr_zero(mask);
+                }
+                return i + scalar::mismatch(left + i, right + i, size - i);
+            }
+
+            template <class T, bool is_max>
+            ENBT_TARGET_AVX2 T extreme(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                if (size < lanes)
+                    return scalar::extreme<T, is_max>(data, size);
+                __m256i res = _mm256_loadu_si256((const __m256i*)data);
+                for (std::size_t i = lanes; i + lanes <= size; i += lanes)
+                    res = pick<T, is_max>(res, _mm256_loadu_si256((const __m256i*)(data + i)));
+                res = pick<T, is_max>(res, _mm256_loadu_si256((const __m256i*)(data + size - lanes)));
+                alignas(32) T items[lanes];
+                _mm256_store_si256((__m256i*)items, res);
+                return scalar::extreme<T, is_max>(items, lanes);
+            }
+
+            template <class T>
+            ENBT_TARGET_AVX2 std::uint64_t sum(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                __m256i acc = _mm256_setzero_si256();
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    __m256i items = _mm256_loadu_si256((const __m256i*)(data + i));
+                    if constexpr (sizeof(T) == 1) {
+                        if constexpr (std::is_signed_v<T>)
+                            items = _mm256_xor_si256(items, _mm256_set1_epi8((char)0x80));
+                        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(items, _mm256_setzero_si256()));
+                    } else if constexpr (sizeof(T) == 2) {
+                        if constexpr (!std::is_signed_v<T>)
+                            items = _mm256_xor_si256(items, _mm256_set1_epi16((short)0x8000));
+                        __m256i pairs = _mm256_madd_epi16(items, _mm256_set1_epi16(1));
+                        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+                        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+                    } else if constexpr (sizeof(T) == 4) {
+                        if constexpr (std::is_signed_v<T>) {
+                            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(items)));
+                            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(items, 1)));
+                        } else {
+                            acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(items)));
+                            acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(items, 1)));
+                        }
+                    } else
+                        acc = _mm256_add_epi64(acc, items);
+                }
+                alignas(32) std::uint64_t parts[4];
+                _mm256_store_si256((__m256i*)parts, acc);
+                std::uint64_t res = parts[0] + parts[1] + parts[2] + parts[3];
+                if constexpr (sizeof(T) == 1 && std::is_signed_v<T>)
+                    res -= std::uint64_t(i) * 0x80;
+                else if constexpr (sizeof(T) == 2 && !std::is_signed_v<T>)
+                    res += std::uint64_t(i) * 0x8000;
+                return res + scalar::sum(data + i, size - i);
+            }
+
+            //vpshufb shuffles inside 16 byte lanes, which is all the reversal needs
+            template <std::size_t size>
+            ENBT_TARGET_AVX2 void byteswap(std::uint8_t* out, const std::uint8_t* in, std::size_t count) noexcept {
+                static constexpr auto order = byteswap_order<size>();
+                __m256i shuffle = _mm256_loadu_si256((const __m256i*)order.data());
+                std::size_t bytes = count * size, i = 0;
+                for (; i + 32 <= bytes; i += 32)
+                    _mm256_storeu_si256((__m256i*)(out + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(in + i)), shuffle));
+                sse42::byteswap<size>(out + i, in + i, (bytes - i) / size);
+            }
         }
-        throw std::invalid_argument("Invalid tid, cannot index compound");
-    }
+    #define ENBT_SIMD_DISPATCH(...)               \
+        switch (get_simd_level()) {               \
+        case simd_level::avx2:                    \
+            return avx2::__VA_ARGS__;             \
+        case simd_level::sse42:                   \
+            return sse42::__VA_ARGS__;            \
+        default:                                  \
+            return scalar::__VA_ARGS__;           \
+        }
+#elif defined(ENBT_SIMD_NEON)
+        //neon is part of the aarch64 baseline, so these kernels are picked at compile time
+        namespace neon {
+            inline uint8x16_t load(const std::uint8_t* data) noexcept {
+                return vld1q_u8(data);
+            }
 
-    void value::remove(const std::string& name) {
-        ((std::unordered_map<std::string, value>*)data)->erase(name);
-    }
+            inline uint16x8_t load(const std::uint16_t* data) noexcept {
+                return vld1q_u16(data);
+            }
 
-    const value& value::operator[](std::size_t index) const {
-        if (is_array())
-            return ((std::vector<value>*)data)->operator[](index);
-        throw std::invalid_argument("Invalid tid, cannot index array");
-    }
+            inline uint32x4_t load(const std::uint32_t* data) noexcept {
+                return vld1q_u32(data);
+            }
 
-    const value& value::operator[](const char* index) const {
-        if (is_compound()) {
-            return ((std::unordered_map<std::string, value>*)data)->at(index);
+            inline uint64x2_t load(const std::uint64_t* data) noexcept {
+                return vld1q_u64(data);
+            }
+
+            inline int8x16_t load(const std::int8_t* data) noexcept {
+                return vld1q_s8(data);
+            }
+
+            inline int16x8_t load(const std::int16_t* data) noexcept {
+                return vld1q_s16(data);
+            }
+
+            inline int32x4_t load(const std::int32_t* data) noexcept {
+                return vld1q_s32(data);
+            }
+
+            inline int64x2_t load(const std::int64_t* data) noexcept {
+                return vld1q_s64(data);
+            }
+
+            inline void store(std::uint8_t* out, uint8x16_t items) noexcept {
+                vst1q_u8(out, items);
+            }
+
+            inline void store(std::uint16_t* out, uint16x8_t items) noexcept {
+                vst1q_u16(out, items);
+            }
+
+            inline void store(std::uint32_t* out, uint32x4_t items) noexcept {
+                vst1q_u32(out, items);
+            }
+
+            inline void store(std::uint64_t* out, uint64x2_t items) noexcept {
+                vst1q_u64(out, items);
+            }
+
+            inline void store(std::int8_t* out, int8x16_t items) noexcept {
+                vst1q_s8(out, items);
+            }
+
+            inline void store(std::int16_t* out, int16x8_t items) noexcept {
+                vst1q_s16(out, items);
+            }
+
+            inline void store(std::int32_t* out, int32x4_t items) noexcept {
+                vst1q_s32(out, items);
+            }
+
+            inline void store(std::int64_t* out, int64x2_t items) noexcept {
+                vst1q_s64(out, items);
+            }
+
+            //lanes of equal items are all ones, returned as bytes
+            inline uint8x16_t equal(const std::uint8_t* data, std::uint8_t value) noexcept {
+                return vceqq_u8(vld1q_u8(data), vdupq_n_u8(value));
+            }
+
+            inline uint8x16_t equal(const std::uint16_t* data, std::uint16_t value) noexcept {
+                return vreinterpretq_u8_u16(vceqq_u16(vld1q_u16(data), vdupq_n_u16(value)));
+            }
+
+            inline uint8x16_t equal(const std::uint32_t* data, std::uint32_t value) noexcept {
+                return vreinterpretq_u8_u32(vceqq_u32(vld1q_u32(data), vdupq_n_u32(value)));
+            }
+
+            inline uint8x16_t equal(const std::uint64_t* data, std::uint64_t value) noexcept {
+                return vreinterpretq_u8_u64(vceqq_u64(vld1q_u64(data), vdupq_n_u64(value)));
+            }
+
+            //there is no movemask, narrowing by 4 bits leaves a nibble per byte in one 64 bit word
+            inline std::uint64_t byte_mask(uint8x16_t bytes) noexcept {
+                return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(bytes), 4)), 0);
+            }
+
+            template <bool is_max>
+            inline uint8x16_t pick(uint8x16_t left, uint8x16_t right) noexcept {
+                return is_max ? vmaxq_u8(left, right) : vminq_u8(left, right);
+            }
+
+            template <bool is_max>
+            inline uint16x8_t pick(uint16x8_t left, uint16x8_t right) noexcept {
+                return is_max ? vmaxq_u16(left, right) : vminq_u16(left, right);
+            }
+
+            template <bool is_max>
+            inline uint32x4_t pick(uint32x4_t left, uint32x4_t right) noexcept {
+                return is_max ? vmaxq_u32(left, right) : vminq_u32(left, right);
+            }
+
+            //no 64 bit min and max, the greater lanes are selected by a compare
+            template <bool is_max>
+            inline uint64x2_t pick(uint64x2_t left, uint64x2_t right) noexcept {
+                uint64x2_t greater = vcgtq_u64(left, right);
+                return is_max ? vbslq_u64(greater, left, right) : vbslq_u64(greater, right, left);
+            }
+
+            template <bool is_max>
+            inline int8x16_t pick(int8x16_t left, int8x16_t right) noexcept {
+                return is_max ? vmaxq_s8(left, right) : vminq_s8(left, right);
+            }
+
+            template <bool is_max>
+            inline int16x8_t pick(int16x8_t left, int16x8_t right) noexcept {
+                return is_max ? vmaxq_s16(left, right) : vminq_s16(left, right);
+            }
+
+            template <bool is_max>
+            inline int32x4_t pick(int32x4_t left, int32x4_t right) noexcept {
+                return is_max ? vmaxq_s32(left, right) : vminq_s32(left, right);
+            }
+
+            template <bool is_max>
+            inline int64x2_t pick(int64x2_t left, int64x2_t right) noexcept {
+                uint64x2_t greater = vcgtq_s64(left, right);
+                return is_max ? vbslq_s64(greater, left, right) : vbslq_s64(greater, right, left);
+            }
+
+            //pairwise widening adds down to 32 bit lanes, 64 bit items are reinterpreted as they are
+            inline uint32x4_t widen(uint8x16_t items) noexcept {
+                return vpaddlq_u16(vpaddlq_u8(items));
+            }
+
+            inline uint32x4_t widen(uint16x8_t items) noexcept {
+                return vpaddlq_u16(items);
+            }
+
+            inline uint32x4_t widen(uint32x4_t items) noexcept {
+                return items;
+            }
+
+            inline int32x4_t widen(int8x16_t items) noexcept {
+                return vpaddlq_s16(vpaddlq_s8(items));
+            }
+
+            inline int32x4_t widen(int16x8_t items) noexcept {
+                return vpaddlq_s16(items);
+            }
+
+            inline int32x4_t widen(int32x4_t items) noexcept {
+                return items;
+            }
+
+            inline uint64x2_t accumulate(uint64x2_t acc, uint32x4_t items) noexcept {
+                return vpadalq_u32(acc, items);
+            }
+
+            inline uint64x2_t accumulate(uint64x2_t acc, int32x4_t items) noexcept {
+                return vreinterpretq_u64_s64(vpadalq_s32(vreinterpretq_s64_u64(acc), items));
+            }
+
+            inline uint64x2_t accumulate(uint64x2_t acc, uint64x2_t items) noexcept {
+                return vaddq_u64(acc, items);
+            }
+
+            inline uint64x2_t accumulate(uint64x2_t acc, int64x2_t items) noexcept {
+                return vaddq_u64(acc, vreinterpretq_u64_s64(items));
+            }
+
+            template <class T>
+            std::size_t find(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    std::uint64_t mask = byte_mask(equal(data + i, value));
+                    if (mask)
+                        return i + std::countr_zero(mask) / (4 * sizeof(T));
+                }
+                return i + scalar::find(data + i, size - i, value);
+            }
+
+            template <class T>
+            std::size_t count(const T* data, std::size_t size, T value) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                std::size_t res = 0;
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes)
+                    res += vaddvq_u8(vandq_u8(equal(data + i, value), vdupq_n_u8(1)));
+                return res / sizeof(T) + scalar::count(data + i, size - i, value);
+            }
+
+            inline std::size_t mismatch(const std::uint8_t* left, const std::uint8_t* right, std::size_t size) noexcept {
+                std::size_t i = 0;
+                for (; i + 16 <= size; i += 16) {
+                    std::uint64_t mask = ~byte_mask(vceqq_u8(vld1q_u8(left + i), vld1q_u8(right + i)));
+                    if (mask)
+                        return i + std::countr_zero(mask) / 4;
+                }
+                return i + scalar::mismatch(left + i, right + i, size - i);
+            }
+
+            template <class T, bool is_max>
+            T extreme(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                if (size < lanes)
+                    return scalar::extreme<T, is_max>(data, size);
+                auto res = load(data);
+                for (std::size_t i = lanes; i + lanes <= size; i += lanes)
+                    res = pick<is_max>(res, load(data + i));
+                //the last block overlaps items already seen, which does not change min or max
+                res = pick<is_max>(res, load(data + size - lanes));
+                T items[lanes];
+                store(items, res);
+                return scalar::extreme<T, is_max>(items, lanes);
+            }
+
+            template <class T>
+            std::uint64_t sum(const T* data, std::size_t size) noexcept {
+                constexpr std::size_t lanes = 16 / sizeof(T);
+                //two 64 bit partial sums, signed items are widened with their sign so the total wraps like the scalar one
+                uint64x2_t acc = vdupq_n_u64(0);
+                std::size_t i = 0;
+                for (; i + lanes <= size; i += lanes) {
+                    if constexpr (sizeof(T) == 8)
+                        acc = accumulate(acc, load(data + i));
+                    else
+                        acc = accumulate(acc, widen(load(data + i)));
+                }
+                return vaddvq_u64(acc) + scalar::sum(data + i, size - i);
+            }
+
+            template <std::size_t size>
+            void byteswap(std::uint8_t* out, const std::uint8_t* in, std::size_t count) noexcept {
+                std::size_t bytes = count * size, i = 0;
+                for (; i + 16 <= bytes; i += 16) {
+                    uint8x16_t items = vld1q_u8(in + i);
+                    if constexpr (size == 2)
+                        items = vrev16q_u8(items);
+                    else if constexpr (size == 4)
+                        items = vrev32q_u8(items);
+                    else if constexpr (size == 8)
+                        items = vrev64q_u8(items);
+                    else
+                        items = vextq_u8(vrev64q_u8(items), vrev64q_u8(items), 8);
+                    vst1q_u8(out + i, items);
+                }
+                scalar::byteswap<size>(out + i, in + i, (bytes - i) / size);
+            }
         }
-        throw std::invalid_argument("Invalid tid, cannot index compound");
-    }
+    #define ENBT_SIMD_DISPATCH(...) return neon::__VA_ARGS__;
+#else
+    #define ENBT_SIMD_DISPATCH(...) return scalar::__VA_ARGS__;
+#endif
 
-    value& value::at(const std::string& index) {
-        if (is_compound()) {
-            return ((std::unordered_map<std::string, value>*)data)->at(index);
+        template <class T>
+        std::size_t sarray_find(const T* data, std::size_t size, T value) noexcept {
+            using U = std::make_unsigned_t<T>;
+            ENBT_SIMD_DISPATCH(find<U>((const U*)data, size, (U)value))
         }
-        throw std::invalid_argument("Invalid tid, cannot index compound");
-    }
 
-    const value& value::at(const std::string& index) const {
-        if (is_compound()) {
-            return ((std::unordered_map<std::string, value>*)data)->at(index);
+        template <class T>
+        std::size_t sarray_count(const T* data, std::size_t size, T value) noexcept {
+            using U = std::make_unsigned_t<T>;
+            ENBT_SIMD_DISPATCH(count<U>((const U*)data, size, (U)value))
         }
-        throw std::invalid_argument("Invalid tid, cannot index compound");
-    }
 
-    value& value::at(std::size_t index) {
-        if (is_array())
-            return ((std::vector<value>*)data)->at(index);
-        throw std::invalid_argument("Invalid tid, cannot index array");
-    }
+        template <class T>
+        std::size_t sarray_mismatch(const T* left, const T* right, std::size_t size) noexcept {
+            auto bytes = [&]() -> std::size_t {
+                ENBT_SIMD_DISPATCH(mismatch((const std::uint8_t*)left, (const std::uint8_t*)right, size * sizeof(T)))
+            };
+            return bytes() / sizeof(T);
+        }
 
-    const value& value::at(std::size_t index) const {
-        if (is_array())
-            return ((std::vector<value>*)data)->at(index);
-        throw std::invalid_argument("Invalid tid, cannot index array");
-    }
+        template <class T>
+        T sarray_min(const T* data, std::size_t size) noexcept {
+            ENBT_SIMD_DISPATCH(extreme<T, false>(data, size))
+        }
 
-    void merge_compounds(std::unordered_map<std::string, value>& left, const std::unordered_map<std::string, value>& right) {
-        for (auto& [name, val] : right) {
-            auto& it = left[name];
-            if (it.is_compound() && val.is_compound())
-                it.merge(val);
-            else
-                it = val;
+        template <class T>
+        T sarray_max(const T* data, std::size_t size) noexcept {
+            ENBT_SIMD_DISPATCH(extreme<T, true>(data, size))
         }
-    }
 
-    void merge_compounds(std::unordered_map<std::string, value>& left, std::unordered_map<std::string, value>&& right) {
-        for (auto& [name, val] : right) {
-            auto& it = left[name];
-            if (it.is_compound() && val.is_compound())
-                it.merge(std::move(val));
-            else
-                it = std::move(val);
+        template <class T>
+        sarray_sum_t<T> sarray_sum(const T* data, std::size_t size) noexcept {
+            auto total = [&]() -> std::uint64_t {
+                ENBT_SIMD_DISPATCH(sum<T>(data, size))
+            };
+            return (sarray_sum_t<T>)total();
         }
-    }
 
-    value& value::merge(const value& copy) & {
-        merge_compounds(*(std::unordered_map<std::string, value>*)data, *(std::unordered_map<std::string, value>*)copy.data);
-        return *this;
+        //each total depends on the previous one, so this stays a plain loop
+        template <class T>
+        void sarray_prefix_sum(const T* data, std::size_t size, T* out) noexcept {
+            using U = std::make_unsigned_t<T>;
+            U total = 0;
+            for (std::size_t i = 0; i < size; i++) {
+                total += (U)data[i];
+                out[i] = (T)total;
+            }
+        }
+
+        template <std::size_t size>
+        void byteswap_items(void* out, const void* in, std::size_t count) noexcept {
+            ENBT_SIMD_DISPATCH(byteswap<size>((std::uint8_t*)out, (const std::uint8_t*)in, count))
+        }
+
+    #undef ENBT_SIMD_DISPATCH
+
+    #define ENBT_SARRAY_KERNELS(T)                                                                 \
+        template std::size_t sarray_find<T>(const T* data, std::size_t size, T value) noexcept;    \
+        template std::size_t sarray_count<T>(const T* data, std::size_t size, T value) noexcept;   \
+        template std::size_t sarray_mismatch<T>(const T*, const T*, std::size_t size) noexcept;    \
+        template T sarray_min<T>(const T* data, std::size_t size) noexcept;                        \
+        template T sarray_max<T>(const T* data, std::size_t size) noexcept;                        \
+        template sarray_sum_t<T> sarray_sum<T>(const T* data, std::size_t size) noexcept;          \
+        template void sarray_prefix_sum<T>(const T* data, std::size_t size, T* out) noexcept;
+
+        ENBT_SARRAY_KERNELS(std::uint8_t)
+        ENBT_SARRAY_KERNELS(std::uint16_t)
+        ENBT_SARRAY_KERNELS(std::uint32_t)
+        ENBT_SARRAY_KERNELS(std::uint64_t)
+        ENBT_SARRAY_KERNELS(std::int8_t)
+        ENBT_SARRAY_KERNELS(std::int16_t)
+        ENBT_SARRAY_KERNELS(std::int32_t)
+        ENBT_SARRAY_KERNELS(std::int64_t)
+    #undef ENBT_SARRAY_KERNELS
     }
 
-    value& value::merge(value&& move) & {
-        merge_compounds(*(std::unordered_map<std::string, value>*)data, std::move(*(std::unordered_map<std::string, value>*)move.data));
-        return *this;
+    simd_level get_simd_level() noexcept {
+        static const simd_level level = __impl__::detect_simd_level();
+        return level;
     }
 
-    value value::merge(const value& copy) && {
-        merge_compounds(*(std::unordered_map<std::string, value>*)data, *(std::unordered_map<std::string, value>*)copy.data);
-        return std::move(*this);
+    namespace endian_helpers {
+        void byteswap_items(void* out, const void* in, std::size_t item_size, std::size_t count) {
+            switch (item_size) {
+            case 2:
+                return __impl__::byteswap_items<2>(out, in, count);
+            case 4:
+                return __impl__::byteswap_items<4>(out, in, count);
+            case 8:
+                return __impl__::byteswap_items<8>(out, in, count);
+            case 16:
+                return __impl__::byteswap_items<16>(out, in, count);
+            default:
+                if (out != in)
+                    std::memmove(out, in, item_size * count);
+                if (item_size > 1)
+                    for (std::size_t i = 0; i < count; i++) {
+                        std::byte* item = (std::byte*)out + i * item_size;
+                        std::reverse(item, item + item_size);
+                    }
+            }
+        }
     }
 
-    value value::merge(value&& move) && {
-        merge_compounds(*(std::unordered_map<std::string, value>*)data, std::move(*(std::unordered_map<std::string, value>*)move.data));
-        return std::move(*this);
+#pragma endregion
+
+    value& value::operator[](std::size_t index) {
+        unshare();
+        if (is_array())
+            return ((std::vector<value>*)data)->operator[](index);
+        throw std::invalid_argument("Invalid tid, cannot index array");
     }
 
-    value value::get_index(std::size_t index) const {
-        if (is_sarray()) {
-            if (data_len <= index)
-                throw std::out_of_range("SArray len is: " + std::to_string(data_len) + ", but try index at: " + std::to_string(index));
-            if (data_type_id.is_signed) {
-                switch (data_type_id.length) {
-                case type_len::Tiny:
-                    return (std::int8_t)data[index];
-                case type_len::Short:
-                    return ((std::int16_t*)data)[index];
-                case type_len::Default:
-                    return ((std::int32_t*)data)[index];
-                case type_len::Long:
-                    return ((std::int64_t*)data)[index];
-                default:
-                    break;
+    value::value_variants value::get_content(std::uint8_t* data, enbt::type_id data_type_id) {
+        std::uint8_t* real_data = get_data(data, data_type_id);
+        switch (data_type_id.type) {
+        case type::integer:
+        case type::var_integer:
+            switch (data_type_id.length) {
+            case type_len::Tiny:
+                if (data_type_id.is_signed)
+                    return (std::int8_t)real_data[0];
+                else
+                    return (std::uint8_t)real_data[0];
+            case type_len::Short:
+                if (data_type_id.is_signed)
+                    return ((std::int16_t*)real_data)[0];
+                else
+                    return ((std::uint16_t*)real_data)[0];
+            case type_len::Default:
+                if (data_type_id.is_signed)
+                    return ((std::int32_t*)real_data)[0];
+                else
+                    return ((std::uint32_t*)real_data)[0];
+            case type_len::Long:
+                if (data_type_id.is_signed)
+                    return ((std::int64_t*)real_data)[0];
+                else
+                    return ((std::uint64_t*)real_data)[0];
+            default:
+                return nullptr;
+            }
+        case type::floating:
+            switch (data_type_id.length) {
+            case type_len::Default:
+                return ((float*)real_data)[0];
+            case type_len::Long:
+                return ((double*)real_data)[0];
+            default:
+                return nullptr;
+            }
+        case type::uuid:
+            return *(raw_uuid*)real_data;
+        case type::sarray:
+            if (data_type_id.is_signed) {
+                switch (data_type_id.length) {
+                case type_len::Tiny:
+                    return (std::int8_t*)data;
+                case type_len::Short:
+                    return (std::int16_t*)data;
+                case type_len::Default:
+                    return (std::int32_t*)data;
+                case type_len::Long:
+                    return (std::int64_t*)data;
+                default:
+                    return data;
+                }
+            } else {
+                switch (data_type_id.length) {
+                case type_len::Tiny:
+                    return data;
+                case type_len::Short:
+                    return (std::uint16_t*)data;
+                case type_len::Default:
+                    return (std::uint32_t*)data;
+                case type_len::Long:
+                    return (std::uint64_t*)data;
+                default:
+                    return data;
+                }
+            }
+        case type::array:
+        case type::darray:
+            return ((std::vector<value>*)data);
+        case type::compound:
+            return ((std::unordered_map<std::string, value>*)data);
+        case type::optional:
+            if (data)
+                return (value*)data;
+            else
+                return nullptr;
+        case type::bit:
+            return (bool)data_type_id.is_signed;
+        case type::string:
+            return (std::string*)data;
+        case type::log_item:
+            return (value*)data;
+        default:
+            return nullptr;
+        }
+    }
+
+    uint8_t* value::clone_data(std::uint8_t* data, enbt::type_id data_type_id, std::size_t data_len) {
+        switch (data_type_id.type) {
+        case type::sarray: {
+            switch (data_type_id.length) {
+            case type_len::Tiny: {
+                std::uint8_t* res = __impl__::new_payload_array<std::uint8_t>(data_len);
+                for (std::size_t i = 0; i < data_len; i++)
+                    res[i] = data[i];
+                return res;
+            }
+            case type_len::Short: {
+                std::uint16_t* res = __impl__::new_payload_array<std::uint16_t>(data_len);
+                std::uint16_t* proxy = (std::uint16_t*)data;
+                for (std::size_t i = 0; i < data_len; i++)
+                    res[i] = proxy[i];
+                return (std::uint8_t*)res;
+            }
+            case type_len::Default: {
+                std::uint32_t* res = __impl__::new_payload_array<std::uint32_t>(data_len);
+                std::uint32_t* proxy = (std::uint32_t*)data;
+                for (std::size_t i = 0; i < data_len; i++)
+                    res[i] = proxy[i];
+                return (std::uint8_t*)res;
+            }
+            case type_len::Long: {
+                std::uint64_t* res = __impl__::new_payload_array<std::uint64_t>(data_len);
+                std::uint64_t* proxy = (std::uint64_t*)data;
+                for (std::size_t i = 0; i < data_len; i++)
+                    res[i] = proxy[i];
+                return (std::uint8_t*)res;
+            }
+            default:
+                break;
+            }
+        } break;
+        case type::array:
+        case type::darray:
+            return (std::uint8_t*)__impl__::new_payload<std::vector<value>>(*(std::vector<value>*)data);
+        case type::compound:
+            if (data_type_id.is_signed)
+                return (std::uint8_t*)__impl__::new_payload<std::unordered_map<std::uint16_t, value>>(*(std::unordered_map<std::uint16_t, value>*)data);
+            else
+                return (std::uint8_t*)__impl__::new_payload<std::unordered_map<std::string, value>>(*(std::unordered_map<std::string, value>*)data);
+        case type::optional: {
+            if (data) {
+                value& source = *(value*)data;
+                return (std::uint8_t*)__impl__::new_payload<value>(source);
+            } else
+                return nullptr;
+        }
+        case type::uuid:
+            return (std::uint8_t*)__impl__::new_payload<raw_uuid>(*(raw_uuid*)data);
+        case type::string:
+            if (data_type_id.is_signed)
+                return data; //short string, data_len holds the rest of it
+            return (std::uint8_t*)__impl__::new_payload<std::string>(*(std::string*)data);
+        case type::log_item:
+            return (std::uint8_t*)__impl__::new_payload<value>(*(value*)data);
+        default:
+            if (data_len > 8) {
+                std::uint8_t* data_cloned = __impl__::new_payload_array<std::uint8_t>(data_len);
+                for (std::size_t i = 0; i < data_len; i++)
+                    data_cloned[i] = data[i];
+                return data_cloned;
+            }
+        }
+        return data;
+    }
+
+    value& value::operator[](const char* index) {
+        unshare();
+        if (is_compound()) {
+            return ((std::unordered_map<std::string, value>*)data)->operator[](index);
+        }
+        throw std::invalid_argument("Invalid tid, cannot index compound");
+    }
+
+    void value::remove(const std::string& name) {
+        unshare();
+        ((std::unordered_map<std::string, value>*)data)->erase(name);
+    }
+
+    const value& value::operator[](std::size_t index) const {
+        if (is_array())
+            return ((std::vector<value>*)data)->operator[](index);
+        throw std::invalid_argument("Invalid tid, cannot index array");
+    }
+
+    const value& value::operator[](const char* index) const {
+        if (is_compound()) {
+            return ((std::unordered_map<std::string, value>*)data)->at(index);
+        }
+        throw std::invalid_argument("Invalid tid, cannot index compound");
+    }
+
+    value& value::at(const std::string& index) {
+        unshare();
+        if (is_compound()) {
+            return ((std::unordered_map<std::string, value>*)data)->at(index);
+        }
+        throw std::invalid_argument("Invalid tid, cannot index compound");
+    }
+
+    const value& value::at(const std::string& index) const {
+        if (is_compound()) {
+            return ((std::unordered_map<std::string, value>*)data)->at(index);
+        }
+        throw std::invalid_argument("Invalid tid, cannot index compound");
+    }
+
+    value& value::at(std::size_t index) {
+        unshare();
+        if (is_array())
+            return ((std::vector<value>*)data)->at(index);
+        throw std::invalid_argument("Invalid tid, cannot index array");
+    }
+
+    const value& value::at(std::size_t index) const {
+        if (is_array())
+            return ((std::vector<value>*)data)->at(index);
+        throw std::invalid_argument("Invalid tid, cannot index array");
+    }
+
+    void merge_compounds(std::unordered_map<std::string, value>& left, const std::unordered_map<std::string, value>& right) {
+        for (auto& [name, val] : right) {
+            auto& it = left[name];
+            if (it.is_compound() && val.is_compound())
+                it.merge(val);
+            else
+                it = val;
+        }
+    }
+
+    void merge_compounds(std::unordered_map<std::string, value>& left, std::unordered_map<std::string, value>&& right) {
+        for (auto& [name, val] : right) {
+            auto& it = left[name];
+            if (it.is_compound() && val.is_compound())
+                it.merge(std::move(val));
+            else
+                it = std::move(val);
+        }
+    }
+
+    value& value::merge(const value& copy) & {
+        unshare();
+        merge_compounds(*(std::unordered_map<std::string, value>*)data, *(std::unordered_map<std::string, value>*)copy.data);
+        return *this;
+    }
+
+    value& value::merge(value&& move) & {
+        unshare();
+        move.unshare();
+        merge_compounds(*(std::unordered_map<std::string, value>*)data, std::move(*(std::unordered_map<std::string, value>*)move.data));
+        return *this;
+    }
+
+    value value::merge(const value& copy) && {
+        unshare();
+        merge_compounds(*(std::unordered_map<std::string, value>*)data, *(std::unordered_map<std::string, value>*)copy.data);
+        return std::move(*this);
+    }
+
+    value value::merge(value&& move) && {
+        unshare();
+        move.unshare();
+        merge_compounds(*(std::unordered_map<std::string, value>*)data, std::move(*(std::unordered_map<std::string, value>*)move.data));
+        return std::move(*this);
+    }
+
+    value value::get_index(std::size_t index) const {
+        if (is_sarray()) {
+            if (data_len <= index)
+                throw std::out_of_range("SArray len is: " + std::to_string(data_len) + ", but try index at: " + std::to_string(index));
+            if (data_type_id.is_signed) {
+                switch (data_type_id.length) {
+                case type_len::Tiny:
+                    return (std::int8_t)data[index];
+                case type_len::Short:
+                    return ((std::int16_t*)data)[index];
+                case type_len::Default:
+                    return ((std::int32_t*)data)[index];
+                case type_len::Long:
+                    return ((std::int64_t*)data)[index];
+                default:
+                    break;
                 }
             } else {
                 switch (data_type_id.length) {
@@ -979,9 +1981,9 @@ namespace enbt {
             enbt::type_id check_type_id;
             for (value val : *((std::vector<value>*)data)) {
                 if (first) {
-                    check_type_id = val.data_type_id;
+                    check_type_id = val.stored_type_id();
                     first = false;
-                } else if (val.data_type_id != check_type_id) {
+                } else if (val.stored_type_id() != check_type_id) {
                     throw std::invalid_argument("This array has different types");
                 }
             }
@@ -999,15 +2001,380 @@ namespace enbt {
             throw std::invalid_argument("Cannot freeze non-dynamic array");
     }
 
-    void value::unfreeze() {
-        if (data_type_id.type == type::array) {
-            data_type_id.type = type::darray;
-            data_len = 0;
-            data_type_id.length = type_len::Tiny;
+    namespace __impl__ {
+        std::size_t sarray_element_size(enbt::type_len len);
+
+        template <class T>
+        value compact_integers(const std::vector<value>& items, enbt::type_id tid) {
+            T* arr = new_payload_array<T>(items.size());
+            for (std::size_t i = 0; i < items.size(); i++)
+                arr[i] = (T)items[i];
+            return value::build_inline((std::uint8_t*)arr, items.size(), enbt::type_id{type::sarray, tid.length, tid.endian, (bool)tid.is_signed});
+        }
+    }
+
+    value& value::compact(bool nested) {
+        switch (data_type_id.type) {
+        case type::compound:
+            if (nested) {
+                unshare();
+                for (auto& [name, item] : *(std::unordered_map<std::string, value>*)data)
+                    item.compact();
+            }
+            break;
+        case type::array:
+        case type::darray: {
+            auto& items = *(std::vector<value>*)data;
+            if (nested) {
+                unshare();
+                for (auto& item : items)
+                    item.compact();
+            }
+            if (items.empty())
+                break;
+            enbt::type_id tid = items[0].type_id();
+            if (tid.type != type::integer && tid.type != type::floating)
+                break;
+            if (data_type_id.type == type::darray)
+                for (auto& item : items)
+                    if (item.type_id() != tid)
+                        return *this;
+            if (tid.type == type::floating) {
+                if (data_type_id.type == type::darray)
+                    freeze();
+                break;
+            }
+            value compacted;
+            switch (tid.length) {
+            case type_len::Tiny:
+                compacted = tid.is_signed ? __impl__::compact_integers<std::int8_t>(items, tid) : __impl__::compact_integers<std::uint8_t>(items, tid);
+                break;
+            case type_len::Short:
+                compacted = tid.is_signed ? __impl__::compact_integers<std::int16_t>(items, tid) : __impl__::compact_integers<std::uint16_t>(items, tid);
+                break;
+            case type_len::Default:
+                compacted = tid.is_signed ? __impl__::compact_integers<std::int32_t>(items, tid) : __impl__::compact_integers<std::uint32_t>(items, tid);
+                break;
+            case type_len::Long:
+                compacted = tid.is_signed ? __impl__::compact_integers<std::int64_t>(items, tid) : __impl__::compact_integers<std::uint64_t>(items, tid);
+                break;
+            }
+            //the array payload leaves with compacted
+            std::swap(*this, compacted);
+            break;
+        }
+        default:
+            break;
+        }
+        return *this;
+    }
+
+    value& value::share() {
+        if (!data || !is_shareable(data_type_id) || (data_headed && __impl__::payload_counted(data)))
+            return *this;
+        //copies retain only headed payloads, so the subtree is moved before the payload is counted
+        switch (data_type_id.type) {
+        case type::array:
+        case type::darray:
+            for (value& item : *(std::vector<value>*)data)
+                item.share();
+            break;
+        case type::compound:
+            for (auto& [name, item] : *(std::unordered_map<std::string, value>*)data)
+                item.share();
+            break;
+        default:
+            break;
+        }
+        if (!data_headed) {
+            std::uint8_t* headed;
+            switch (data_type_id.type) {
+            case type::array:
+            case type::darray:
+                headed = (std::uint8_t*)__impl__::new_headed_payload(std::move(*(std::vector<value>*)data));
+                break;
+            case type::compound:
+                headed = (std::uint8_t*)__impl__::new_headed_payload(std::move(*(std::unordered_map<std::string, value>*)data));
+                break;
+            case type::string:
+                headed = (std::uint8_t*)__impl__::new_headed_payload(std::move(*(std::string*)data));
+                break;
+            default: {
+                std::size_t bytes = data_len * __impl__::sarray_element_size(data_type_id.length);
+                headed = (std::uint8_t*)__impl__::allocate_headed_payload(bytes);
+                std::memcpy(headed, data, bytes);
+            }
+            }
+            free_data(data, data_type_id, false);
+            data = headed;
+            data_headed = true;
+        }
+        __impl__::share_payload(data);
+        return *this;
+    }
+
+    bool value::is_shared() const {
+        return data && data_headed && is_shareable(data_type_id) && __impl__::payload_has_owners(data);
+    }
+
+    void value::unshare() {
+        if (!is_shared()) {
+            if (data && data_headed && is_shareable(data_type_id))
+                __impl__::forget_payload_hash(data);
+            return;
+        }
+        std::uint8_t* own;
+        switch (data_type_id.type) {
+        case type::array:
+        case type::darray: {
+            const auto& items = *(const std::vector<value>*)data;
+            auto res = __impl__::new_payload<std::vector<value>>();
+            res->reserve(items.size());
+            for (const value& item : items)
+                res->push_back(share_item(item));
+            own = (std::uint8_t*)res;
+            break;
+        }
+        case type::compound: {
+            const auto& items = *(const std::unordered_map<std::string, value>*)data;
+            auto res = __impl__::new_payload<std::unordered_map<std::string, value>>();
+            res->reserve(items.size());
+            for (const auto& [name, item] : items)
+                res->emplace(name, share_item(item));
+            own = (std::uint8_t*)res;
+            break;
+        }
+        default:
+            own = clone_data(data, data_type_id, data_len);
+        }
+        free_data(data, data_type_id, data_headed);
+        data = own;
+        data_headed = __impl__::allocates_headed();
+    }
+
+    void value::unfreeze() {
+        if (data_type_id.type == type::array) {
+            data_type_id.type = type::darray;
+            data_len = 0;
+            data_type_id.length = type_len::Tiny;
         } else
             throw std::invalid_argument("Cannot unfreeze non-array");
     }
 
+    namespace __impl__ {
+        std::uint8_t raw_type_id(enbt::type_id tid) {
+            union combined_t {
+                enbt::type_id id;
+                std::uint8_t raw;
+            } combined{.id = tid};
+
+            return combined.raw;
+        }
+
+        //murmur3 finalizer
+        std::uint64_t hash_finalize(std::uint64_t hash) noexcept {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t hash) noexcept {
+            return hash_finalize(seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+        }
+
+        //consumes 8 bytes per step, the tail is zero padded and tagged with its length
+        std::uint64_t hash_bytes(std::uint64_t seed, const void* bytes, std::size_t size) noexcept {
+            const std::uint8_t* it = (const std::uint8_t*)bytes;
+            std::uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+            for (; size >= 8; it += 8, size -= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, it, 8);
+                hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+                hash ^= hash >> 29;
+            }
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, it, size);
+            return hash_finalize(hash ^ tail ^ ((std::uint64_t)size << 56));
+        }
+
+        template <class T>
+        std::strong_ordering compare_sarray(const std::uint8_t* left, const std::uint8_t* right, std::size_t len) {
+            return sarray_compare((const T*)left, (const T*)right, len);
+        }
+
+        std::size_t sarray_element_size(enbt::type_len len) {
+            switch (len) {
+            case type_len::Tiny:
+                return 1;
+            case type_len::Short:
+                return 2;
+            case type_len::Default:
+                return 4;
+            default:
+                return 8;
+            }
+        }
+
+        std::strong_ordering compare_arrays(const std::vector<value>& left, const std::vector<value>& right) {
+            return std::lexicographical_compare_three_way(left.begin(), left.end(), right.begin(), right.end());
+        }
+
+        std::strong_ordering compare_compounds(const std::unordered_map<std::string, value>& left, const std::unordered_map<std::string, value>& right) {
+            if (auto order = left.size() <=> right.size(); order != 0)
+                return order;
+            auto sorted = [](const std::unordered_map<std::string, value>& items) {
+                std::vector<const std::pair<const std::string, value>*> res;
+                res.reserve(items.size());
+                for (auto& item : items)
+                    res.push_back(&item);
+                std::sort(res.begin(), res.end(), [](auto l, auto r) { return l->first < r->first; });
+                return res;
+            };
+            auto sorted_left = sorted(left);
+            auto sorted_right = sorted(right);
+            for (std::size_t i = 0; i < sorted_left.size(); i++) {
+                if (auto order = sorted_left[i]->first <=> sorted_right[i]->first; order != 0)
+                    return order;
+                if (auto order = sorted_left[i]->second <=> sorted_right[i]->second; order != 0)
+                    return order;
+            }
+            return std::strong_ordering::equal;
+        }
+    }
+
+    std::strong_ordering value::compare(const value& enbt) const {
+        if (auto order = data_type_id.type <=> enbt.data_type_id.type; order != 0)
+            return order;
+        std::strong_ordering order = std::strong_ordering::equal;
+        switch (data_type_id.type) {
+        case type::string:
+            return as_string_view() <=> enbt.as_string_view();
+        case type::integer:
+        case type::var_integer:
+        case type::comp_integer:
+            order = std::visit(
+                [](auto left, auto right) {
+                    using L = decltype(left);
+                    using R = decltype(right);
+                    if constexpr (std::is_integral_v<L> && std::is_integral_v<R> && !std::is_same_v<L, bool> && !std::is_same_v<R, bool>) {
+                        if (std::cmp_equal(left, right))
+                            return std::strong_ordering::equal;
+                        return std::cmp_less(left, right) ? std::strong_ordering::less : std::strong_ordering::greater;
+                    } else
+                        return std::strong_ordering::equal;
+                },
+                content(),
+                enbt.content()
+            );
+            break;
+        case type::floating: {
+            //-0.0 and 0.0 are equal, NaNs with the same bits are equal
+            double left = (double)*this;
+            double right = (double)enbt;
+            order = std::strong_order(left == 0 ? 0.0 : left, right == 0 ? 0.0 : right);
+            break;
+        }
+        case type::uuid:
+            order = *(const raw_uuid*)data <=> *(const raw_uuid*)enbt.data;
+            break;
+        case type::optional:
+            if (data_type_id.is_signed && enbt.data_type_id.is_signed)
+                order = *(const value*)data <=> *(const value*)enbt.data;
+            break;
+        case type::log_item:
+            order = *(const value*)data <=> *(const value*)enbt.data;
+            break;
+        case type::sarray: {
+            //items are in host order, the endian flag only takes part through the type id
+            if (auto tid_order = __impl__::raw_type_id(data_type_id) <=> __impl__::raw_type_id(enbt.data_type_id); tid_order != 0)
+                return tid_order;
+            if (auto len_order = data_len <=> enbt.data_len; len_order != 0)
+                return len_order;
+            switch (data_type_id.length) {
+            case type_len::Tiny:
+                return data_type_id.is_signed ? __impl__::compare_sarray<std::int8_t>(data, enbt.data, data_len) : __impl__::compare_sarray<std::uint8_t>(data, enbt.data, data_len);
+            case type_len::Short:
+                return data_type_id.is_signed ? __impl__::compare_sarray<std::int16_t>(data, enbt.data, data_len) : __impl__::compare_sarray<std::uint16_t>(data, enbt.data, data_len);
+            case type_len::Default:
+                return data_type_id.is_signed ? __impl__::compare_sarray<std::int32_t>(data, enbt.data, data_len) : __impl__::compare_sarray<std::uint32_t>(data, enbt.data, data_len);
+            default:
+                return data_type_id.is_signed ? __impl__::compare_sarray<std::int64_t>(data, enbt.data, data_len) : __impl__::compare_sarray<std::uint64_t>(data, enbt.data, data_len);
+            }
+        }
+        case type::array:
+        case type::darray:
+            order = __impl__::compare_arrays(*(const std::vector<value>*)data, *(const std::vector<value>*)enbt.data);
+            break;
+        case type::compound:
+            order = __impl__::compare_compounds(*(const std::unordered_map<std::string, value>*)data, *(const std::unordered_map<std::string, value>*)enbt.data);
+            break;
+        default:
+            break;
+        }
+        if (order != 0)
+            return order;
+        if (auto tid_order = __impl__::raw_type_id(data_type_id) <=> __impl__::raw_type_id(enbt.data_type_id); tid_order != 0)
+            return tid_order;
+        //arrays keep their size in the payload, data_len of an array depends on how it was built
+        if (is_array())
+            return std::strong_ordering::equal;
+        return data_len <=> enbt.data_len;
+    }
+
+    std::uint64_t value::hash() const {
+        if (data_type_id.type == type::string) {
+            std::string_view str = as_string_view();
+            return __impl__::hash_bytes((std::uint64_t)type::string, str.data(), str.size());
+        }
+        std::uint64_t seed = __impl__::hash_combine(__impl__::raw_type_id(data_type_id), is_array() ? 0 : data_len);
+        switch (data_type_id.type) {
+        case type::integer:
+        case type::var_integer:
+        case type::comp_integer:
+            return __impl__::hash_combine(seed, (std::uint64_t)*this);
+        case type::floating: {
+            double val = (double)*this;
+            if (val == 0)
+                val = 0.0;
+            return __impl__::hash_combine(seed, std::bit_cast<std::uint64_t>(val));
+        }
+        case type::uuid:
+            return __impl__::hash_bytes(seed, data, sizeof(raw_uuid));
+        case type::optional:
+            return data_type_id.is_signed ? __impl__::hash_combine(seed, ((const value*)data)->hash()) : seed;
+        case type::log_item:
+            return __impl__::hash_combine(seed, ((const value*)data)->hash());
+        case type::sarray:
+            return __impl__::hash_bytes(seed, data, data_len * __impl__::sarray_element_size(data_type_id.length));
+        case type::array:
+        case type::darray:
+        case type::compound: {
+            std::uint64_t res;
+            if (data_headed && __impl__::cached_payload_hash(data, res))
+                return res;
+            res = seed;
+            if (data_type_id.type == type::compound) {
+                //entries are summed so the hash does not depend on bucket order
+                std::uint64_t entries = 0;
+                for (auto& [name, item] : *(const std::unordered_map<std::string, value>*)data)
+                    entries += __impl__::hash_combine(__impl__::hash_bytes(0, name.data(), name.size()), item.hash());
+                res = __impl__::hash_combine(res, entries);
+            } else {
+                for (auto& item : *(const std::vector<value>*)data)
+                    res = __impl__::hash_combine(res, item.hash());
+            }
+            if (data_headed)
+                __impl__::cache_payload_hash(data, res);
+            return res;
+        }
+        default:
+            return __impl__::hash_finalize(seed);
+        }
+    }
+
     template <class Target>
     Target simpleIntConvert(const value::value_variants& val) {
         return std::visit(
@@ -1056,1503 +2423,3744 @@ namespace enbt {
         );
     }
 
-    value& value::operator=(uint8_t set_value) {
-        return operator=(value(set_value));
-    }
+    value& value::operator=(uint8_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(int8_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(uint16_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(int16_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(uint32_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(int32_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(uint64_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(int64_t set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(float set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(double set_value) {
+        return operator=(value(set_value));
+    }
+
+    value& value::operator=(bool set_value) {
+        if (data_type_id.type == enbt::type::bit)
+            data_type_id.is_signed = set_value;
+        else
+            operator=(value(set_value));
+        return *this;
+    }
+
+    value& value::operator=(raw_uuid set_value) {
+        return operator=(value(set_value));
+    }
+
+    value::operator bool() const {
+        return simpleIntConvert<bool>(content());
+    }
+
+    value::operator std::int8_t() const {
+        return simpleIntConvert<std::int8_t>(content());
+    }
+
+    value::operator std::int16_t() const {
+        return simpleIntConvert<std::int16_t>(content());
+    }
+
+    value::operator std::int32_t() const {
+        return simpleIntConvert<std::int32_t>(content());
+    }
+
+    value::operator std::int64_t() const {
+        return simpleIntConvert<std::int64_t>(content());
+    }
+
+    value::operator std::uint8_t() const {
+        return simpleIntConvert<std::uint8_t>(content());
+    }
+
+    value::operator std::uint16_t() const {
+        return simpleIntConvert<std::uint16_t>(content());
+    }
+
+    value::operator std::uint32_t() const {
+        return simpleIntConvert<std::uint32_t>(content());
+    }
+
+    value::operator std::uint64_t() const {
+        return simpleIntConvert<std::uint64_t>(content());
+    }
+
+    value::operator float() const {
+        return simpleIntConvert<float>(content());
+    }
+
+    value::operator double() const {
+        return simpleIntConvert<double>(content());
+    }
+
+    value::operator std::string&() {
+        unshare();
+        return *std::get<std::string*>(content());
+    }
+
+    value::operator std::string() const {
+        if (is_string())
+            return std::string(as_string_view());
+        return std::visit(
+            [](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, std::string*>)
+                    return *arg;
+                else if constexpr (std::is_same_v<T, bool>)
+                    return std::string(arg ? "true" : "false");
+                else if constexpr (std::is_integral_v<T>)
+                    return std::to_string(arg);
+                else if constexpr (std::is_same_v<T, std::uint8_t*>)
+                    return std::string((char*)arg);
+                else
+                    return std::string();
+            },
+            content()
+        );
+    }
+
+    enbt::value value::cast_to(enbt::type_id id) const {
+        static auto convert_ = [](enbt::type_id id, const enbt::value& self) -> enbt::value {
+            switch (id.type) {
+            case type::none:
+                return enbt::value();
+            case type::integer:
+                switch (id.length) {
+                case type_len::Tiny:
+                    return id.is_signed ? value((int8_t)self) : value((uint8_t)self);
+                case type_len::Short:
+                    return id.is_signed ? value((int16_t)self) : value((uint16_t)self);
+                case type_len::Default:
+                    return id.is_signed ? value((int32_t)self) : value((uint32_t)self);
+                case type_len::Long:
+                    return id.is_signed ? value((int64_t)self) : value((uint64_t)self);
+                default:
+                    break;
+                }
+                break;
+            case type::var_integer:
+            case type::comp_integer:
+                switch (id.length) {
+                case type_len::Default: {
+                    enbt::value res(id.is_signed ? value((int32_t)self) : value((uint32_t)self));
+                    res.data_type_id.type = id.type;
+                    return res;
+                }
+                case type_len::Long: {
+                    enbt::value res(id.is_signed ? value((int64_t)self) : value((uint64_t)self));
+                    res.data_type_id.type = id.type;
+                    return res;
+                }
+                default:
+                    break;
+                }
+                break;
+            case type::floating:
+                switch (id.length) {
+                case type_len::Default:
+                    return (float)self;
+                case type_len::Long:
+                    return (double)self;
+                default:
+                    break;
+                }
+                break;
+            case type::string:
+                return (std::string)self;
+            default:
+                break;
+            }
+            throw enbt::exception("Can not convert to this type");
+        };
+        auto res = convert_(id, *this);
+        res.data_type_id.endian = id.endian;
+        return res;
+    }
+
+    value::operator const std::uint8_t*() const {
+        return std::get<std::uint8_t*>(content());
+    }
+
+    value::operator const std::int8_t*() const {
+        return std::get<std::int8_t*>(content());
+    }
+
+    value::operator const char*() const {
+        //both string forms are zero terminated
+        if (is_string())
+            return as_string_view().data();
+        return (char*)std::get<std::uint8_t*>(content());
+    }
+
+    value::operator const std::int16_t*() const {
+        return std::get<std::int16_t*>(content());
+    }
+
+    value::operator const std::uint16_t*() const {
+        return std::get<std::uint16_t*>(content());
+    }
+
+    value::operator const std::int32_t*() const {
+        return std::get<std::int32_t*>(content());
+    }
+
+    value::operator const std::uint32_t*() const {
+        return std::get<std::uint32_t*>(content());
+    }
+
+    value::operator const std::int64_t*() const {
+        return std::get<std::int64_t*>(content());
+    }
+
+    value::operator const std::uint64_t*() const {
+        return std::get<std::uint64_t*>(content());
+    }
+
+    value::operator std::unordered_map<std::string, value>() const {
+        if (is_compound())
+            return *(std::unordered_map<std::string, value>*)data;
+        throw std::invalid_argument("Invalid tid, cannot convert compound");
+    }
+
+    value::operator raw_uuid() const {
+        if (is_string()) {
+            raw_uuid res;
+            raw_uuid::from_uuid_string(res, as_string_view());
+            return res;
+        } else
+            return std::get<raw_uuid>(content());
+    }
+
+    value::operator std::optional<value>() const {
+        if (data_type_id.type == type::optional)
+            if (data_type_id.is_signed)
+                return std::optional<value>(*(const value*)data);
+            else
+                return std::nullopt;
+        else
+            return std::optional<value>(*this);
+    }
+
+    raw_uuid value::as_uuid() const {
+        return (raw_uuid) * this;
+    }
+
+    std::string value::as_string() const {
+        return std::string(as_string_view());
+    }
+
+    std::string& value::as_string() {
+        return (std::string&)*this;
+    }
+
+    compound_ref value::as_compound() {
+        return compound::make_ref(*this);
+    }
+
+    compound_const_ref value::as_compound() const {
+        return compound::make_ref(*this);
+    }
+
+    dynamic_array_ref value::as_array() {
+        return dynamic_array::make_ref(*this);
+    }
+
+    dynamic_array_const_ref value::as_array() const {
+        return dynamic_array::make_ref(*this);
+    }
+
+    dynamic_array_ref value::as_dyn_array() {
+        return dynamic_array::make_ref(*this);
+    }
+
+    dynamic_array_const_ref value::as_dyn_array() const {
+        return dynamic_array::make_ref(*this);
+    }
+
+    fixed_array_ref value::as_fixed_array() {
+        return fixed_array::make_ref(*this);
+    }
+
+    fixed_array_const_ref value::as_fixed_array() const {
+        return fixed_array::make_ref(*this);
+    }
+
+    simple_array_ref_ui8 value::as_ui8_array() {
+        return simple_array_ui8::make_ref(*this);
+    }
+
+    simple_array_const_ref_ui8 value::as_ui8_array() const {
+        return simple_array_ui8::make_ref(*this);
+    }
+
+    simple_array_ref_ui16 value::as_ui16_array() {
+        return simple_array_ui16::make_ref(*this);
+    }
+
+    simple_array_const_ref_ui16 value::as_ui16_array() const {
+        return simple_array_ui16::make_ref(*this);
+    }
+
+    simple_array_ref_ui32 value::as_ui32_array() {
+        return simple_array_ui32::make_ref(*this);
+    }
+
+    simple_array_const_ref_ui32 value::as_ui32_array() const {
+        return simple_array_ui32::make_ref(*this);
+    }
+
+    simple_array_ref_ui64 value::as_ui64_array() {
+        return simple_array_ui64::make_ref(*this);
+    }
+
+    simple_array_const_ref_ui64 value::as_ui64_array() const {
+        return simple_array_ui64::make_ref(*this);
+    }
+
+    simple_array_ref_i8 value::as_i8_array() {
+        return simple_array_i8::make_ref(*this);
+    }
+
+    simple_array_const_ref_i8 value::as_i8_array() const {
+        return simple_array_i8::make_ref(*this);
+    }
+
+    simple_array_ref_i16 value::as_i16_array() {
+        return simple_array_i16::make_ref(*this);
+    }
+
+    simple_array_const_ref_i16 value::as_i16_array() const {
+        return simple_array_i16::make_ref(*this);
+    }
+
+    simple_array_ref_i32 value::as_i32_array() {
+        return simple_array_i32::make_ref(*this);
+    }
+
+    simple_array_const_ref_i32 value::as_i32_array() const {
+        return simple_array_i32::make_ref(*this);
+    }
+
+    simple_array_ref_i64 value::as_i64_array() {
+        return simple_array_i64::make_ref(*this);
+    }
+
+    simple_array_const_ref_i64 value::as_i64_array() const {
+        return simple_array_i64::make_ref(*this);
+    }
+
+    value::copy_interator::reference value::copy_interator::operator*() const {
+        switch (position.type()) {
+        case type::sarray: {
+            void* pointer = position.get<void*>();
+            if (iterate_type.is_signed) {
+                switch (iterate_type.length) {
+                case type_len::Tiny:
+                    return {unnamed(), value(*(std::int8_t*)pointer)};
+                    break;
+                case type_len::Short:
+                    return {unnamed(), value(*(std::int16_t*)pointer)};
+                    break;
+                case type_len::Default:
+                    return {unnamed(), value(*(std::int32_t*)pointer)};
+                    break;
+                case type_len::Long:
+                    return {unnamed(), value(*(std::int64_t*)pointer)};
+                    break;
+                default:
+                    throw enbt::exception();
+                }
+            } else {
+                switch (iterate_type.length) {
+                case type_len::Tiny:
+                    return {unnamed(), value(*(std::uint8_t*)pointer)};
+                    break;
+                case type_len::Short:
+                    return {unnamed(), value(*(std::uint16_t*)pointer)};
+                    break;
+                case type_len::Default:
+                    return {unnamed(), value(*(std::uint32_t*)pointer)};
+                    break;
+                case type_len::Long:
+                    return {unnamed(), value(*(std::uint64_t*)pointer)};
+                    break;
+                default:
+                    throw enbt::exception();
+                }
+            }
+        }
+        case type::darray:
+            return {unnamed(), value(*position.get<std::vector<value>::iterator>())};
+        case type::compound: {
+            auto& tmp = *position.get<std::unordered_map<std::string, value>::iterator>();
+            return {tmp.first, value(tmp.second)};
+        }
+        default:
+            throw exception("Unreachable exception in non debug environment");
+        }
+    }
+
+    compound_ref compound_ref::merge(const value& copy) & {
+        merge_compounds(*proxy, *copy.as_compound().proxy);
+        return *this;
+    }
+
+    compound_ref compound_ref::merge(value&& move) & {
+        merge_compounds(*proxy, std::move(*move.as_compound().proxy));
+        return *this;
+    }
+
+    compound_ref compound_ref::merge(const std::unordered_map<std::string, value>& copy) & {
+        merge_compounds(*proxy, copy);
+        return *this;
+    }
+
+    compound_ref compound_ref::merge(std::unordered_map<std::string, value>&& move) & {
+        merge_compounds(*proxy, std::move(move));
+        return *this;
+    }
+
+    compound compound::merge(const value& copy) && {
+        merge_compounds(*proxy, *copy.as_compound().proxy);
+        return std::move(*this);
+    }
+
+    compound compound::merge(value&& copy) && {
+        merge_compounds(*proxy, std::move(*copy.as_compound().proxy));
+        return std::move(*this);
+    }
+
+    compound compound::merge(const compound& copy) && {
+        merge_compounds(*proxy, *copy.proxy);
+        return std::move(*this);
+    }
+
+    compound compound::merge(compound&& copy) && {
+        merge_compounds(*proxy, std::move(*copy.proxy));
+        return std::move(*this);
+    }
+
+    compound compound::merge(const std::unordered_map<std::string, value>& copy) && {
+        merge_compounds(*proxy, copy);
+        return std::move(*this);
+    }
+
+    compound compound::merge(std::unordered_map<std::string, value>&& copy) && {
+        merge_compounds(*proxy, std::move(copy));
+        return std::move(*this);
+    }
+
+    namespace __impl__ {
+        static constexpr std::uint8_t flat_empty = 0x80;
+        static constexpr std::uint8_t flat_deleted = 0xFE;
+
+        static std::size_t flat_hash(std::string_view key) {
+            return std::hash<std::string_view>{}(key);
+        }
+
+        static std::uint8_t flat_control(std::size_t hash) {
+            return std::uint8_t(hash & 0x7F);
+        }
+
+        static std::size_t flat_position(std::size_t hash) {
+            return hash >> 7;
+        }
+
+        static bool flat_less(const std::pair<std::string, value>& item, std::string_view key) {
+            return item.first < key;
+        }
+    }
+
+    flat_compound::flat_compound(std::initializer_list<value_type> list) {
+        reserve(list.size());
+        for (auto& item : list)
+            insert(item);
+    }
+
+    flat_compound::flat_compound(const std::unordered_map<std::string, value>& compound) {
+        reserve(compound.size());
+        for (auto& [name, val] : compound)
+            try_emplace(name, val);
+    }
+
+    flat_compound::flat_compound(std::unordered_map<std::string, value>&& compound) {
+        reserve(compound.size());
+        for (auto& [name, val] : compound)
+            try_emplace(name, std::move(val));
+    }
+
+    flat_compound::flat_compound(const value& compound) {
+        if (!compound.is_compound())
+            throw enbt::exception("value is not a compound");
+        auto& map = *std::get<std::unordered_map<std::string, value>*>(compound.content());
+        reserve(map.size());
+        for (auto& [name, val] : map)
+            try_emplace(name, val);
+    }
+
+    flat_compound::flat_compound(value&& compound) {
+        if (!compound.is_compound())
+            throw enbt::exception("value is not a compound");
+        auto& map = *std::get<std::unordered_map<std::string, value>*>(compound.content());
+        reserve(map.size());
+        for (auto& [name, val] : map)
+            try_emplace(name, std::move(val));
+    }
+
+    //hash is only used once the index is built, small mode skips hashing
+    flat_compound::size_type flat_compound::find_index(std::string_view key) const {
+        return find_index(key, control.empty() ? 0 : __impl__::flat_hash(key));
+    }
+
+    flat_compound::size_type flat_compound::find_index(std::string_view key, std::size_t hash) const {
+        if (control.empty()) {
+            //a scan that rejects on length first beats the binary search over so few keys
+            for (size_type i = 0; i < entries.size(); i++)
+                if (entries[i].first.size() == key.size() && std::memcmp(entries[i].first.data(), key.data(), key.size()) == 0)
+                    return i;
+            return entries.size();
+        }
+        std::uint8_t ctrl = __impl__::flat_control(hash);
+        size_type mask = control.size() - 1;
+        for (size_type pos = __impl__::flat_position(hash) & mask;; pos = (pos + 1) & mask) {
+            std::uint8_t current = control[pos];
+            if (current == __impl__::flat_empty)
+                return entries.size();
+            if (current == ctrl) {
+                size_type entry = slots[pos];
+                if (hashes[entry] == hash && entries[entry].first == key)
+                    return entry;
+            }
+        }
+    }
+
+    flat_compound::size_type flat_compound::find_slot(std::size_t hash, size_type entry) const {
+        std::uint8_t ctrl = __impl__::flat_control(hash);
+        size_type mask = control.size() - 1;
+        for (size_type pos = __impl__::flat_position(hash) & mask;; pos = (pos + 1) & mask)
+            if (control[pos] == ctrl && slots[pos] == entry)
+                return pos;
+    }
+
+    void flat_compound::insert_slot(std::size_t hash, size_type entry) {
+        size_type mask = control.size() - 1;
+        size_type pos = __impl__::flat_position(hash) & mask;
+        while (control[pos] != __impl__::flat_empty && control[pos] != __impl__::flat_deleted)
+            pos = (pos + 1) & mask;
+        if (control[pos] == __impl__::flat_deleted)
+            --tombstones;
+        control[pos] = __impl__::flat_control(hash);
+        slots[pos] = (std::uint32_t)entry;
+    }
+
+    void flat_compound::rebuild_index(size_type min_count) {
+        if (min_count > UINT32_MAX)
+            throw std::overflow_error("flat_compound can't hold more than UINT32_MAX entries");
+        size_type capacity = 32;
+        //keep at least 1/8 of control bytes empty so probing always ends
+        while (capacity * 7 < min_count * 8)
+            capacity <<= 1;
+        std::vector<std::uint8_t> new_control(capacity, __impl__::flat_empty);
+        std::vector<std::uint32_t> new_slots(capacity);
+        if (hashes.size() != entries.size()) {
+            std::vector<std::size_t> new_hashes;
+            new_hashes.reserve(std::max(min_count, entries.size()));
+            for (auto& item : entries)
+                new_hashes.push_back(__impl__::flat_hash(item.first));
+            hashes = std::move(new_hashes);
+        }
+        control = std::move(new_control);
+        slots = std::move(new_slots);
+        tombstones = 0;
+        for (size_type i = 0; i < entries.size(); i++)
+            insert_slot(hashes[i], i);
+    }
+
+    std::pair<flat_compound::size_type, bool> flat_compound::emplace_key(std::string_view key) {
+        return emplace_key(key, control.empty() ? 0 : __impl__::flat_hash(key));
+    }
+
+    std::pair<flat_compound::size_type, bool> flat_compound::emplace_key(std::string_view key, std::size_t hash) {
+        if (control.empty()) {
+            auto it = std::lower_bound(entries.begin(), entries.end(), key, __impl__::flat_less);
+            if (it != entries.end() && it->first == key)
+                return {it - entries.begin(), false};
+            if (entries.size() < small_limit) {
+                it = entries.emplace(it, std::string(key), value());
+                return {it - entries.begin(), true};
+            }
+            entries.emplace_back(std::string(key), value());
+            try {
+                rebuild_index(entries.size());
+            } catch (...) {
+                entries.pop_back();
+                throw;
+            }
+            return {entries.size() - 1, true};
+        }
+        size_type found = find_index(key, hash);
+        if (found != entries.size())
+            return {found, false};
+        if ((entries.size() + 1 + tombstones) * 8 > control.size() * 7)
+            rebuild_index(entries.size() + 1);
+        hashes.push_back(hash);
+        try {
+            entries.emplace_back(std::string(key), value());
+        } catch (...) {
+            hashes.pop_back();
+            throw;
+        }
+        insert_slot(hash, entries.size() - 1);
+        return {entries.size() - 1, true};
+    }
+
+    void flat_compound::erase_index(size_type entry) {
+        size_type mask = control.size() - 1;
+        size_type pos = find_slot(hashes[entry], entry);
+        //a probe that reaches an empty byte stops anyway, so the slot before it can be emptied too
+        if (control[(pos + 1) & mask] == __impl__::flat_empty)
+            control[pos] = __impl__::flat_empty;
+        else {
+            control[pos] = __impl__::flat_deleted;
+            ++tombstones;
+        }
+        size_type last = entries.size() - 1;
+        if (entry != last) {
+            slots[find_slot(hashes[last], last)] = (std::uint32_t)entry;
+            entries[entry] = std::move(entries[last]);
+            hashes[entry] = hashes[last];
+        }
+        entries.pop_back();
+        hashes.pop_back();
+    }
+
+    value& flat_compound::at(std::string_view key) {
+        size_type index = find_index(key);
+        if (index == entries.size())
+            throw std::out_of_range("Key not found");
+        return entries[index].second;
+    }
+
+    const value& flat_compound::at(std::string_view key) const {
+        size_type index = find_index(key);
+        if (index == entries.size())
+            throw std::out_of_range("Key not found");
+        return entries[index].second;
+    }
+
+    value& flat_compound::at(const enbt::key& key) {
+        size_type index = find_index(key, key.hash());
+        if (index == entries.size())
+            throw std::out_of_range("Key not found");
+        return entries[index].second;
+    }
+
+    const value& flat_compound::at(const enbt::key& key) const {
+        size_type index = find_index(key, key.hash());
+        if (index == entries.size())
+            throw std::out_of_range("Key not found");
+        return entries[index].second;
+    }
+
+    flat_compound::size_type flat_compound::erase(std::string_view key) {
+        size_type index = find_index(key);
+        if (index == entries.size())
+            return 0;
+        erase(const_iterator(entries.cbegin() + index));
+        return 1;
+    }
+
+    flat_compound::iterator flat_compound::erase(const_iterator where) {
+        size_type index = where.position - entries.cbegin();
+        if (control.empty())
+            entries.erase(where.position);
+        else
+            erase_index(index);
+        return iterator(entries.begin() + index);
+    }
+
+    void flat_compound::clear() noexcept {
+        entries.clear();
+        hashes.clear();
+        control.clear();
+        slots.clear();
+        tombstones = 0;
+    }
+
+    void flat_compound::reserve(size_type count) {
+        entries.reserve(count);
+        if (count <= small_limit)
+            return;
+        if (control.empty() || (count + tombstones) * 8 > control.size() * 7)
+            rebuild_index(std::max(count, entries.size()));
+        hashes.reserve(count);
+    }
+
+    flat_compound& flat_compound::merge(const flat_compound& copy) & {
+        for (auto& [name, val] : copy.entries) {
+            auto& it = operator[](name);
+            if (it.is_compound() && val.is_compound())
+                it.merge(val);
+            else
+                it = val;
+        }
+        return *this;
+    }
+
+    flat_compound& flat_compound::merge(flat_compound&& move) & {
+        for (auto& [name, val] : move.entries) {
+            auto& it = operator[](name);
+            if (it.is_compound() && val.is_compound())
+                it.merge(std::move(val));
+            else
+                it = std::move(val);
+        }
+        return *this;
+    }
+
+    flat_compound& flat_compound::merge(const value& copy) & {
+        if (!copy.is_compound())
+            throw enbt::exception("value is not a compound");
+        for (auto& [name, val] : *std::get<std::unordered_map<std::string, value>*>(copy.content())) {
+            auto& it = operator[](name);
+            if (it.is_compound() && val.is_compound())
+                it.merge(val);
+            else
+                it = val;
+        }
+        return *this;
+    }
+
+    flat_compound& flat_compound::merge(value&& move) & {
+        if (!move.is_compound())
+            throw enbt::exception("value is not a compound");
+        for (auto& [name, val] : *std::get<std::unordered_map<std::string, value>*>(move.content())) {
+            auto& it = operator[](name);
+            if (it.is_compound() && val.is_compound())
+                it.merge(std::move(val));
+            else
+                it = std::move(val);
+        }
+        return *this;
+    }
+
+    bool flat_compound::operator==(const flat_compound& other) const {
+        if (entries.size() != other.entries.size())
+            return false;
+        for (auto& [name, val] : entries) {
+            size_type index = other.find_index(name);
+            if (index == other.entries.size() || other.entries[index].second != val)
+                return false;
+        }
+        return true;
+    }
+
+    value flat_compound::to_value() const& {
+        std::unordered_map<std::string, value> result;
+        result.reserve(entries.size());
+        for (auto& [name, val] : entries)
+            result.emplace(name, val);
+        return result;
+    }
+
+    value flat_compound::to_value() && {
+        std::unordered_map<std::string, value> result;
+        result.reserve(entries.size());
+        for (auto& [name, val] : entries)
+            result.emplace(std::move(name), std::move(val));
+        clear();
+        return result;
+    }
+
+    std::size_t bit_array_ref::find_next(std::size_t pos, bool value) const noexcept {
+        if (pos >= size_)
+            return npos;
+        std::size_t word = pos / word_bits;
+        std::size_t n = word_count();
+        std::uint64_t current = value ? words[word] : ~words[word];
+        current &= ~std::uint64_t(0) << (pos % word_bits);
+        while (true) {
+            if (current) {
+                std::size_t found = word * word_bits + std::countr_zero(current);
+                return found < size_ ? found : npos;
+            }
+            if (++word == n)
+                return npos;
+            current = value ? words[word] : ~words[word];
+        }
+    }
+
+    bit_array_ref& bit_array_ref::operator&=(const bit_array_ref& other) {
+        if (size_ != other.size_)
+            throw enbt::exception("bit_array sizes do not match");
+        for (std::size_t i = 0, n = word_count(); i < n; i++)
+            words[i] &= other.words[i];
+        return *this;
+    }
+
+    bit_array_ref& bit_array_ref::operator|=(const bit_array_ref& other) {
+        if (size_ != other.size_)
+            throw enbt::exception("bit_array sizes do not match");
+        for (std::size_t i = 0, n = word_count(); i < n; i++)
+            words[i] |= other.words[i];
+        return *this;
+    }
+
+    bit_array_ref& bit_array_ref::operator^=(const bit_array_ref& other) {
+        if (size_ != other.size_)
+            throw enbt::exception("bit_array sizes do not match");
+        for (std::size_t i = 0, n = word_count(); i < n; i++)
+            words[i] ^= other.words[i];
+        return *this;
+    }
+
+    value bit_array_ref::to_value() const {
+        std::vector<value> result;
+        result.reserve(size_);
+        for (std::size_t i = 0; i < size_; i++)
+            result.emplace_back(test(i));
+        return value(std::move(result), enbt::type::array);
+    }
+
+    bit_array::bit_array(const value& abstract) {
+        if (!abstract.is_array())
+            throw enbt::exception("value is not an array of bits");
+        auto items = (const std::vector<value>*)abstract.get_internal_ptr();
+        storage.resize(words_for(items->size()));
+        size_ = items->size();
+        sync();
+        for (std::size_t i = 0; i < size_; i++) {
+            auto& item = (*items)[i];
+            if (!item.is_bit())
+                throw enbt::exception("value is not an array of bits");
+            if ((bool)item)
+                set(i);
+        }
+    }
+
+    bit_array bit_array::from_words(std::vector<std::uint64_t>&& words, std::size_t size) {
+        if (words.size() < words_for(size))
+            throw enbt::exception("not enough words for bit_array size");
+        bit_array result;
+        result.storage = std::move(words);
+        result.storage.resize(words_for(size));
+        result.size_ = size;
+        result.sync();
+        result.clear_tail();
+        return result;
+    }
+
+    namespace io_helper {
+        namespace __impl__ {
+            inline std::uint64_t load_le64(const std::uint8_t* data) noexcept {
+                std::uint64_t word;
+                std::memcpy(&word, data, 8);
+                return endian_helpers::convert_endian(std::endian::little, word);
+            }
+
+            inline void store_le64(std::uint8_t* out, std::uint64_t word) noexcept {
+                word = endian_helpers::convert_endian(std::endian::little, word);
+                std::memcpy(out, &word, 8);
+            }
+
+            //drops the continuation bits of 8 varint bytes and joins the 7 bit groups, pairs first, then quads, then halves
+            inline std::uint64_t pack_var_groups(std::uint64_t word) noexcept {
+                word &= 0x7F7F'7F7F'7F7F'7F7F;
+                word = (word & 0x007F'007F'007F'007F) | ((word & 0x7F00'7F00'7F00'7F00) >> 1);
+                word = (word & 0x0000'3FFF'0000'3FFF) | ((word & 0x3FFF'0000'3FFF'0000) >> 2);
+                return (word & 0x0000'0000'0FFF'FFFF) | ((word & 0x0FFF'FFFF'0000'0000) >> 4);
+            }
+
+            //inverse of pack_var_groups for the low 56 bits
+            inline std::uint64_t spread_var_groups(std::uint64_t value) noexcept {
+                value &= 0x00FF'FFFF'FFFF'FFFF;
+                value = (value & 0x0000'0000'0FFF'FFFF) | ((value & 0x00FF'FFFF'F000'0000) << 4);
+                value = (value & 0x0000'3FFF'0000'3FFF) | ((value & 0x0FFF'C000'0FFF'C000) << 2);
+                return (value & 0x007F'007F'007F'007F) | ((value & 0x3F80'3F80'3F80'3F80) << 1);
+            }
+
+            //byte at a time continuation of decode_var from byte i, kept out of line so the word path stays small
+            std::size_t decode_var_tail(const std::uint8_t* data, std::size_t size, std::uint64_t& value, std::size_t i, std::uint64_t res) {
+                for (; i < max_var_size; i++) {
+                    if (i == size)
+                        throw enbt::exception("Unexpected end of buffer");
+                    std::uint8_t byte = data[i];
+                    if (i == max_var_size - 1 && byte > 1)
+                        break;
+                    res |= std::uint64_t(byte & 0x7F) << (7 * i);
+                    if (!(byte & 0x80)) {
+                        value = res;
+                        return i + 1;
+                    }
+                }
+                throw enbt::exception("var value too big");
+            }
+
+            //one and two byte varints, the common lengths and counts, are decoded before any word work,
+            // with 8 readable bytes the terminator is found from the inverted continuation bits of one word
+            inline std::size_t decode_var(const std::uint8_t* data, std::size_t size, std::uint64_t& value) {
+                if (size && !(data[0] & 0x80)) {
+                    value = data[0];
+                    return 1;
+                }
+                if (size >= 2 && !(data[1] & 0x80)) {
+                    value = (data[0] & 0x7F) | (std::uint64_t(data[1]) << 7);
+                    return 2;
+                }
+                if (size < 8)
+                    return decode_var_tail(data, size, value, 0, 0);
+                std::uint64_t word = load_le64(data);
+                std::uint64_t stops = ~word & 0x8080'8080'8080'8080;
+                if (!stops)
+                    return decode_var_tail(data, size, value, 8, pack_var_groups(word));
+                value = pack_var_groups(word & (stops ^ (stops - 1)));
+                return std::size_t(std::countr_zero(stops)) / 8 + 1;
+            }
+
+            inline std::size_t var_size(std::uint64_t value) noexcept {
+                //ceil(bits / 7) without a division, zero still takes one byte
+                return (std::size_t(std::bit_width(value)) * 9 + 64) / 64;
+            }
+
+            inline std::size_t encode_var(std::uint64_t value, std::uint8_t* out) noexcept {
+                if (value < 0x80) {
+                    out[0] = std::uint8_t(value);
+                    return 1;
+                }
+                if (value < 0x4000) {
+                    out[0] = std::uint8_t(value) | 0x80;
+                    out[1] = std::uint8_t(value >> 7);
+                    return 2;
+                }
+                std::size_t len = var_size(value);
+                std::uint64_t word = spread_var_groups(value);
+                if (len <= 8) {
+                    store_le64(out, word | (0x8080'8080'8080'8080 & ((std::uint64_t(1) << (8 * (len - 1))) - 1)));
+                    return len;
+                }
+                store_le64(out, word | 0x8080'8080'8080'8080);
+                out[8] = std::uint8_t((value >> 56) & 0x7F) | (len == 10 ? 0x80 : 0);
+                out[9] = std::uint8_t(value >> 63);
+                return len;
+            }
+
+            inline std::size_t decode_compress_len(const std::uint8_t* data, std::size_t size, std::uint64_t& value) {
+                if (size == 0)
+                    throw enbt::exception("Unexpected end of buffer");
+                std::size_t len = std::size_t(1) << (data[0] >> 6);
+                if (size < len)
+                    throw enbt::exception("Unexpected end of buffer");
+                std::uint64_t word;
+                if (size >= 8)
+                    word = load_le64(data) & (~std::uint64_t(0) >> (64 - 8 * len));
+                else {
+                    std::uint8_t buf[8]{};
+                    std::memcpy(buf, data, len);
+                    word = load_le64(buf);
+                }
+                value = (word & 0x3F) | ((word >> 8) << 6);
+                return len;
+            }
+
+            inline std::uint64_t compress_len_flag(std::uint64_t value) {
+                if (value > 0x3FFF'FFFF'FFFF'FFFF)
+                    throw std::overflow_error("uint64_t cannot be converted to uint62_t without losing data");
+                return (value > 0x3F) + (value > 0x3FFF) + (value > 0x3FFF'FFFF);
+            }
+
+            inline std::size_t compress_len_size(std::uint64_t value) {
+                return std::size_t(1) << compress_len_flag(value);
+            }
+
+            inline std::size_t encode_compress_len(std::uint64_t value, std::uint8_t* out) {
+                std::uint64_t flag = compress_len_flag(value);
+                store_le64(out, (value & 0x3F) | (flag << 6) | ((value >> 6) << 8));
+                return std::size_t(1) << flag;
+            }
+        }
+
+        std::size_t decode_var(const std::uint8_t* data, std::size_t size, std::uint64_t& value) {
+            return __impl__::decode_var(data, size, value);
+        }
+
+        std::size_t decode_vars(const std::uint8_t* data, std::size_t size, std::uint64_t* values, std::size_t count) {
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < count; i++)
+                offset += __impl__::decode_var(data + offset, size - offset, values[i]);
+            return offset;
+        }
+
+        std::size_t encode_var(std::uint64_t value, std::uint8_t* out) noexcept {
+            return __impl__::encode_var(value, out);
+        }
+
+        std::size_t encode_vars(const std::uint64_t* values, std::size_t count, std::uint8_t* out) noexcept {
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < count; i++)
+                offset += __impl__::encode_var(values[i], out + offset);
+            return offset;
+        }
+
+        std::size_t decode_compress_len(const std::uint8_t* data, std::size_t size, std::uint64_t& value) {
+            return __impl__::decode_compress_len(data, size, value);
+        }
+
+        std::size_t encode_compress_len(std::uint64_t value, std::uint8_t* out) {
+            return __impl__::encode_compress_len(value, out);
+        }
+
+        namespace __impl__ {
+            template <class T, class Stream>
+            T _read_as_(Stream& input_stream) {
+                T res;
+                input_stream.read((char*)&res, sizeof(T));
+                return res;
+            }
+
+            template <class Stream>
+            std::uint8_t read_byte(Stream& read_stream) {
+                if constexpr (std::is_base_of_v<std::istream, Stream>) {
+                    //skips the sentry that istream::read sets up for every call
+                    auto c = read_stream.rdbuf()->sbumpc();
+                    if (c == std::char_traits<char>::eof()) {
+                        read_stream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+                        throw enbt::exception("Unexpected end of stream");
+                    }
+                    return std::uint8_t(c);
+                } else
+                    return _read_as_<std::uint8_t>(read_stream);
+            }
+
+            template <class T, class Stream>
+            T read_var(Stream& read_stream, std::endian endian) {
+                using U = std::make_unsigned_t<T>;
+                std::uint64_t decoded;
+                if constexpr (std::is_same_v<Stream, span_stream>) {
+                    auto rest = read_stream.data().subspan(read_stream.position());
+                    read_stream.read_span(decode_var((const std::uint8_t*)rest.data(), rest.size(), decoded));
+                } else {
+                    std::uint8_t buf[max_var_size];
+                    std::size_t len = 0;
+                    do {
+                        if (len == max_var_size)
+                            throw enbt::exception("var value too big");
+                        buf[len] = read_byte(read_stream);
+                    } while (buf[len++] & 0x80);
+                    decode_var(buf, len, decoded);
+                }
+                if (decoded > U(~U(0)))
+                    throw enbt::exception("var value too big");
+                U decoded_int = U(decoded);
+                if constexpr (std::is_signed_v<T>)
+                    return endian_helpers::convert_endian(endian, (T)((decoded_int >> 1) ^ -T(decoded_int & 1)));
+                else
+                    return endian_helpers::convert_endian(endian, decoded_int);
+            }
+
+            template <class T, class Stream>
+            T read_value(Stream& read_stream, std::endian endian = std::endian::native) {
+                T tmp;
+                if constexpr (std::is_same<T, enbt::raw_uuid>()) {
+                    read_stream.read((char*)tmp.data, 16);
+                    endian_helpers::convert_endian(endian, tmp.data, 16);
+                } else {
+                    read_stream.read((char*)&tmp, sizeof(T));
+                    tmp = endian_helpers::convert_endian(endian, tmp);
+                }
+                return tmp;
+            }
+
+            template <class T, class Stream>
+            T* read_array(Stream& read_stream, std::size_t len, std::endian endian = std::endian::native) {
+                T* tmp = enbt::__impl__::new_payload_array<T>(len);
+                if constexpr (sizeof(T) == 1)
+                    read_stream.read((char*)tmp, len);
+                else {
+                    read_stream.read((char*)tmp, len * sizeof(T));
+                    endian_helpers::convert_endian_arr(endian, tmp, len);
+                }
+                return tmp;
+            }
+
+            template <class t>
+            std::size_t var_value_size(value::value_variants value, std::endian endian) {
+                //same steps as write_var
+                constexpr size_t sign_bit_offset = sizeof(t) * 8 - 1;
+                t res = endian_helpers::convert_endian(endian, std::get<t>(value));
+                if constexpr (std::is_signed_v<t>)
+                    res = ((res) << 1) ^ ((res) >> sign_bit_offset);
+                return var_size(std::make_unsigned_t<t>(res));
+            }
+
+            std::size_t string_size(std::string_view str) {
+                std::size_t size_without_null = str.size() ? (str.back() != 0 ? str.size() : str.size() - 1) : 0;
+                return compress_len_size(size_without_null) + size_without_null;
+            }
+
+            std::size_t serialized_size(const value& val);
+
+            std::size_t serialized_value_size(const value& val) {
+                enbt::type_id tid = val.type_id();
+                switch (tid.type) {
+                case enbt::type::none:
+                case enbt::type::bit:
+                    return 0;
+                case enbt::type::integer:
+                    return std::size_t(1) << (int)tid.length;
+                case enbt::type::floating:
+                    if (tid.length == enbt::type_len::Tiny || tid.length == enbt::type_len::Short)
+                        throw enbt::exception("not implemented");
+                    return std::size_t(1) << (int)tid.length;
+                case enbt::type::var_integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                    case enbt::type_len::Short:
+                        throw enbt::exception("not implemented");
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            return var_value_size<std::int32_t>(val.content(), tid.get_endian());
+                        else
+                            return var_value_size<std::uint32_t>(val.content(), tid.get_endian());
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            return var_value_size<std::int64_t>(val.content(), tid.get_endian());
+                        else
+                            return var_value_size<std::uint64_t>(val.content(), tid.get_endian());
+                    }
+                    return 0;
+                case enbt::type::comp_integer:
+                    return compress_len_size((uint64_t)val);
+                case enbt::type::uuid:
+                    return 16;
+                case enbt::type::sarray:
+                    return compress_len_size(val.size()) + (val.size() << (int)tid.length);
+                case enbt::type::darray: {
+                    auto items = (const std::vector<value>*)val.get_internal_ptr();
+                    std::size_t res = std::size_t(1) << (int)tid.length;
+                    for (auto& it : *items)
+                        res += serialized_size(it);
+                    return res;
+                }
+                case enbt::type::compound: {
+                    auto items = (const std::unordered_map<std::string, value>*)val.get_internal_ptr();
+                    std::size_t res = std::size_t(1) << (int)tid.length;
+                    for (auto& it : *items)
+                        res += string_size(it.first) + serialized_size(it.second);
+                    return res;
+                }
+                case enbt::type::array: {
+                    auto items = (const std::vector<value>*)val.get_internal_ptr();
+                    std::size_t res = std::size_t(1) << (int)tid.length;
+                    if (items->empty())
+                        return res;
+                    if ((*items)[0].type_id().type == enbt::type::bit)
+                        return res + 1 + (items->size() + 7) / 8;
+                    res += 1;
+                    for (auto& it : *items)
+                        res += serialized_value_size(it);
+                    return res;
+                }
+                case enbt::type::optional:
+                    return val.contains() ? serialized_size(*val.get_optional()) : 0;
+                case enbt::type::string:
+                    return string_size(val.as_string_view());
+                case enbt::type::log_item: {
+                    std::size_t inner = serialized_size(val.get_log_value());
+                    return compress_len_size(inner) + inner;
+                }
+                }
+                return 0;
+            }
+
+            std::size_t serialized_size(const value& val) {
+                return 1 + serialized_value_size(val);
+            }
+
+            //sizing walks every item, for small containers it costs more than regrowing the vector once
+            bool worth_reserving(const value& val) {
+                switch (val.get_type()) {
+                case enbt::type::compound:
+                case enbt::type::darray:
+                case enbt::type::array:
+                    return val.size() >= 64;
+                case enbt::type::string:
+                case enbt::type::sarray:
+                    return true;
+                case enbt::type::log_item:
+                    return worth_reserving(val.get_log_value());
+                default:
+                    return false;
+                }
+            }
+
+            //nested values call these qualified, through adl output_sink would pick the public overloads that size the whole value again
+            template <class Stream>
+            void write_value(Stream& write_stream, const value& val);
+            template <class Stream>
+            void write_token(Stream& write_stream, const value& val);
+
+            template <class Stream>
+            void write_compress_len(Stream& write_stream, std::uint64_t len) {
+                std::uint8_t buf[8];
+                write_stream.write((const char*)buf, encode_compress_len(len, buf));
+            }
+
+            template <class t, class Stream>
+            void write_var(Stream& write_stream, t value, std::endian endian = std::endian::native) {
+                constexpr size_t sign_bit_offset = sizeof(t) * 8 - 1;
+
+                value = endian_helpers::convert_endian(endian, value);
+                if constexpr (std::is_signed_v<t>)
+                    value = ((value) << 1) ^ ((value) >> sign_bit_offset);
+                std::uint8_t buf[max_var_size];
+                write_stream.write((const char*)buf, encode_var(std::make_unsigned_t<t>(value), buf));
+            }
+
+            template <class t, class Stream>
+            void write_var(Stream& write_stream, value::value_variants value, std::endian endian = std::endian::native) {
+                write_var(write_stream, std::get<t>(value), endian);
+            }
+
+            template <class Stream>
+            void write_type_id(Stream& write_stream, enbt::type_id tid) {
+                union combined_t {
+                    enbt::type_id id;
+                    std::uint8_t raw;
+                } combined{.id = tid};
+
+                write_stream.put(char(combined.raw));
+            }
+
+            template <class t, class Stream>
+            void write_value(Stream& write_stream, t value, std::endian endian = std::endian::native) {
+                if constexpr (std::is_same<t, enbt::raw_uuid>())
+                    endian_helpers::convert_endian(endian, value.data, 16);
+                else
+                    value = endian_helpers::convert_endian(endian, value);
+                write_stream.write((char*)&value, sizeof(t));
+            }
+
+            template <class t, class Stream>
+            void write_value(Stream& write_stream, value::value_variants value, std::endian endian = std::endian::native) {
+                return write_value(write_stream, std::get<t>(value), endian);
+            }
+
+            template <class t, class Stream>
+            void write_array(Stream& write_stream, t* values, std::size_t len, std::endian endian = std::endian::native) {
+                if constexpr (sizeof(t) == 1) {
+                    write_stream.write((const char*)values, len);
+                } else if (endian == std::endian::native) {
+                    write_stream.write((const char*)values, len * sizeof(t));
+                } else {
+                    //swapped through a small buffer, so the source is never touched or copied whole
+                    constexpr std::size_t chunk = 4096 / sizeof(t);
+                    std::decay_t<t> buffer[chunk];
+                    for (std::size_t i = 0; i < len; i += chunk) {
+                        std::size_t items = std::min(chunk, len - i);
+                        endian_helpers::byteswap_items(buffer, values + i, sizeof(t), items);
+                        write_stream.write((const char*)buffer, items * sizeof(t));
+                    }
+                }
+            }
+
+            template <class t, class Stream>
+            void write_array(Stream& write_stream, value::value_variants* values, std::size_t len, std::endian endian = std::endian::native) {
+                std::vector<t> arr(len);
+                for (std::size_t i = 0; i < len; i++)
+                    arr[i] = std::get<t>(values[i]);
+                write_array(write_stream, arr.data(), len, endian);
+            }
+
+            template <class Stream>
+            void write_string(Stream& write_stream, const value& val) {
+                std::string_view str_ref = val.as_string_view();
+                std::size_t real_size = str_ref.size();
+                std::size_t size_without_null = real_size ? (str_ref[real_size - 1] != 0 ? real_size : real_size - 1) : 0;
+                write_compress_len(write_stream, size_without_null);
+                write_array(write_stream, str_ref.data(), size_without_null);
+            }
+
+            template <class Stream>
+            void write_string(Stream& write_stream, std::string_view val) {
+                std::size_t real_size = val.size();
+                std::size_t size_without_null = real_size ? (val[real_size - 1] != 0 ? real_size : real_size - 1) : 0;
+                write_compress_len(write_stream, size_without_null);
+                write_array(write_stream, val.data(), size_without_null);
+            }
+
+            template <class Stream>
+            void write_string(Stream& write_stream, const std::string& val) {
+                write_string(write_stream, (std::string_view)val);
+            }
+
+            template <class t, class Stream>
+            void write_define_len(Stream& write_stream, t value) {
+                return write_value(write_stream, value, std::endian::little);
+            }
+
+            template <class Stream>
+            void write_define_len(Stream& write_stream, std::uint64_t len, enbt::type_id tid) {
+                switch (tid.length) {
+                case enbt::type_len::Tiny:
+                    if (len != ((std::uint8_t)len))
+                        throw enbt::exception("cannot convert value to std::uint8_t");
+                    write_define_len(write_stream, (std::uint8_t)len);
+                    break;
+                case enbt::type_len::Short:
+                    if (len != ((std::uint16_t)len))
+                        throw enbt::exception("cannot convert value to std::uint16_t");
+                    write_define_len(write_stream, (std::uint16_t)len);
+                    break;
+                case enbt::type_len::Default:
+                    if (len != ((std::uint32_t)len))
+                        throw enbt::exception("cannot convert value to std::uint32_t");
+                    write_define_len(write_stream, (std::uint32_t)len);
+                    break;
+                case enbt::type_len::Long:
+                    return write_define_len(write_stream, (std::uint64_t)len);
+                    break;
+                }
+            }
+
+            template <class Stream>
+            void initialize_version(Stream& write_stream) {
+                write_stream.put((char)ENBT_VERSION_HEX);
+            }
+
+            template <class Stream>
+            void write_compound(Stream& write_stream, const value& val) {
+                auto result = (const std::unordered_map<std::string, value>*)val.get_internal_ptr();
+                write_define_len(write_stream, result->size(), val.type_id());
+                for (auto& it : *result) {
+                    write_string(write_stream, it.first);
+                    __impl__::write_token(write_stream, it.second);
+                }
+            }
+
+            template <class Stream>
+            void write_array(Stream& write_stream, const value& val) {
+                if (!val.is_array())
+                    throw enbt::exception("this is not array for serialize it");
+                auto result = (const std::vector<value>*)val.get_internal_ptr();
+                std::size_t len = result->size();
+                write_define_len(write_stream, len, val.type_id());
+                if (len) {
+                    enbt::type_id tid = (*result)[0].type_id();
+                    if (tid.type != enbt::type::bit) {
+                        write_type_id(write_stream, tid);
+                        for (const auto& it : *result)
+                            __impl__::write_value(write_stream, it);
+                    } else {
+                        //packed 8 per byte, item i is bit i % 8 of byte i / 8
+                        write_type_id(write_stream, enbt::type_id{enbt::type::bit});
+                        std::int8_t i = 0;
+                        std::uint8_t value = 0;
+                        for (auto& it : *result) {
+                            if (i >= 8) {
+                                i = 0;
+                                write_stream.put(char(value));
+                                value = 0;
+                            }
+                            value |= std::uint8_t((bool)it) << i;
+                            i++;
+                        }
+                        if (i)
+                            write_stream.put(char(value));
+                    }
+                }
+            }
+
+            template <class Stream>
+            void write_darray(Stream& write_stream, const value& val) {
+                if (!val.is_array())
+                    throw enbt::exception("this is not array for serialize it");
+                auto result = (const std::vector<value>*)val.get_internal_ptr();
+                write_define_len(write_stream, result->size(), val.type_id());
+                for (auto& it : *result)
+                    __impl__::write_token(write_stream, it);
+            }
+
+            template <class Stream>
+            void write_simple_array(Stream& write_stream, const value& val) {
+                write_compress_len(write_stream, val.size());
+                switch (val.type_id().length) {
+                case enbt::type_len::Tiny:
+                    write_array(write_stream, val.get_internal_ptr(), val.size());
+                    break;
+                case enbt::type_len::Short:
+                    write_array(write_stream, (const std::uint16_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
+                    break;
+                case enbt::type_len::Default:
+                    write_array(write_stream, (const std::uint32_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
+                    break;
+                case enbt::type_len::Long:
+                    write_array(write_stream, (const std::uint64_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            template <class Stream>
+            void write_log_item(Stream& write_stream, const value& val) {
+                const value& item = val.get_log_value();
+                write_compress_len(write_stream, serialized_size(item));
+                __impl__::write_token(write_stream, item);
+            }
+
+            template <class Stream>
+            void write_value(Stream& write_stream, const value& val) {
+                enbt::type_id tid = val.type_id();
+                switch (tid.type) {
+                case enbt::type::none:
+                case enbt::type::bit:
+                    return;
+                case enbt::type::integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                        if (tid.is_signed)
+                            return write_value<std::int8_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_value<std::uint8_t>(write_stream, val.content(), tid.get_endian());
+                    case enbt::type_len::Short:
+                        if (tid.is_signed)
+                            return write_value<std::int16_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_value<std::uint16_t>(write_stream, val.content(), tid.get_endian());
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            return write_value<std::int32_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_value<std::uint32_t>(write_stream, val.content(), tid.get_endian());
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            return write_value<std::int64_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_value<std::uint64_t>(write_stream, val.content(), tid.get_endian());
+                    }
+                    return;
+                case enbt::type::floating:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                    case enbt::type_len::Short:
+                        throw enbt::exception("not implemented");
+                    case enbt::type_len::Default:
+                        return write_value<float>(write_stream, val.content(), tid.get_endian());
+                    case enbt::type_len::Long:
+                        return write_value<double>(write_stream, val.content(), tid.get_endian());
+                    }
+                    return;
+                case enbt::type::var_integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                    case enbt::type_len::Short:
+                        throw enbt::exception("not implemented");
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            return write_var<std::int32_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_var<std::uint32_t>(write_stream, val.content(), tid.get_endian());
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            return write_var<std::int64_t>(write_stream, val.content(), tid.get_endian());
+                        else
+                            return write_var<std::uint64_t>(write_stream, val.content(), tid.get_endian());
+                    }
+                    return;
+                case enbt::type::comp_integer:
+                    return write_compress_len(write_stream, (uint64_t)val);
+                case enbt::type::uuid:
+                    return write_value<enbt::raw_uuid>(write_stream, val.content(), tid.get_endian());
+                case enbt::type::sarray:
+                    return write_simple_array(write_stream, val);
+                case enbt::type::darray:
+                    return write_darray(write_stream, val);
+                case enbt::type::compound:
+                    return write_compound(write_stream, val);
+                case enbt::type::array:
+                    return write_array(write_stream, val);
+                case enbt::type::optional:
+                    if (val.contains())
+                        __impl__::write_token(write_stream, *val.get_optional());
+                    break;
+                case enbt::type::string:
+                    return write_string(write_stream, val);
+                case enbt::type::log_item: {
+                    return write_log_item(write_stream, val);
+                }
+                }
+            }
+
+            template <class Stream>
+            void write_token(Stream& write_stream, const value& val) {
+                union combined_t {
+                    enbt::type_id id;
+                    std::uint8_t raw;
+                } combined{.id = val.type_id()};
+
+                write_stream.put(char(combined.raw));
+                __impl__::write_value(write_stream, val);
+            }
+
+            template <class Stream>
+            void write_compound(Stream& write_stream, const flat_compound& val) {
+                write_define_len(write_stream, val.size(), enbt::type_id{enbt::type::compound, calc_type_len(val.size()), false});
+                for (const auto& [name, item] : val) {
+                    write_string(write_stream, name);
+                    __impl__::write_token(write_stream, item);
+                }
+            }
+
+            template <class Stream>
+            void write_token(Stream& write_stream, const flat_compound& val) {
+                write_type_id(write_stream, enbt::type_id{enbt::type::compound, calc_type_len(val.size()), false});
+                write_compound(write_stream, val);
+            }
+
+            template <class Stream>
+            void write_array(Stream& write_stream, const bit_array_ref& val) {
+                std::size_t len = val.size();
+                write_define_len(write_stream, len, enbt::type_id{enbt::type::array, calc_type_len(len), false});
+                if (!len)
+                    return;
+                write_type_id(write_stream, enbt::type_id{enbt::type::bit});
+                std::size_t bytes = (len + 7) / 8;
+                if constexpr (std::endian::native == std::endian::little)
+                    write_stream.write((const char*)val.data(), bytes);
+                else {
+                    for (std::size_t i = 0; i < bytes; i++)
+                        write_stream.put(char(val.data()[i / 8] >> (i % 8 * 8)));
+                }
+            }
+
+            template <class Stream>
+            void write_token(Stream& write_stream, const bit_array_ref& val) {
+                write_type_id(write_stream, enbt::type_id{enbt::type::array, calc_type_len(val.size()), false});
+                write_array(write_stream, val);
+            }
+
+            template <class Stream>
+            value read_value(Stream& read_stream, enbt::type_id tid);
+            template <class Stream>
+            value read_token(Stream& read_stream);
+            template <class Stream>
+            void skip_value(Stream& read_stream, enbt::type_id tid);
+            template <class Stream>
+            void skip_token(Stream& read_stream);
+            template <class Stream>
+            void skip_string(Stream& read_stream);
+
+            template <class Stream>
+            enbt::type_id read_type_id(Stream& read_stream) {
+                union combined_t {
+                    enbt::type_id id;
+                    std::uint8_t raw;
+                } combined{.raw = __impl__::_read_as_<std::uint8_t>(read_stream)};
+
+                return combined.id;
+            }
+
+            template <class T, class Stream>
+            T read_define_len(Stream& read_stream) {
+                return read_value<T>(read_stream, std::endian::little);
+            }
+
+            template <class Stream>
+            std::size_t read_define_len(Stream& read_stream, enbt::type_id tid) {
+                switch (tid.length) {
+                case enbt::type_len::Tiny:
+                    return read_define_len<std::uint8_t>(read_stream);
+                case enbt::type_len::Short:
+                    return read_define_len<std::uint16_t>(read_stream);
+                case enbt::type_len::Default:
+                    return read_define_len<std::uint32_t>(read_stream);
+                case enbt::type_len::Long: {
+                    std::uint64_t val = read_define_len<std::uint64_t>(read_stream);
+                    if ((std::size_t)val != val)
+                        throw std::overflow_error("array length too big for this platform");
+                    return val;
+                }
+                default:
+                    return 0;
+                }
+            }
+
+            template <class Stream>
+            std::uint64_t read_define_len64(Stream& read_stream, enbt::type_id tid) {
+                switch (tid.length) {
+                case enbt::type_len::Tiny:
+                    return read_define_len<std::uint8_t>(read_stream);
+                case enbt::type_len::Short:
+                    return read_define_len<std::uint16_t>(read_stream);
+                case enbt::type_len::Default:
+                    return read_define_len<std::uint32_t>(read_stream);
+                case enbt::type_len::Long:
+                    return read_define_len<std::uint64_t>(read_stream);
+                default:
+                    return 0;
+                }
+            }
+
+            template <class Stream>
+            std::uint64_t read_compress_len(Stream& read_stream) {
+                std::uint64_t len;
+                if constexpr (std::is_same_v<Stream, span_stream>) {
+                    auto rest = read_stream.data().subspan(read_stream.position());
+                    read_stream.read_span(decode_compress_len((const std::uint8_t*)rest.data(), rest.size(), len));
+                } else {
+                    std::uint8_t buf[8]{};
+                    read_stream.read((char*)buf, 1);
+                    std::size_t size = std::size_t(1) << (buf[0] >> 6);
+                    if (size > 1)
+                        read_stream.read((char*)buf + 1, size - 1);
+                    decode_compress_len(buf, size, len);
+                }
+                return len;
+            }
+
+            template <class Stream>
+            std::string read_string(Stream& read_stream) {
+                std::uint64_t read = read_compress_len(read_stream);
+                std::string res;
+                res.resize(read);
+                read_stream.read(res.data(), read);
+                return res;
+            }
+
+            template <class Stream>
+            enbt::key read_key(Stream& read_stream, symbol_table& table) {
+                std::uint64_t read = read_compress_len(read_stream);
+                if constexpr (std::is_same_v<Stream, span_stream>) {
+                    auto bytes = read_stream.read_span(read);
+                    return table.intern(std::string_view((const char*)bytes.data(), bytes.size()));
+                } else {
+                    //only lives until the name is interned, nested reads start after that
+                    thread_local std::string buffer;
+                    buffer.resize(read);
+                    read_stream.read(buffer.data(), read);
+                    return table.intern(buffer);
+                }
+            }
+
+            template <class Stream>
+            value read_compound(Stream& read_stream, enbt::type_id tid) {
+                std::size_t len = read_define_len(read_stream, tid);
+                std::unordered_map<std::string, value> result;
+                result.reserve(len);
+                for (std::size_t i = 0; i < len; i++) {
+                    std::string key = read_string(read_stream);
+                    result.insert_or_assign(std::move(key), read_token(read_stream));
+                }
+                return result;
+            }
+
+            template <class Stream>
+            flat_compound read_flat_compound(Stream& read_stream, enbt::type_id tid) {
+                std::size_t len = read_define_len(read_stream, tid);
+                flat_compound result;
+                result.reserve(len);
+                for (std::size_t i = 0; i < len; i++) {
+                    //the entry owns the only copy of the name, a span_stream name is viewed in place
+                    if constexpr (std::is_same_v<Stream, span_stream>) {
+                        std::string_view key = io_helper::read_string_view(read_stream);
+                        result.insert_or_assign(key, read_token(read_stream));
+                    } else {
+                        std::string key = read_string(read_stream);
+                        result.insert_or_assign(key, read_token(read_stream));
+                    }
+                }
+                return result;
+            }
+
+            template <class Stream>
+            bit_array read_bit_array(Stream& read_stream, enbt::type_id tid) {
+                if (tid.type != enbt::type::array)
+                    throw enbt::exception("Invalid tid, expected array of bits");
+                std::size_t len = read_define_len(read_stream, tid);
+                if (!len)
+                    return {};
+                if (read_type_id(read_stream).type != enbt::type::bit)
+                    throw enbt::exception("Invalid tid, expected array of bits");
+                std::size_t bytes = (len + 7) / 8;
+                std::vector<std::uint64_t> words((len + 63) / 64);
+                if constexpr (std::endian::native == std::endian::little)
+                    read_stream.read((char*)words.data(), bytes);
+                else {
+                    for (std::size_t i = 0; i < bytes; i++)
+                        words[i / 8] |= std::uint64_t(__impl__::_read_as_<std::uint8_t>(read_stream)) << (i % 8 * 8);
+                }
+                return bit_array::from_words(std::move(words), len);
+            }
+
+            template <class Stream>
+            std::vector<value> read_array_items(Stream& read_stream, std::size_t len, enbt::type_id a_tid) {
+                std::vector<value> result(len);
+                if (a_tid.type == enbt::type::bit) {
+                    std::int8_t i = 0;
+                    std::uint8_t value = __impl__::_read_as_<std::uint8_t>(read_stream);
+                    for (auto& it : result) {
+                        if (i >= 8) {
+                            i = 0;
+                            value = __impl__::_read_as_<std::uint8_t>(read_stream);
+                        }
+                        it = (bool)(value & (1 << i));
+                        i++;
+                    }
+                } else {
+                    for (std::size_t i = 0; i < len; i++)
+                        result[i] = read_value(read_stream, a_tid);
+                }
+                return result;
+            }
+
+            template <class Stream>
+            std::vector<value> read_array(Stream& read_stream, enbt::type_id tid) {
+                std::size_t len = read_define_len(read_stream, tid);
+                if (!len)
+                    return {};
+                return read_array_items(read_stream, len, read_type_id(read_stream));
+            }
+
+            template <class Stream>
+            value read_compact_array_items(Stream& read_stream, std::size_t len, enbt::type_id tid, enbt::type_id a_tid) {
+                if (a_tid.type != enbt::type::integer)
+                    return value(read_array_items(read_stream, len, a_tid), tid);
+                //integers of an array are stored like sarray items, only the length prefix differs
+                enbt::type_id s_tid{enbt::type::sarray, a_tid.length, a_tid.endian, (bool)a_tid.is_signed};
+                auto endian = a_tid.get_endian();
+                switch (a_tid.length) {
+                case enbt::type_len::Tiny:
+                    return enbt::value::build_inline(read_array<std::uint8_t>(read_stream, len, endian), len, s_tid);
+                case enbt::type_len::Short:
+                    return enbt::value::build_inline((std::uint8_t*)read_array<std::uint16_t>(read_stream, len, endian), len, s_tid);
+                case enbt::type_len::Default:
+                    return enbt::value::build_inline((std::uint8_t*)read_array<std::uint32_t>(read_stream, len, endian), len, s_tid);
+                default:
+                    return enbt::value::build_inline((std::uint8_t*)read_array<std::uint64_t>(read_stream, len, endian), len, s_tid);
+                }
+            }
+
+            template <class Stream>
+            value read_compact_array(Stream& read_stream, enbt::type_id tid) {
+                std::size_t len = read_define_len(read_stream, tid);
+                if (!len)
+                    return value(std::vector<value>(), tid);
+                return read_compact_array_items(read_stream, len, tid, read_type_id(read_stream));
+            }
+
+            template <class Stream>
+            std::vector<value> read_darray(Stream& read_stream, enbt::type_id tid) {
+                std::size_t len = read_define_len(read_stream, tid);
+                std::vector<value> result(len);
+                for (std::size_t i = 0; i < len; i++)
+                    result[i] = read_token(read_stream);
+                return result;
+            }
+
+            template <class Stream>
+            value read_sarray(Stream& read_stream, enbt::type_id tid) {
+                std::uint64_t len = read_compress_len(read_stream);
+                auto endian = tid.get_endian();
+                switch (tid.length) {
+                case enbt::type_len::Tiny: {
+                    std::uint8_t* arr = read_array<std::uint8_t>(read_stream, len, endian);
+                    return enbt::value::build_inline(arr, len, tid);
+                }
+                case enbt::type_len::Short: {
+                    std::uint16_t* arr = read_array<std::uint16_t>(read_stream, len, endian);
+                    return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
+                }
+                case enbt::type_len::Default: {
+                    std::uint32_t* arr = read_array<std::uint32_t>(read_stream, len, endian);
+                    return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
+                }
+                case enbt::type_len::Long: {
+                    std::uint64_t* arr = read_array<std::uint64_t>(read_stream, len, endian);
+                    return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
+                }
+                default:
+                    throw enbt::exception();
+                }
+            }
+
+            template <class Stream>
+            value read_log_item(Stream& read_stream) {
+                read_compress_len(read_stream);
+                return read_token(read_stream);
+            }
+
+            template <class Stream>
+            value read_value(Stream& read_stream, enbt::type_id tid) {
+                switch (tid.type) {
+                case enbt::type::integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                        if (tid.is_signed)
+                            return read_value<std::int8_t>(read_stream, tid.get_endian());
+                        else
+                            return read_value<std::uint8_t>(read_stream, tid.get_endian());
+                    case enbt::type_len::Short:
+                        if (tid.is_signed)
+                            return read_value<std::int16_t>(read_stream, tid.get_endian());
+                        else
+                            return read_value<std::uint16_t>(read_stream, tid.get_endian());
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            return read_value<std::int32_t>(read_stream, tid.get_endian());
+                        else
+                            return read_value<std::uint32_t>(read_stream, tid.get_endian());
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            return read_value<std::int64_t>(read_stream, tid.get_endian());
+                        else
+                            return read_value<std::uint64_t>(read_stream, tid.get_endian());
+                    default:
+                        return value();
+                    }
+                case enbt::type::floating:
+                    switch (tid.length) {
+                    case enbt::type_len::Default:
+                        return read_value<float>(read_stream, tid.get_endian());
+                    case enbt::type_len::Long:
+                        return read_value<double>(read_stream, tid.get_endian());
+                    default:
+                        return value();
+                    }
+                case enbt::type::var_integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            return value(read_var<std::int32_t>(read_stream, tid.get_endian()), true, tid.get_endian());
+                        else
+                            return value(read_var<std::uint32_t>(read_stream, tid.get_endian()), true, tid.get_endian());
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            return value(read_var<std::int64_t>(read_stream, tid.get_endian()), true, tid.get_endian());
+                        else
+                            return value(read_var<std::uint64_t>(read_stream, tid.get_endian()), true, tid.get_endian());
+                    default:
+                        return value();
+                    }
+                case enbt::type::comp_integer: {
+                    std::uint64_t val = read_compress_len(read_stream);
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                        if (val != ((std::uint8_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        return value((std::uint8_t)val);
+                    case enbt::type_len::Short:
+                        if (val != ((std::uint16_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        return value((std::uint16_t)val);
+                    case enbt::type_len::Default:
+                        if (val != ((std::uint32_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        return value((std::uint32_t)val);
+                    case enbt::type_len::Long:
+                        return value(val);
+                    default:
+                        return value();
+                    }
+                }
+                case enbt::type::uuid:
+                    return read_value<enbt::raw_uuid>(read_stream, tid.get_endian());
+                case enbt::type::sarray:
+                    return read_sarray(read_stream, tid);
+                case enbt::type::darray:
+                    if (get_array_compaction())
+                        return std::move(value(read_darray(read_stream, tid), tid).compact(false));
+                    return value(read_darray(read_stream, tid), tid);
+                case enbt::type::compound:
+                    return read_compound(read_stream, tid);
+                case enbt::type::array:
+                    if (get_array_compaction())
+                        return read_compact_array(read_stream, tid);
+                    return value(read_array(read_stream, tid), tid);
+                case enbt::type::optional:
+                    return tid.is_signed ? value(true, read_token(read_stream)) : value(false, value());
+                case enbt::type::bit:
+                    return value((bool)tid.is_signed);
+                case enbt::type::string:
+                    if constexpr (std::is_same_v<Stream, span_stream>)
+                        return io_helper::read_string_view(read_stream);
+                    else
+                        return read_string(read_stream);
+                case enbt::type::log_item:
+                    return to_log_item(read_log_item(read_stream));
+                default:
+                    return value();
+                }
+            }
+
+            template <class Stream>
+            value read_token(Stream& read_stream) {
+                return read_value(read_stream, read_type_id(read_stream));
+            }
+
+            template <class Stream>
+            value read_file(Stream& read_stream) {
+                check_version(read_stream);
+                return read_token(read_stream);
+            }
+
+            inline bool is_indexed_list_footer(const value& val) {
+                enbt::type_id tid = val.type_id();
+                return tid.type == enbt::type::sarray && tid.length == enbt::type_len::Long && val.size() == 3 && ((const std::uint64_t*)val.get_internal_ptr())[2] == indexed_list_magic;
+            }
+
+            template <class Stream>
+            std::vector<value> read_list_file(Stream& read_stream) {
+                check_version(read_stream);
+                std::vector<value> result;
+                //eof of istream is only set by a read past the end, so the next byte is peeked
+                auto at_end = [&]() {
+                    if constexpr (std::is_same_v<Stream, span_stream>)
+                        return read_stream.eof();
+                    else
+                        return read_stream.peek() == std::istream::traits_type::eof();
+                };
+                while (!at_end())
+                    result.emplace_back(read_token(read_stream));
+                //the index and footer of an indexed list file are not records
+                if (result.size() >= 2 && is_indexed_list_footer(result.back())) {
+                    result.pop_back();
+                    result.pop_back();
+                }
+                return result;
+            }
+
+            template <class Stream>
+            void check_version(Stream& read_stream) {
+                if (read_value<std::uint8_t>(read_stream) != ENBT_VERSION_HEX)
+                    throw enbt::exception("unsupported version");
+            }
+
+            template <class Stream>
+            void skip_compound(Stream& read_stream, enbt::type_id tid) {
+                std::uint64_t len = read_define_len64(read_stream, tid);
+                for (std::uint64_t i = 0; i < len; i++) {
+                    skip_string(read_stream);
+                    skip_token(read_stream);
+                }
+            }
+
+            template <class Stream>
+            void skip_array(Stream& read_stream, enbt::type_id tid) {
+                std::uint64_t len = read_define_len64(read_stream, tid);
+                if (!len)
+                    return;
+                auto items_tid = read_type_id(read_stream);
+                if (int index_multiplier = can_fast_index(items_tid); !index_multiplier)
+                    for (std::uint64_t i = 0; i < len; i++)
+                        skip_value(read_stream, items_tid);
+                else {
+                    if (items_tid.type == enbt::type::bit) {
+                        std::uint64_t actual_len = len / 8;
+                        if (len % 8)
+                            ++actual_len;
+                        read_stream.seekg(read_stream.tellg() += actual_len);
+                    } else
+                        read_stream.seekg(read_stream.tellg() += len * index_multiplier);
+                }
+            }
+
+            template <class Stream>
+            void skip_darray(Stream& read_stream, enbt::type_id tid) {
+                std::uint64_t len = read_define_len64(read_stream, tid);
+                for (std::uint64_t i = 0; i < len; i++)
+                    skip_token(read_stream);
+            }
+
+            template <class Stream>
+            void skip_sarray(Stream& read_stream, enbt::type_id tid) {
+                std::uint64_t index = read_compress_len(read_stream);
+                switch (tid.length) {
+                case enbt::type_len::Tiny:
+                    read_stream.seekg(read_stream.tellg() += index);
+                    break;
+                case enbt::type_len::Short:
+                    read_stream.seekg(read_stream.tellg() += index * 2);
+                    break;
+                case enbt::type_len::Default:
+                    read_stream.seekg(read_stream.tellg() += index * 4);
+                    break;
+                case enbt::type_len::Long:
+                    read_stream.seekg(read_stream.tellg() += index * 8);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            template <class Stream>
+            void skip_string(Stream& read_stream) {
+                std::uint64_t len = read_compress_len(read_stream);
+                read_stream.seekg(read_stream.tellg() += len);
+            }
+
+            template <class Stream>
+            void skip_log_item(Stream& read_stream) {
+                uint64_t val = read_compress_len(read_stream);
+                read_stream.seekg(read_stream.tellg() += val);
+            }
+
+            template <class Stream>
+            void skip_value(Stream& read_stream, enbt::type_id tid) {
+                switch (tid.type) {
+                case enbt::type::floating:
+                case enbt::type::integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                        read_stream.seekg(read_stream.tellg() += 1);
+                        break;
+                    case enbt::type_len::Short:
+                        read_stream.seekg(read_stream.tellg() += 2);
+                        break;
+                    case enbt::type_len::Default:
+                        read_stream.seekg(read_stream.tellg() += 4);
+                        break;
+                    case enbt::type_len::Long:
+                        read_stream.seekg(read_stream.tellg() += 8);
+                        break;
+                    }
+                    break;
+                case enbt::type::var_integer:
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                    case enbt::type_len::Short:
+                        throw enbt::exception("not implemented");
+                    case enbt::type_len::Default:
+                        if (tid.is_signed)
+                            read_var<std::int32_t>(read_stream, std::endian::native);
+                        else
+                            read_var<std::uint32_t>(read_stream, std::endian::native);
+                        break;
+                    case enbt::type_len::Long:
+                        if (tid.is_signed)
+                            read_var<std::int64_t>(read_stream, std::endian::native);
+                        else
+                            read_var<std::uint64_t>(read_stream, std::endian::native);
+                    }
+                    break;
+                case enbt::type::comp_integer: {
+                    uint64_t val = read_compress_len(read_stream);
+                    switch (tid.length) {
+                    case enbt::type_len::Tiny:
+                        if (val != ((std::uint8_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        break;
+                    case enbt::type_len::Short:
+                        if (val != ((std::uint16_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        break;
+                    case enbt::type_len::Default:
+                        if (val != ((std::uint32_t)val))
+                            throw enbt::exception("invalid encoding for comp_integer, type is too small");
+                        break;
+                    case enbt::type_len::Long:
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                }
+                case enbt::type::uuid:
+                    read_stream.seekg(read_stream.tellg() += 16);
+                    break;
+                case enbt::type::sarray:
+                    skip_sarray(read_stream, tid);
+                    break;
+                case enbt::type::darray:
+                    skip_darray(read_stream, tid);
+                    break;
+                case enbt::type::compound:
+                    skip_compound(read_stream, tid);
+                    break;
+                case enbt::type::array:
+                    skip_array(read_stream, tid);
+                    break;
+                case enbt::type::optional:
+                    if (tid.is_signed)
+                        skip_token(read_stream);
+                    break;
+                case enbt::type::none:
+                case enbt::type::bit:
+                    break;
+                case enbt::type::string:
+                    skip_string(read_stream);
+                    break;
+                case enbt::type::log_item:
+                    skip_log_item(read_stream);
+                    break;
+                }
+            }
+
+            template <class Stream>
+            void skip_token(Stream& read_stream) {
+                return skip_value(read_stream, read_type_id(read_stream));
+            }
+
+            //reads a string and compares it with key without materializing it
+            template <class Stream>
+            bool match_string(Stream& read_stream, std::string_view key) {
+                std::uint64_t len = read_compress_len(read_stream);
+                if constexpr (std::is_same_v<Stream, span_stream>) {
+                    auto bytes = read_stream.read_span(len);
+                    return std::string_view((const char*)bytes.data(), bytes.size()) == key;
+                } else {
+                    if (len != key.size()) {
+                        read_stream.seekg(read_stream.tellg() += len);
+                        return false;
+                    }
+                    char chunk[256];
+                    bool equal = true;
+                    for (std::size_t done = 0; done < len;) {
+                        std::size_t size = std::min<std::size_t>(sizeof(chunk), len - done);
+                        read_stream.read(chunk, size);
+                        equal = equal && std::memcmp(chunk, key.data() + done, size) == 0;
+                        done += size;
+                    }
+                    return equal;
+                }
+            }
+
+            //the view points into the buffer of a span_stream, or into scratch for other streams
+            template <class Stream>
+            std::string_view read_string_view(Stream& read_stream, std::string& scratch) {
+                std::uint64_t len = read_compress_len(read_stream);
+                if constexpr (std::is_same_v<Stream, span_stream>) {
+                    auto bytes = read_stream.read_span(len);
+                    return std::string_view((const char*)bytes.data(), bytes.size());
+                } else {
+                    scratch.resize(len);
+                    read_stream.read(scratch.data(), len);
+                    return scratch;
+                }
+            }
+
+            template <class Stream>
+            bool find_value_compound(Stream& read_stream, enbt::type_id tid, std::string_view key) {
+                std::size_t len = read_define_len(read_stream, tid);
+                for (std::size_t i = 0; i < len; i++) {
+                    if (!match_string(read_stream, key))
+                        skip_value(read_stream, read_type_id(read_stream));
+                    else
+                        return true;
+                }
+                return false;
+            }
+
+            template <class Stream>
+            void index_static_array(Stream& read_stream, std::uint64_t index, std::uint64_t len, enbt::type_id target_id) {
+                if (index >= len)
+                    throw enbt::exception('[' + std::to_string(index) + "] out of range " + std::to_string(len));
+                if (std::uint8_t skipper = can_fast_index(target_id)) {
+                    if (target_id.type != enbt::type::bit)
+                        read_stream.seekg(read_stream.tellg() += index * skipper);
+                    else
+                        read_stream.seekg(read_stream.tellg() += index / 8);
+                } else
+                    for (std::uint64_t i = 0; i < index; i++)
+                        skip_value(read_stream, target_id);
+            }
+
+            template <class Stream>
+            void index_dyn_array(Stream& read_stream, std::uint64_t index, std::uint64_t len) {
+                if (index >= len)
+                    throw enbt::exception('[' + std::to_string(index) + "] out of range " + std::to_string(len));
+                for (std::uint64_t i = 0; i < index; i++)
+                    skip_token(read_stream);
+            }
+
+            template <class Stream>
+            std::optional<enbt::type_id> index_array(Stream& read_stream, std::uint64_t index, enbt::type_id arr_tid) {
+                switch (arr_tid.type) {
+                case enbt::type::array: {
+                    std::uint64_t len = read_define_len64(read_stream, arr_tid);
+                    if (!len)
+                        throw enbt::exception("this array is empty");
+                    auto target_id = read_type_id(read_stream);
+                    index_static_array(read_stream, index, len, target_id);
+                    return target_id;
+                }
+                case enbt::type::darray:
+                    index_dyn_array(read_stream, index, read_define_len64(read_stream, arr_tid));
+                    return {};
+                default:
+                    throw enbt::exception("invalid type id");
+                }
+            }
+
+            template <class Stream>
+            std::optional<enbt::type_id> index_array(Stream& read_stream, std::uint64_t index) {
+                return index_array(read_stream, index, read_type_id(read_stream));
+            }
+
+            template <class Stream>
+            std::optional<enbt::type_id> move_to_value_path(Stream& read_stream, const value_path& value_path) {
+                return move_to_value_path(read_stream, value_path, read_type_id(read_stream));
+            }
+
+            template <class Stream>
+            std::optional<enbt::type_id> move_to_value_path(Stream& read_stream, const value_path& value_path, enbt::type_id current_id) {
+                try {
+                    for (auto&& tmp : value_path.path) {
+                        switch (current_id.type) {
+                        case enbt::type::array:
+                        case enbt::type::darray: {
+                            auto opt = index_array(read_stream, tmp, current_id);
+                            if (opt)
+                                current_id = *opt;
+                            else
+                                current_id = read_type_id(read_stream);
+                            continue;
+                        }
+                        case enbt::type::compound:
+                            if (!find_value_compound(read_stream, current_id, (std::string)tmp))
+                                return {};
+                            current_id = read_type_id(read_stream);
+                            continue;
+                        default:
+                            return {};
+                        }
+                    }
+                    return current_id;
+                } catch (const std::out_of_range&) {
+                    throw;
+                } catch (const std::exception&) {
+                    return {};
+                }
+            }
+
+            template <class Stream>
+            value get_value_path(Stream& read_stream, const value_path& value_path) {
+                auto old_pos = read_stream.tellg();
+                bool is_bit_value = false;
+                bool bit_value = false;
+                //items of a fixed array have no type id of their own
+                std::optional<enbt::type_id> item_id;
+                try {
+                    for (auto&& tmp : value_path.path) {
+                        auto tid = item_id ? *item_id : read_type_id(read_stream);
+                        item_id.reset();
+                        switch (tid.type) {
+                        case enbt::type::array: {
+                            std::uint64_t len = read_define_len64(read_stream, tid);
+                            auto target_id = read_type_id(read_stream);
+                            std::uint64_t index = tmp;
+                            index_static_array(read_stream, index, len, target_id);
+                            if (target_id.type == enbt::type::bit) {
+                                is_bit_value = true;
+                                bit_value = bool(__impl__::_read_as_<std::uint8_t>(read_stream) & (1 << (index % 8)));
+                            } else
+                                item_id = target_id;
+                            continue;
+                        }
+                        case enbt::type::darray:
+                            index_array(read_stream, std::stoull(tmp), tid);
+                            continue;
+                        case enbt::type::compound:
+                            if (!find_value_compound(read_stream, tid, (std::string)tmp)) {
+                                read_stream.seekg(old_pos);
+                                return false;
+                            }
+                            continue;
+                        default:
+                            throw std::invalid_argument("invalid path to value");
+                        }
+                    }
+                    //read the value before the cursor goes back to the root
+                    value res = is_bit_value ? value(bit_value) : item_id ? read_value(read_stream, *item_id) : read_token(read_stream);
+                    read_stream.seekg(old_pos);
+                    return res;
+                } catch (...) {
+                    read_stream.seekg(old_pos);
+                    throw;
+                }
+            }
+        }
+
+        mapped_file::mapped_file(const std::filesystem::path& path) {
+#ifdef _WIN32
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw enbt::exception("Failed to open file");
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size)) {
+                CloseHandle(file);
+                throw enbt::exception("Failed to get file size");
+            }
+            if (file_size.QuadPart) {
+                HANDLE file_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                void* view = file_mapping ? MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+                if (file_mapping)
+                    CloseHandle(file_mapping);
+                if (!view) {
+                    CloseHandle(file);
+                    throw enbt::exception("Failed to map file");
+                }
+                mapping = (const std::byte*)view;
+                length = (std::size_t)file_size.QuadPart;
+            }
+            CloseHandle(file);
+#else
+            int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (file == -1)
+                throw enbt::exception("Failed to open file");
+            struct stat file_stat;
+            if (::fstat(file, &file_stat) == -1) {
+                ::close(file);
+                throw enbt::exception("Failed to get file size");
+            }
+            if (file_stat.st_size) {
+                void* view = ::mmap(nullptr, (std::size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (view == MAP_FAILED) {
+                    ::close(file);
+                    throw enbt::exception("Failed to map file");
+                }
+                mapping = (const std::byte*)view;
+                length = (std::size_t)file_stat.st_size;
+            }
+            ::close(file);
+#endif
+        }
+
+        mapped_file::mapped_file(mapped_file&& other) noexcept
+            : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)) {}
+
+        mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+            if (this != &other) {
+                this->~mapped_file();
+                mapping = std::exchange(other.mapping, nullptr);
+                length = std::exchange(other.length, 0);
+            }
+            return *this;
+        }
+
+        mapped_file::~mapped_file() {
+            if (!mapping)
+                return;
+#ifdef _WIN32
+            UnmapViewOfFile(mapping);
+#else
+            ::munmap((void*)mapping, length);
+#endif
+            mapping = nullptr;
+            length = 0;
+        }
+
+        lookahead_buffer::lookahead_buffer(std::streambuf* source, std::size_t history)
+            : source(source), history(std::max<std::size_t>(history, 1)), capacity(this->history * 2), storage(new char[capacity]) {
+            setg(storage.get(), storage.get(), storage.get());
+        }
+
+        bool lookahead_buffer::fill() {
+            char* begin = eback();
+            std::size_t filled = egptr() - begin;
+            if (filled == capacity) {
+                //the window moves by whole history blocks, so each byte is moved once
+                std::memmove(begin, begin + filled - history, history);
+                base += filled - history;
+                filled = history;
+            }
+            //one blocking byte, then only what the source already has, so sockets are not read past the message
+            std::streamsize got = source->sgetn(begin + filled, 1);
+            if (got <= 0) {
+                setg(begin, begin + filled, begin + filled);
+                return false;
+            }
+            std::streamsize avail = source->in_avail();
+            if (avail > 0)
+                got += source->sgetn(begin + filled + 1, std::min<std::streamsize>(avail, capacity - filled - 1));
+            setg(begin, begin + filled, begin + filled + got);
+            return true;
+        }
+
+        lookahead_buffer::int_type lookahead_buffer::underflow() {
+            if (gptr() == egptr() && !fill())
+                return traits_type::eof();
+            return traits_type::to_int_type(*gptr());
+        }
+
+        std::streamsize lookahead_buffer::showmanyc() {
+            std::streamsize avail = source->in_avail();
+            return avail > 0 ? avail : 0;
+        }
+
+        lookahead_buffer::pos_type lookahead_buffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+            switch (dir) {
+            case std::ios_base::beg:
+                return seekpos(pos_type(off), which);
+            case std::ios_base::cur:
+                return seekpos(pos_type(base + (gptr() - eback()) + off), which);
+            default:
+                return pos_type(off_type(-1));
+            }
+        }
+
+        lookahead_buffer::pos_type lookahead_buffer::seekpos(pos_type pos, std::ios_base::openmode which) {
+            if (!(which & std::ios_base::in))
+                return pos_type(off_type(-1));
+            std::streamoff target = pos;
+            if (target < base)
+                throw enbt::exception("Seek position is out of lookahead history");
+            while (target > base + (egptr() - eback())) {
+                setg(eback(), egptr(), egptr());
+                if (!fill())
+                    return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + (target - base), egptr());
+            return pos;
+        }
+
+        output_sink::output_sink(std::vector<std::uint8_t>& buffer)
+            : growable(&buffer), growable_origin(buffer.size()) {
+            buffer.resize(growable_origin + 256);
+            window = (std::byte*)buffer.data() + growable_origin;
+            cursor = window;
+            window_end = (std::byte*)buffer.data() + buffer.size();
+        }
+
+        output_sink::output_sink(std::span<std::byte> buffer)
+            : window(buffer.data()), cursor(buffer.data()), window_end(buffer.data() + buffer.size()) {}
+
+        output_sink::output_sink(std::ostream& stream)
+            : stream(&stream), stream_origin(stream.tellp()), staging(new std::byte[staging_size]) {
+            window = staging.get();
+            cursor = window;
+            window_end = window + staging_size;
+        }
+
+        output_sink::~output_sink() {
+            flush();
+        }
 
-    value& value::operator=(int8_t set_value) {
-        return operator=(value(set_value));
-    }
+        void output_sink::flush_staging() {
+            std::size_t pending = window_size();
+            std::size_t position = cursor - window;
+            stream->write((const char*)window, pending);
+            if (position != pending)
+                stream->seekp(stream_origin + std::streamoff(flushed + position));
+            flushed += position;
+            cursor = window;
+            high_mark = 0;
+        }
 
-    value& value::operator=(uint16_t set_value) {
-        return operator=(value(set_value));
-    }
+        void output_sink::write_slow(const char* data, std::size_t size) {
+            if (stream) {
+                flush_staging();
+                if (size >= staging_size) {
+                    stream->write(data, size);
+                    flushed += size;
+                    return;
+                }
+            } else if (growable) {
+                std::size_t position = cursor - window;
+                std::size_t written = window_size();
+                std::size_t required = growable_origin + position + size;
+                std::size_t grown = std::max(required, growable->size() * 2);
+                if (required <= growable->capacity())
+                    grown = std::min(grown, growable->capacity());
+                growable->resize(grown);
+                window = (std::byte*)growable->data() + growable_origin;
+                cursor = window + position;
+                window_end = (std::byte*)growable->data() + growable->size();
+                high_mark = written;
+            } else
+                throw std::overflow_error("output buffer is full");
+            std::memcpy(cursor, data, size);
+            cursor += size;
+        }
 
-    value& value::operator=(int16_t set_value) {
-        return operator=(value(set_value));
-    }
+        output_sink& output_sink::seekp(std::streampos pos) {
+            std::size_t target = (std::size_t)std::streamoff(pos);
+            high_mark = window_size();
+            if (target >= flushed && target - flushed <= high_mark) {
+                cursor = window + (target - flushed);
+                return *this;
+            }
+            if (!stream)
+                throw std::out_of_range("seek position is out of written range");
+            flush_staging();
+            stream->seekp(stream_origin + std::streamoff(target));
+            flushed = target;
+            return *this;
+        }
 
-    value& value::operator=(uint32_t set_value) {
-        return operator=(value(set_value));
-    }
+        output_sink& output_sink::reserve(std::size_t size) {
+            if (!growable || size <= std::size_t(window_end - cursor))
+                return *this;
+            std::size_t position = cursor - window;
+            std::size_t required = growable_origin + position + size;
+            high_mark = window_size();
+            growable->resize(std::max(required, growable->size() * 2));
+            window = (std::byte*)growable->data() + growable_origin;
+            cursor = window + position;
+            window_end = (std::byte*)growable->data() + growable->size();
+            return *this;
+        }
 
-    value& value::operator=(int32_t set_value) {
-        return operator=(value(set_value));
-    }
+        bool output_sink::erase(std::size_t pos, std::size_t count) {
+            if (pos < flushed)
+                return false;
+            std::size_t from = pos - flushed;
+            std::size_t written = window_size();
+            if (count > written || from > written - count)
+                throw std::out_of_range("erased range is out of written range");
+            std::memmove(window + from, window + from + count, written - from - count);
+            std::size_t position = cursor - window;
+            cursor = window + (position >= from + count ? position - count : std::min(position, from));
+            high_mark = written - count;
+            return true;
+        }
+
+        output_sink& output_sink::flush() {
+            if (stream) {
+                if (window_size())
+                    flush_staging();
+                stream->flush();
+            } else if (growable) {
+                std::size_t position = cursor - window;
+                high_mark = window_size();
+                growable->resize(growable_origin + high_mark);
+                window = (std::byte*)growable->data() + growable_origin;
+                cursor = window + position;
+                window_end = window + high_mark;
+            }
+            return *this;
+        }
 
-    value& value::operator=(uint64_t set_value) {
-        return operator=(value(set_value));
-    }
+        std::size_t serialized_size(const value& val) {
+            return __impl__::serialized_size(val);
+        }
 
-    value& value::operator=(int64_t set_value) {
-        return operator=(value(set_value));
-    }
+        std::size_t serialized_value_size(const value& val) {
+            return __impl__::serialized_value_size(val);
+        }
 
-    value& value::operator=(float set_value) {
-        return operator=(value(set_value));
-    }
+        void write_compress_len(std::ostream& write_stream, std::uint64_t len) {
+            __impl__::write_compress_len(write_stream, len);
+        }
 
-    value& value::operator=(double set_value) {
-        return operator=(value(set_value));
-    }
+        void write_compress_len(output_sink& write_stream, std::uint64_t len) {
+            __impl__::write_compress_len(write_stream, len);
+        }
 
-    value& value::operator=(bool set_value) {
-        if (data_type_id.type == enbt::type::bit)
-            data_type_id.is_signed = set_value;
-        else
-            operator=(value(set_value));
-        return *this;
-    }
+        void write_type_id(std::ostream& write_stream, enbt::type_id tid) {
+            __impl__::write_type_id(write_stream, tid);
+        }
 
-    value& value::operator=(raw_uuid set_value) {
-        return operator=(value(set_value));
-    }
+        void write_type_id(output_sink& write_stream, enbt::type_id tid) {
+            __impl__::write_type_id(write_stream, tid);
+        }
 
-    value::operator bool() const {
-        return simpleIntConvert<bool>(content());
-    }
+        void write_string(std::ostream& write_stream, const value& val) {
+            __impl__::write_string(write_stream, val);
+        }
 
-    value::operator std::int8_t() const {
-        return simpleIntConvert<std::int8_t>(content());
-    }
+        void write_string(output_sink& write_stream, const value& val) {
+            __impl__::write_string(write_stream, val);
+        }
 
-    value::operator std::int16_t() const {
-        return simpleIntConvert<std::int16_t>(content());
-    }
+        void write_string(std::ostream& write_stream, std::string_view val) {
+            __impl__::write_string(write_stream, val);
+        }
 
-    value::operator std::int32_t() const {
-        return simpleIntConvert<std::int32_t>(content());
-    }
+        void write_string(output_sink& write_stream, std::string_view val) {
+            __impl__::write_string(write_stream, val);
+        }
 
-    value::operator std::int64_t() const {
-        return simpleIntConvert<std::int64_t>(content());
-    }
+        void write_define_len(std::ostream& write_stream, std::uint64_t len, enbt::type_id tid) {
+            __impl__::write_define_len(write_stream, len, tid);
+        }
 
-    value::operator std::uint8_t() const {
-        return simpleIntConvert<std::uint8_t>(content());
-    }
+        void write_define_len(output_sink& write_stream, std::uint64_t len, enbt::type_id tid) {
+            __impl__::write_define_len(write_stream, len, tid);
+        }
 
-    value::operator std::uint16_t() const {
-        return simpleIntConvert<std::uint16_t>(content());
-    }
+        void initialize_version(std::ostream& write_stream) {
+            __impl__::initialize_version(write_stream);
+        }
 
-    value::operator std::uint32_t() const {
-        return simpleIntConvert<std::uint32_t>(content());
-    }
+        void initialize_version(output_sink& write_stream) {
+            __impl__::initialize_version(write_stream);
+        }
 
-    value::operator std::uint64_t() const {
-        return simpleIntConvert<std::uint64_t>(content());
-    }
+        void write_compound(std::ostream& write_stream, const value& val) {
+            __impl__::write_compound(write_stream, val);
+        }
 
-    value::operator float() const {
-        return simpleIntConvert<float>(content());
-    }
+        void write_compound(output_sink& write_stream, const value& val) {
+            __impl__::write_compound(write_stream, val);
+        }
 
-    value::operator double() const {
-        return simpleIntConvert<double>(content());
-    }
+        void write_array(std::ostream& write_stream, const value& val) {
+            __impl__::write_array(write_stream, val);
+        }
 
-    value::operator std::string&() {
-        return *std::get<std::string*>(content());
-    }
+        void write_array(output_sink& write_stream, const value& val) {
+            __impl__::write_array(write_stream, val);
+        }
 
-    value::operator const std::string&() const {
-        return *std::get<std::string*>(content());
-    }
+        void write_darray(std::ostream& write_stream, const value& val) {
+            __impl__::write_darray(write_stream, val);
+        }
 
-    value::operator std::string() const {
-        return std::visit(
-            [](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, std::string*>)
-                    return *arg;
-                else if constexpr (std::is_same_v<T, bool>)
-                    return std::string(arg ? "true" : "false");
-                else if constexpr (std::is_integral_v<T>)
-                    return std::to_string(arg);
-                else if constexpr (std::is_same_v<T, std::uint8_t*>)
-                    return std::string((char*)arg);
-                else
-                    return std::string();
-            },
-            content()
-        );
-    }
+        void write_darray(output_sink& write_stream, const value& val) {
+            __impl__::write_darray(write_stream, val);
+        }
 
-    enbt::value value::cast_to(enbt::type_id id) const {
-        static auto convert_ = [](enbt::type_id id, const enbt::value& self) -> enbt::value {
-            switch (id.type) {
-            case type::none:
-                return enbt::value();
-            case type::integer:
-                switch (id.length) {
-                case type_len::Tiny:
-                    return id.is_signed ? value((int8_t)self) : value((uint8_t)self);
-                case type_len::Short:
-                    return id.is_signed ? value((int16_t)self) : value((uint16_t)self);
-                case type_len::Default:
-                    return id.is_signed ? value((int32_t)self) : value((uint32_t)self);
-                case type_len::Long:
-                    return id.is_signed ? value((int64_t)self) : value((uint64_t)self);
-                default:
-                    break;
-                }
-                break;
-            case type::var_integer:
-            case type::comp_integer:
-                switch (id.length) {
-                case type_len::Default: {
-                    enbt::value res(id.is_signed ? value((int32_t)self) : value((uint32_t)self));
-                    res.data_type_id.type = id.type;
-                    return res;
-                }
-                case type_len::Long: {
-                    enbt::value res(id.is_signed ? value((int64_t)self) : value((uint64_t)self));
-                    res.data_type_id.type = id.type;
-                    return res;
-                }
-                default:
-                    break;
-                }
-                break;
-            case type::floating:
-                switch (id.length) {
-                case type_len::Default:
-                    return (float)self;
-                case type_len::Long:
-                    return (double)self;
-                default:
-                    break;
-                }
-                break;
-            case type::string:
-                return (std::string)self;
-            default:
-                break;
-            }
-            throw enbt::exception("Can not convert to this type");
-        };
-        auto res = convert_(id, *this);
-        res.data_type_id.endian = id.endian;
-        return res;
-    }
+        void write_simple_array(std::ostream& write_stream, const value& val) {
+            __impl__::write_simple_array(write_stream, val);
+        }
 
-    value::operator const std::uint8_t*() const {
-        return std::get<std::uint8_t*>(content());
-    }
+        void write_simple_array(output_sink& write_stream, const value& val) {
+            __impl__::write_simple_array(write_stream, val);
+        }
 
-    value::operator const std::int8_t*() const {
-        return std::get<std::int8_t*>(content());
-    }
+        void write_log_item(std::ostream& write_stream, const value& val) {
+            __impl__::write_log_item(write_stream, val);
+        }
 
-    value::operator const char*() const {
-        return (char*)std::get<std::uint8_t*>(content());
-    }
+        void write_log_item(output_sink& write_stream, const value& val) {
+            __impl__::write_log_item(write_stream, val);
+        }
 
-    value::operator const std::int16_t*() const {
-        return std::get<std::int16_t*>(content());
-    }
+        void write_value(std::ostream& write_stream, const value& val) {
+            __impl__::write_value(write_stream, val);
+        }
 
-    value::operator const std::uint16_t*() const {
-        return std::get<std::uint16_t*>(content());
-    }
+        void write_value(output_sink& write_stream, const value& val) {
+            //one sizing pass is cheaper than regrowing the vector while encoding, a vector with room left is written directly
+            if (write_stream.resizable() && write_stream.capacity() < output_sink::staging_size && __impl__::worth_reserving(val))
+                write_stream.reserve(__impl__::serialized_value_size(val));
+            __impl__::write_value(write_stream, val);
+        }
+
+        void write_token(std::ostream& write_stream, const value& val) {
+            __impl__::write_token(write_stream, val);
+        }
+
+        void write_token(output_sink& write_stream, const value& val) {
+            if (write_stream.resizable() && write_stream.capacity() < output_sink::staging_size && __impl__::worth_reserving(val))
+                write_stream.reserve(__impl__::serialized_size(val));
+            __impl__::write_token(write_stream, val);
+        }
+
+        void write_compound(std::ostream& write_stream, const flat_compound& val) {
+            __impl__::write_compound(write_stream, val);
+        }
+
+        void write_compound(output_sink& write_stream, const flat_compound& val) {
+            __impl__::write_compound(write_stream, val);
+        }
+
+        void write_token(std::ostream& write_stream, const flat_compound& val) {
+            __impl__::write_token(write_stream, val);
+        }
+
+        void write_token(output_sink& write_stream, const flat_compound& val) {
+            __impl__::write_token(write_stream, val);
+        }
+
+        void write_array(std::ostream& write_stream, const bit_array_ref& val) {
+            __impl__::write_array(write_stream, val);
+        }
+
+        void write_array(output_sink& write_stream, const bit_array_ref& val) {
+            __impl__::write_array(write_stream, val);
+        }
+
+        void write_token(std::ostream& write_stream, const bit_array_ref& val) {
+            __impl__::write_token(write_stream, val);
+        }
+
+        void write_token(output_sink& write_stream, const bit_array_ref& val) {
+            __impl__::write_token(write_stream, val);
+        }
+
+        enbt::type_id read_type_id(std::istream& read_stream) {
+            return __impl__::read_type_id(read_stream);
+        }
+
+        enbt::type_id read_type_id(span_stream& read_stream) {
+            return __impl__::read_type_id(read_stream);
+        }
+
+        std::size_t read_define_len(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_define_len(read_stream, tid);
+        }
+
+        std::size_t read_define_len(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_define_len(read_stream, tid);
+        }
+
+        std::uint64_t read_define_len64(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_define_len64(read_stream, tid);
+        }
+
+        std::uint64_t read_define_len64(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_define_len64(read_stream, tid);
+        }
 
-    value::operator const std::int32_t*() const {
-        return std::get<std::int32_t*>(content());
-    }
+        std::uint64_t read_compress_len(std::istream& read_stream) {
+            return __impl__::read_compress_len(read_stream);
+        }
 
-    value::operator const std::uint32_t*() const {
-        return std::get<std::uint32_t*>(content());
-    }
+        std::uint64_t read_compress_len(span_stream& read_stream) {
+            return __impl__::read_compress_len(read_stream);
+        }
 
-    value::operator const std::int64_t*() const {
-        return std::get<std::int64_t*>(content());
-    }
+        void read_vars(std::istream& read_stream, std::uint64_t* values, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++)
+                values[i] = __impl__::read_var<std::uint64_t>(read_stream, std::endian::native);
+        }
 
-    value::operator const std::uint64_t*() const {
-        return std::get<std::uint64_t*>(content());
-    }
+        void read_vars(span_stream& read_stream, std::uint64_t* values, std::size_t count) {
+            auto rest = read_stream.data().subspan(read_stream.position());
+            read_stream.read_span(decode_vars((const std::uint8_t*)rest.data(), rest.size(), values, count));
+        }
 
-    value::operator std::unordered_map<std::string, value>() const {
-        if (is_compound())
-            return *(std::unordered_map<std::string, value>*)data;
-        throw std::invalid_argument("Invalid tid, cannot convert compound");
-    }
+        std::string read_string(std::istream& read_stream) {
+            return __impl__::read_string(read_stream);
+        }
 
-    value::operator raw_uuid() const {
-        if (is_string()) {
-            raw_uuid res;
-            raw_uuid::from_uuid_string(res, (const std::string&)*this);
-            return res;
-        } else
-            return std::get<raw_uuid>(content());
-    }
+        std::string read_string(span_stream& read_stream) {
+            return __impl__::read_string(read_stream);
+        }
 
-    value::operator std::optional<value>() const {
-        if (data_type_id.type == type::optional)
-            if (data_type_id.is_signed)
-                return std::optional<value>(*(const value*)data);
-            else
-                return std::nullopt;
-        else
-            return std::optional<value>(*this);
-    }
+        std::string_view read_string_view(span_stream& read_stream) {
+            std::uint64_t read = read_compress_len(read_stream);
+            auto bytes = read_stream.read_span(read);
+            return std::string_view((const char*)bytes.data(), bytes.size());
+        }
 
-    raw_uuid value::as_uuid() const {
-        return (raw_uuid) * this;
-    }
+        value read_compound(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_compound(read_stream, tid);
+        }
 
-    const std::string& value::as_string() const {
-        return (const std::string&)*this;
-    }
+        value read_compound(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_compound(read_stream, tid);
+        }
 
-    std::string& value::as_string() {
-        return (std::string&)*this;
-    }
+        enbt::key read_key(std::istream& read_stream, symbol_table& table) {
+            return __impl__::read_key(read_stream, table);
+        }
 
-    compound_ref value::as_compound() {
-        return compound::make_ref(*this);
-    }
+        enbt::key read_key(span_stream& read_stream, symbol_table& table) {
+            return __impl__::read_key(read_stream, table);
+        }
 
-    compound_const_ref value::as_compound() const {
-        return compound::make_ref(*this);
-    }
+        flat_compound read_flat_compound(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_flat_compound(read_stream, tid);
+        }
 
-    dynamic_array_ref value::as_array() {
-        return dynamic_array::make_ref(*this);
-    }
+        flat_compound read_flat_compound(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_flat_compound(read_stream, tid);
+        }
 
-    dynamic_array_ref value::as_array() const {
-        return dynamic_array::make_ref(*this);
-    }
+        bit_array read_bit_array(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_bit_array(read_stream, tid);
+        }
 
-    dynamic_array_ref value::as_dyn_array() {
-        return dynamic_array::make_ref(*this);
-    }
+        bit_array read_bit_array(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_bit_array(read_stream, tid);
+        }
 
-    dynamic_array_ref value::as_dyn_array() const {
-        return dynamic_array::make_ref(*this);
-    }
+        std::vector<value> read_array(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_array(read_stream, tid);
+        }
 
-    fixed_array_ref value::as_fixed_array() {
-        return fixed_array::make_ref(*this);
-    }
+        std::vector<value> read_array(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_array(read_stream, tid);
+        }
 
-    fixed_array_ref value::as_fixed_array() const {
-        return fixed_array::make_ref(*this);
-    }
+        std::vector<value> read_darray(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_darray(read_stream, tid);
+        }
 
-    simple_array_ref_ui8 value::as_ui8_array() {
-        return simple_array_ui8::make_ref(*this);
-    }
+        std::vector<value> read_darray(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_darray(read_stream, tid);
+        }
 
-    simple_array_const_ref_ui8 value::as_ui8_array() const {
-        return simple_array_ui8::make_ref(*this);
-    }
+        value read_sarray(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_sarray(read_stream, tid);
+        }
 
-    simple_array_ref_ui16 value::as_ui16_array() {
-        return simple_array_ui16::make_ref(*this);
-    }
+        value read_sarray(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_sarray(read_stream, tid);
+        }
 
-    simple_array_const_ref_ui16 value::as_ui16_array() const {
-        return simple_array_ui16::make_ref(*this);
-    }
+        value read_log_item(std::istream& read_stream) {
+            return __impl__::read_log_item(read_stream);
+        }
 
-    simple_array_ref_ui32 value::as_ui32_array() {
-        return simple_array_ui32::make_ref(*this);
-    }
+        value read_log_item(span_stream& read_stream) {
+            return __impl__::read_log_item(read_stream);
+        }
 
-    simple_array_const_ref_ui32 value::as_ui32_array() const {
-        return simple_array_ui32::make_ref(*this);
-    }
+        value read_value(std::istream& read_stream, enbt::type_id tid) {
+            return __impl__::read_value(read_stream, tid);
+        }
 
-    simple_array_ref_ui64 value::as_ui64_array() {
-        return simple_array_ui64::make_ref(*this);
-    }
+        value read_value(span_stream& read_stream, enbt::type_id tid) {
+            return __impl__::read_value(read_stream, tid);
+        }
 
-    simple_array_const_ref_ui64 value::as_ui64_array() const {
-        return simple_array_ui64::make_ref(*this);
-    }
+        value read_token(std::istream& read_stream) {
+            return __impl__::read_token(read_stream);
+        }
 
-    simple_array_ref_i8 value::as_i8_array() {
-        return simple_array_i8::make_ref(*this);
-    }
+        value read_token(span_stream& read_stream) {
+            return __impl__::read_token(read_stream);
+        }
 
-    simple_array_const_ref_i8 value::as_i8_array() const {
-        return simple_array_i8::make_ref(*this);
-    }
+        value read_file(std::istream& read_stream) {
+            return __impl__::read_file(read_stream);
+        }
 
-    simple_array_ref_i16 value::as_i16_array() {
-        return simple_array_i16::make_ref(*this);
-    }
+        value read_file(span_stream& read_stream) {
+            return __impl__::read_file(read_stream);
+        }
 
-    simple_array_const_ref_i16 value::as_i16_array() const {
-        return simple_array_i16::make_ref(*this);
-    }
+        std::vector<value> read_list_file(std::istream& read_stream) {
+            return __impl__::read_list_file(read_stream);
+        }
 
-    simple_array_ref_i32 value::as_i32_array() {
-        return simple_array_i32::make_ref(*this);
-    }
+        std::vector<value> read_list_file(span_stream& read_stream) {
+            return __impl__::read_list_file(read_stream);
+        }
 
-    simple_array_const_ref_i32 value::as_i32_array() const {
-        return simple_array_i32::make_ref(*this);
-    }
+        value read_token(std::istream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_token(read_stream);
+        }
 
-    simple_array_ref_i64 value::as_i64_array() {
-        return simple_array_i64::make_ref(*this);
-    }
+        value read_token(span_stream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_token(read_stream);
+        }
 
-    simple_array_const_ref_i64 value::as_i64_array() const {
-        return simple_array_i64::make_ref(*this);
-    }
+        value read_file(std::istream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_file(read_stream);
+        }
 
-    std::pair<std::string, value> value::copy_interator::operator*() const {
-        switch (iterate_type.type) {
-        case type::sarray:
-            if (iterate_type.is_signed) {
-                switch (iterate_type.length) {
-                case type_len::Tiny:
-                    return {"", value(*(std::int8_t*)pointer)};
-                    break;
-                case type_len::Short:
-                    return {"", value(*(std::int16_t*)pointer)};
-                    break;
-                case type_len::Default:
-                    return {"", value(*(std::int32_t*)pointer)};
-                    break;
-                case type_len::Long:
-                    return {"", value(*(std::int64_t*)pointer)};
-                    break;
-                default:
-                    throw enbt::exception();
-                }
-            } else {
-                switch (iterate_type.length) {
-                case type_len::Tiny:
-                    return {"", value(*(std::uint8_t*)pointer)};
-                    break;
-                case type_len::Short:
-                    return {"", value(*(std::uint16_t*)pointer)};
-                    break;
-                case type_len::Default:
-                    return {"", value(*(std::uint32_t*)pointer)};
-                    break;
-                case type_len::Long:
-                    return {"", value(*(std::uint64_t*)pointer)};
-                    break;
-                default:
-                    throw enbt::exception();
-                }
-            }
-        case type::array:
-        case type::darray:
-            return {"", value(*(*(std::vector<value>::iterator*)pointer))};
-        case type::compound: {
-            auto& tmp = (*(std::unordered_map<std::string, value>::iterator*)pointer);
-            return std::pair<std::string, value>(
-                tmp->first,
-                value(tmp->second)
-            );
+        value read_file(span_stream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_file(read_stream);
         }
-        default:
-            throw exception("Unreachable exception in non debug environment");
+
+        std::vector<value> read_list_file(std::istream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_list_file(read_stream);
         }
-    }
 
-    compound_ref compound_ref::merge(const value& copy) & {
-        merge_compounds(*proxy, *copy.as_compound().proxy);
-        return *this;
-    }
+        std::vector<value> read_list_file(span_stream& read_stream, std::pmr::memory_resource* resource) {
+            memory_scope scope(resource);
+            return __impl__::read_list_file(read_stream);
+        }
 
-    compound_ref compound_ref::merge(value&& move) & {
-        merge_compounds(*proxy, std::move(*move.as_compound().proxy));
-        return *this;
-    }
+        void check_version(std::istream& read_stream) {
+            __impl__::check_version(read_stream);
+        }
 
-    compound_ref compound_ref::merge(const std::unordered_map<std::string, value>& copy) & {
-        merge_compounds(*proxy, copy);
-        return *this;
-    }
+        void check_version(span_stream& read_stream) {
+            __impl__::check_version(read_stream);
+        }
 
-    compound_ref compound_ref::merge(std::unordered_map<std::string, value>&& move) & {
-        merge_compounds(*proxy, std::move(move));
-        return *this;
-    }
+        void skip_compound(std::istream& read_stream, enbt::type_id tid) {
+            __impl__::skip_compound(read_stream, tid);
+        }
 
-    compound compound::merge(const value& copy) && {
-        merge_compounds(*proxy, *copy.as_compound().proxy);
-        return std::move(*this);
-    }
+        void skip_compound(span_stream& read_stream, enbt::type_id tid) {
+            __impl__::skip_compound(read_stream, tid);
+        }
 
-    compound compound::merge(value&& copy) && {
-        merge_compounds(*proxy, std::move(*copy.as_compound().proxy));
-        return std::move(*this);
-    }
+        void skip_array(std::istream& read_stream, enbt::type_id tid) {
+            __impl__::skip_array(read_stream, tid);
+        }
 
-    compound compound::merge(const compound& copy) && {
-        merge_compounds(*proxy, *copy.proxy);
-        return std::move(*this);
-    }
+        void skip_array(span_stream& read_stream, enbt::type_id tid) {
+            __impl__::skip_array(read_stream, tid);
+        }
 
-    compound compound::merge(compound&& copy) && {
-        merge_compounds(*proxy, std::move(*copy.proxy));
-        return std::move(*this);
-    }
+        void skip_darray(std::istream& read_stream, enbt::type_id tid) {
+            __impl__::skip_darray(read_stream, tid);
+        }
 
-    compound compound::merge(const std::unordered_map<std::string, value>& copy) && {
-        merge_compounds(*proxy, copy);
-        return std::move(*this);
-    }
+        void skip_darray(span_stream& read_stream, enbt::type_id tid) {
+            __impl__::skip_darray(read_stream, tid);
+        }
 
-    compound compound::merge(std::unordered_map<std::string, value>&& copy) && {
-        merge_compounds(*proxy, std::move(copy));
-        return std::move(*this);
-    }
+        void skip_sarray(std::istream& read_stream, enbt::type_id tid) {
+            __impl__::skip_sarray(read_stream, tid);
+        }
 
-    namespace io_helper {
-        namespace __impl__ {
-            template <class T>
-            T _read_as_(std::istream& input_stream) {
-                T res;
-                input_stream.read((char*)&res, sizeof(T));
-                return res;
-            }
+        void skip_sarray(span_stream& read_stream, enbt::type_id tid) {
+            __impl__::skip_sarray(read_stream, tid);
+        }
+
+        void skip_string(std::istream& read_stream) {
+            __impl__::skip_string(read_stream);
         }
 
-        template <class T>
-        T read_var(std::istream& read_stream, std::endian endian) {
-            static constexpr size_t max_offset = (sizeof(T) / 5 * 5 + ((sizeof(T) % 5) > 0)) * 8;
-            std::make_unsigned_t<T> decoded_int = 0;
-            size_t bit_offset = 0;
-            char current_byte = 0;
-            do {
-                if (bit_offset == max_offset)
-                    throw enbt::exception("var value too big");
-                current_byte = __impl__::_read_as_<char>(read_stream);
-                decoded_int |= T(current_byte & 0b01111111) << bit_offset;
-                bit_offset += 7;
-            } while ((current_byte & 0b10000000) != 0);
-            if constexpr (std::is_signed_v<T>)
-                return endian_helpers::convert_endian(endian, (T)((decoded_int >> 1) ^ -T(decoded_int & 1)));
-            else
-                return endian_helpers::convert_endian(endian, decoded_int);
+        void skip_string(span_stream& read_stream) {
+            __impl__::skip_string(read_stream);
         }
 
-        template <class T>
-        T read_value(std::istream& read_stream, std::endian endian = std::endian::native) {
-            T tmp;
-            if constexpr (std::is_same<T, enbt::raw_uuid>()) {
-                read_stream.read((char*)tmp.data, 16);
-                endian_helpers::convert_endian(endian, tmp.data, 16);
-            } else {
-                read_stream.read((char*)&tmp, sizeof(T));
-                endian_helpers::convert_endian(endian, tmp);
-            }
-            return tmp;
+        void skip_log_item(std::istream& read_stream) {
+            __impl__::skip_log_item(read_stream);
         }
 
-        template <class T>
-        T* read_array(std::istream& read_stream, std::size_t len, std::endian endian = std::endian::native) {
-            T* tmp = new T[len];
-            if constexpr (sizeof(T) == 1)
-                read_stream.read((char*)tmp, len);
-            else {
-                read_stream.read((char*)tmp, len * sizeof(T));
-                endian_helpers::convert_endian(endian, tmp, len);
-            }
-            return tmp;
+        void skip_log_item(span_stream& read_stream) {
+            __impl__::skip_log_item(read_stream);
         }
 
-        void write_compress_len(std::ostream& write_stream, std::uint64_t len) {
-            constexpr struct {
-                std::uint64_t b62 : 62 = 0x3FFF'FFFF'FFFF'FFFF;
-                std::uint64_t b30 : 30 = 0x3FFF'FFFF;
-                std::uint64_t b14 : 14 = 0x3FFF;
-                std::uint64_t b6 : 6 = 0x3F;
-            } m;
-
-            if (len <= m.b6) {
-                write_stream << static_cast<std::uint8_t>(len & m.b6);
-            } else if (len <= m.b14) {
-                std::uint16_t val = static_cast<std::uint16_t>(len);
-                write_stream << std::uint8_t((val & m.b6) | (1 << 6));
-                write_stream << std::uint8_t((val >> 6) & 0xFF);
-            } else if (len <= m.b30) {
-                std::uint32_t val = static_cast<std::uint32_t>(len);
-                write_stream << std::uint8_t((val & m.b6) | (2 << 6));
-                write_stream << std::uint8_t((val >> 6) & 0xFF);
-                write_stream << std::uint8_t((val >> 14) & 0xFF);
-                write_stream << std::uint8_t((val >> 22) & 0xFF);
-            } else if (len <= m.b62) {
-                write_stream << std::uint8_t((len & m.b6) | (3 << 6));
-                write_stream << std::uint8_t((len >> 6) & 0xFF);
-                write_stream << std::uint8_t((len >> 14) & 0xFF);
-                write_stream << std::uint8_t((len >> 22) & 0xFF);
-                write_stream << std::uint8_t((len >> 30) & 0xFF);
-                write_stream << std::uint8_t((len >> 38) & 0xFF);
-                write_stream << std::uint8_t((len >> 46) & 0xFF);
-                write_stream << std::uint8_t((len >> 54) & 0xFF);
-            } else {
-                throw std::overflow_error("uint64_t cannot be converted to uint62_t without losing data");
-            }
+        void skip_value(std::istream& read_stream, enbt::type_id tid) {
+            __impl__::skip_value(read_stream, tid);
         }
 
-        template <class t>
-        void write_var(std::ostream& write_stream, t value, std::endian endian = std::endian::native) {
-            constexpr size_t sign_bit_offset = sizeof(t) * 8 - 1;
-            constexpr t least_bits = ~t(0x7f);
+        void skip_value(span_stream& read_stream, enbt::type_id tid) {
+            __impl__::skip_value(read_stream, tid);
+        }
 
-            value = endian_helpers::convert_endian(endian, value);
-            if constexpr (std::is_signed_v<t>)
-                value = ((value) << 1) ^ ((value) >> sign_bit_offset);
-            while (value & least_bits) {
-                write_stream << (uint8_t(value) | 0x80);
-                value >>= 7;
-            }
-            write_stream << uint8_t(value);
+        void skip_token(std::istream& read_stream) {
+            __impl__::skip_token(read_stream);
         }
 
-        template <class t>
-        void write_var(std::ostream& write_stream, value::value_variants value, std::endian endian = std::endian::native) {
-            write_var(write_stream, std::get<t>(value), endian);
+        void skip_token(span_stream& read_stream) {
+            __impl__::skip_token(read_stream);
         }
 
-        void write_type_id(std::ostream& write_stream, enbt::type_id tid) {
-            union combined_t {
-                enbt::type_id id;
-                std::uint8_t raw;
-            } combined{.id = tid};
+        bool find_value_compound(std::istream& read_stream, enbt::type_id tid, std::string_view key) {
+            return __impl__::find_value_compound(read_stream, tid, key);
+        }
 
-            write_stream << combined.raw;
+        bool find_value_compound(span_stream& read_stream, enbt::type_id tid, std::string_view key) {
+            return __impl__::find_value_compound(read_stream, tid, key);
         }
 
-        template <class t>
-        void write_value(std::ostream& write_stream, t value, std::endian endian = std::endian::native) {
-            if constexpr (std::is_same<t, enbt::raw_uuid>())
-                endian_helpers::convert_endian(endian, value.data, 16);
-            else
-                value = endian_helpers::convert_endian(endian, value);
-            write_stream.write((char*)&value, sizeof(t));
+        void index_static_array(std::istream& read_stream, std::uint64_t index, std::uint64_t len, enbt::type_id target_id) {
+            __impl__::index_static_array(read_stream, index, len, target_id);
         }
 
-        template <class t>
-        void write_value(std::ostream& write_stream, value::value_variants value, std::endian endian = std::endian::native) {
-            return write_value(write_stream, std::get<t>(value), endian);
+        void index_static_array(span_stream& read_stream, std::uint64_t index, std::uint64_t len, enbt::type_id target_id) {
+            __impl__::index_static_array(read_stream, index, len, target_id);
         }
 
-        template <class t>
-        void write_array(std::ostream& write_stream, t* values, std::size_t len, std::endian endian = std::endian::native) {
-            if constexpr (sizeof(t) == 1) {
-                write_stream.write((const char*)values, len);
-            } else if constexpr (std::is_const_v<t>) {
-                std::vector<std::decay_t<t>> tmp(values, values + len);
-                endian_helpers::convert_endian(endian, tmp.data(), tmp.size());
-                write_stream.write((const char*)tmp.data(), tmp.size() * sizeof(t));
-            } else {
-                endian_helpers::convert_endian(endian, values, len);
-                write_stream.write((const char*)values, len * sizeof(t));
-                endian_helpers::convert_endian(endian, values, len);
-            }
+        void index_dyn_array(std::istream& read_stream, std::uint64_t index, std::uint64_t len) {
+            __impl__::index_dyn_array(read_stream, index, len);
         }
 
-        template <class t>
-        void write_array(std::ostream& write_stream, value::value_variants* values, std::size_t len, std::endian endian = std::endian::native) {
-            std::vector<t> arr(len);
-            for (std::size_t i = 0; i < len; i++)
-                arr[i] = std::get<t>(values[i]);
-            write_array(write_stream, arr.data(), len, endian);
+        void index_dyn_array(span_stream& read_stream, std::uint64_t index, std::uint64_t len) {
+            __impl__::index_dyn_array(read_stream, index, len);
         }
 
-        void write_string(std::ostream& write_stream, const value& val) {
-            const std::string& str_ref = (const std::string&)val;
-            std::size_t real_size = str_ref.size();
-            std::size_t size_without_null = real_size ? (str_ref[real_size - 1] != 0 ? real_size : real_size - 1) : 0;
-            write_compress_len(write_stream, size_without_null);
-            write_array(write_stream, str_ref.data(), size_without_null);
+        std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index, enbt::type_id arr_tid) {
+            return __impl__::index_array(read_stream, index, arr_tid);
         }
 
-        void write_string(std::ostream& write_stream, std::string_view val) {
-            std::size_t real_size = val.size();
-            std::size_t size_without_null = real_size ? (val[real_size - 1] != 0 ? real_size : real_size - 1) : 0;
-            write_compress_len(write_stream, size_without_null);
-            write_array(write_stream, val.data(), size_without_null);
+        std::optional<enbt::type_id> index_array(span_stream& read_stream, std::uint64_t index, enbt::type_id arr_tid) {
+            return __impl__::index_array(read_stream, index, arr_tid);
         }
 
-        template <class t>
-        void write_define_len(std::ostream& write_stream, t value) {
-            return write_value(write_stream, value, std::endian::little);
+        std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index) {
+            return __impl__::index_array(read_stream, index);
         }
 
-        void write_define_len(std::ostream& write_stream, std::uint64_t len, enbt::type_id tid) {
-            switch (tid.length) {
-            case enbt::type_len::Tiny:
-                if (len != ((std::uint8_t)len))
-                    throw enbt::exception("cannot convert value to std::uint8_t");
-                write_define_len(write_stream, (std::uint8_t)len);
-                break;
-            case enbt::type_len::Short:
-                if (len != ((std::uint16_t)len))
-                    throw enbt::exception("cannot convert value to std::uint16_t");
-                write_define_len(write_stream, (std::uint16_t)len);
-                break;
-            case enbt::type_len::Default:
-                if (len != ((std::uint32_t)len))
-                    throw enbt::exception("cannot convert value to std::uint32_t");
-                write_define_len(write_stream, (std::uint32_t)len);
-                break;
-            case enbt::type_len::Long:
-                return write_define_len(write_stream, (std::uint64_t)len);
-                break;
-            }
+        std::optional<enbt::type_id> index_array(span_stream& read_stream, std::uint64_t index) {
+            return __impl__::index_array(read_stream, index);
         }
 
-        void initialize_version(std::ostream& write_stream) {
-            write_stream << (char)ENBT_VERSION_HEX;
+        std::optional<enbt::type_id> move_to_value_path(std::istream& read_stream, const value_path& value_path) {
+            return __impl__::move_to_value_path(read_stream, value_path);
         }
 
-        void write_compound(std::ostream& write_stream, const value& val) {
-            auto result = std::get<std::unordered_map<std::string, value>*>(val.content());
-            write_define_len(write_stream, result->size(), val.type_id());
-            for (auto& it : *result) {
-                write_string(write_stream, it.first);
-                write_token(write_stream, it.second);
-            }
+        std::optional<enbt::type_id> move_to_value_path(span_stream& read_stream, const value_path& value_path) {
+            return __impl__::move_to_value_path(read_stream, value_path);
         }
 
-        void write_array(std::ostream& write_stream, const value& val) {
-            if (!val.is_array())
-                throw enbt::exception("this is not array for serialize it");
-            auto result = (const std::vector<value>*)val.get_internal_ptr();
-            std::size_t len = result->size();
-            write_define_len(write_stream, len, val.type_id());
-            if (len) {
-                enbt::type_id tid = (*result)[0].type_id();
-                write_type_id(write_stream, tid);
-                if (tid.type != enbt::type::bit) {
-                    for (const auto& it : *result)
-                        write_value(write_stream, it);
-                } else {
-                    tid.is_signed = false;
-                    std::int8_t i = 0;
-                    std::uint8_t value = 0;
-                    for (auto& it : *result) {
-                        if (i >= 8) {
-                            i = 0;
-                            write_stream << value;
-                        }
-                        if (i)
-                            value = (((bool)it) << i);
-                        else
-                            value = (bool)it;
-                    }
-                    if (i)
-                        write_stream << value;
-                }
-            }
+        std::optional<enbt::type_id> move_to_value_path(std::istream& read_stream, const value_path& value_path, enbt::type_id current_id) {
+            return __impl__::move_to_value_path(read_stream, value_path, current_id);
         }
 
-        void write_darray(std::ostream& write_stream, const value& val) {
-            if (!val.is_array())
-                throw enbt::exception("this is not array for serialize it");
-            auto result = (const std::vector<value>*)val.get_internal_ptr();
-            write_define_len(write_stream, result->size(), val.type_id());
-            for (auto& it : *result)
-                write_token(write_stream, it);
+        std::optional<enbt::type_id> move_to_value_path(span_stream& read_stream, const value_path& value_path, enbt::type_id current_id) {
+            return __impl__::move_to_value_path(read_stream, value_path, current_id);
         }
 
-        void write_simple_array(std::ostream& write_stream, const value& val) {
-            write_compress_len(write_stream, val.size());
-            switch (val.type_id().length) {
-            case enbt::type_len::Tiny:
-                write_array(write_stream, val.get_internal_ptr(), val.size());
-                break;
-            case enbt::type_len::Short:
-                if (val.type_id().is_signed)
-                    write_array(write_stream, (const std::uint16_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
-                else
-                    write_array(write_stream, (const std::uint16_t*)val.get_internal_ptr(), val.size());
-                break;
-            case enbt::type_len::Default:
-                if (val.type_id().is_signed)
-                    write_array(write_stream, (const std::uint32_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
-                else
-                    write_array(write_stream, (const std::uint32_t*)val.get_internal_ptr(), val.size());
-                break;
-            case enbt::type_len::Long:
-                if (val.type_id().is_signed)
-                    write_array(write_stream, (const std::uint64_t*)val.get_internal_ptr(), val.size(), val.type_id().get_endian());
-                else
-                    write_array(write_stream, (const std::uint64_t*)val.get_internal_ptr(), val.size());
-                break;
-            default:
-                break;
-            }
+        value get_value_path(std::istream& read_stream, const value_path& value_path) {
+            return __impl__::get_value_path(read_stream, value_path);
         }
 
-        void write_log_item(std::ostream& write_stream, const value& val) {
-            std::stringstream ss;
-            ss << std::ios::binary;
-            write_token(ss, val);
-            write_compress_len(write_stream, ss.view().size());
-            write_array(write_stream, (const uint8_t*)ss.view().data(), ss.view().size());
+        value get_value_path(span_stream& read_stream, const value_path& value_path) {
+            return __impl__::get_value_path(read_stream, value_path);
         }
 
-        void write_value(std::ostream& write_stream, const value& val) {
-            enbt::type_id tid = val.type_id();
+        std::uint8_t can_fast_index(enbt::type_id tid) {
             switch (tid.type) {
-            case enbt::type::none:
-            case enbt::type::bit:
-                return;
             case enbt::type::integer:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    if (tid.is_signed)
-                        return write_value<std::int8_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_value<std::uint8_t>(write_stream, val.content(), tid.get_endian());
-                case enbt::type_len::Short:
-                    if (tid.is_signed)
-                        return write_value<std::int16_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_value<std::uint16_t>(write_stream, val.content(), tid.get_endian());
-                case enbt::type_len::Default:
-                    if (tid.is_signed)
-                        return write_value<std::int32_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_value<std::uint32_t>(write_stream, val.content(), tid.get_endian());
-                case enbt::type_len::Long:
-                    if (tid.is_signed)
-                        return write_value<std::int64_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_value<std::uint64_t>(write_stream, val.content(), tid.get_endian());
-                }
-                return;
             case enbt::type::floating:
                 switch (tid.length) {
                 case enbt::type_len::Tiny:
+                    return 1;
                 case enbt::type_len::Short:
-                    throw enbt::exception("not implemented");
-                case enbt::type_len::Default:
-                    return write_value<float>(write_stream, val.content(), tid.get_endian());
-                case enbt::type_len::Long:
-                    return write_value<double>(write_stream, val.content(), tid.get_endian());
-                }
-                return;
-            case enbt::type::var_integer:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                case enbt::type_len::Short:
-                    throw enbt::exception("not implemented");
+                    return 2;
                 case enbt::type_len::Default:
-                    if (tid.is_signed)
-                        return write_var<std::int32_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_var<std::uint32_t>(write_stream, val.content(), tid.get_endian());
+                    return 4;
                 case enbt::type_len::Long:
-                    if (tid.is_signed)
-                        return write_var<std::int64_t>(write_stream, val.content(), tid.get_endian());
-                    else
-                        return write_var<std::uint64_t>(write_stream, val.content(), tid.get_endian());
+                    return 8;
                 }
-                return;
-            case enbt::type::comp_integer:
-                return write_compress_len(write_stream, (uint64_t)val);
+                return 0;
             case enbt::type::uuid:
-                return write_value<enbt::raw_uuid>(write_stream, val.content(), tid.get_endian());
-            case enbt::type::sarray:
-                return write_simple_array(write_stream, val);
-            case enbt::type::darray:
-                return write_darray(write_stream, val);
-            case enbt::type::compound:
-                return write_compound(write_stream, val);
-            case enbt::type::array:
-                return write_array(write_stream, val);
-            case enbt::type::optional:
-                if (val.contains())
-                    write_token(write_stream, *val.get_optional());
-                break;
-            case enbt::type::string:
-                return write_string(write_stream, val);
-            case enbt::type::log_item: {
-                return write_log_item(write_stream, val);
-            }
+                return 16;
+            case enbt::type::bit:
+                return 1;
+            default:
+                return 0;
             }
         }
 
-        void write_token(std::ostream& write_stream, const value& val) {
-            union combined_t {
-                enbt::type_id id;
-                std::uint8_t raw;
-            } combined{.id = val.type_id()};
-
-            write_stream << combined.raw;
-            write_value(write_stream, val);
+        value_path::index::operator std::string() const {
+            if (std::holds_alternative<std::string>(value))
+                return std::get<std::string>(value);
+            else
+                return std::to_string(std::get<std::uint64_t>(value));
         }
 
-        enbt::type_id read_type_id(std::istream& read_stream) {
-            union combined_t {
-                enbt::type_id id;
-                std::uint8_t raw;
-            } combined{.raw = __impl__::_read_as_<std::uint8_t>(read_stream)};
-
-            return combined.id;
+        value_path::index::operator std::uint64_t() const {
+            if (std::holds_alternative<std::string>(value))
+                return std::stoull(std::get<std::string>(value));
+            else
+                return std::get<std::uint64_t>(value);
         }
 
-        template <class T>
-        T read_define_len(std::istream& read_stream) {
-            return read_value<T>(read_stream, std::endian::little);
+        value_path::value_path(std::string_view stringized_path) {
+            for (std::size_t pos; (pos = stringized_path.find('.')) != std::string_view::npos; stringized_path.remove_prefix(pos + 1))
+                path.emplace_back(std::string(stringized_path.substr(0, pos)));
+            path.emplace_back(std::string(stringized_path));
         }
 
-        std::size_t read_define_len(std::istream& read_stream, enbt::type_id tid) {
-            switch (tid.length) {
-            case enbt::type_len::Tiny:
-                return read_define_len<std::uint8_t>(read_stream);
-            case enbt::type_len::Short:
-                return read_define_len<std::uint16_t>(read_stream);
-            case enbt::type_len::Default:
-                return read_define_len<std::uint32_t>(read_stream);
-            case enbt::type_len::Long: {
-                std::uint64_t val = read_define_len<std::uint64_t>(read_stream);
-                if ((std::size_t)val != val)
-                    throw std::overflow_error("array length too big for this platform");
-                return val;
-            }
-            default:
-                return 0;
-            }
-        }
+        value_path::value_path(const std::vector<index>& copy)
+            : path(copy) {}
 
-        std::uint64_t read_define_len64(std::istream& read_stream, enbt::type_id tid) {
-            switch (tid.length) {
-            case enbt::type_len::Tiny:
-                return read_define_len<std::uint8_t>(read_stream);
-            case enbt::type_len::Short:
-                return read_define_len<std::uint16_t>(read_stream);
-            case enbt::type_len::Default:
-                return read_define_len<std::uint32_t>(read_stream);
-            case enbt::type_len::Long:
-                return read_define_len<std::uint64_t>(read_stream);
-            default:
-                return 0;
-            }
-        }
+        value_path::value_path(std::vector<index>&& move)
+            : path(std::move(move)) {}
 
-        std::uint64_t read_compress_len(std::istream& read_stream) {
-            union {
-                std::uint8_t complete = 0;
-
-                struct {
-                    std::uint8_t len : 6;
-                    std::uint8_t len_flag : 2;
-                } partial;
-            } b;
-
-            read_stream.read((char*)&b.complete, 1);
-            switch (b.partial.len_flag) {
-            case 0:
-                return b.partial.len;
-            case 1: {
-                std::uint16_t full = b.partial.len;
-                full |= std::uint16_t(__impl__::_read_as_<std::uint8_t>(read_stream)) << 6;
-                return endian_helpers::convert_endian(std::endian::little, full);
-            }
-            case 2: {
-                std::uint32_t full = b.partial.len;
-                std::uint8_t buf[3];
-                read_stream.read((char*)buf, 3);
-                full |= std::uint32_t(buf[2]) << 6;
-                full |= std::uint32_t(buf[1]) << 14;
-                full |= std::uint32_t(buf[0]) << 22;
-                return endian_helpers::convert_endian(std::endian::little, full);
-            }
-            case 3: {
-                std::uint64_t full = b.partial.len;
-                std::uint8_t buf[7];
-                read_stream.read((char*)buf, 7);
-                full |= std::uint64_t(buf[6]) << 6;
-                full |= std::uint64_t(buf[5]) << 14;
-                full |= std::uint64_t(buf[4]) << 22;
-                full |= std::uint64_t(buf[3]) << 30;
-                full |= std::uint64_t(buf[2]) << 38;
-                full |= std::uint64_t(buf[1]) << 46;
-                full |= std::uint64_t(buf[0]) << 54;
-                return endian_helpers::convert_endian(std::endian::little, full);
-            }
-            default:
-                return 0;
-            }
-        }
+        value_path::value_path(const value_path& copy)
+            : path(copy.path) {}
 
-        std::string read_string(std::istream& read_stream) {
-            std::uint64_t read = read_compress_len(read_stream);
-            std::string res;
-            res.resize(read);
-            read_stream.read(res.data(), read);
-            return res;
-        }
+        value_path::value_path(value_path&& move) noexcept
+            : path(std::move(move.path)) {}
 
-        value read_compound(std::istream& read_stream, enbt::type_id tid) {
-            std::size_t len = read_define_len(read_stream, tid);
-            std::unordered_map<std::string, value> result;
-            result.reserve(len);
-            for (std::size_t i = 0; i < len; i++) {
-                std::string key = read_string(read_stream);
-                result[key] = read_token(read_stream);
-            }
-            return result;
+        value_path&& value_path::operator[](std::string_view index) {
+            path.emplace_back((std::string)index);
+            return std::move(*this);
         }
 
-        std::vector<value> read_array(std::istream& read_stream, enbt::type_id tid) {
-            std::size_t len = read_define_len(read_stream, tid);
-            if (!len)
-                return {};
-            enbt::type_id a_tid = read_type_id(read_stream);
-            std::vector<value> result(len);
-            if (a_tid == enbt::type::bit) {
-                std::int8_t i = 0;
-                std::uint8_t value = __impl__::_read_as_<std::uint8_t>(read_stream);
-                for (auto& it : result) {
-                    if (i >= 8) {
-                        i = 0;
-                        value = __impl__::_read_as_<std::uint8_t>(read_stream);
-                    }
-                    it = (bool)(value & (1 << i));
-                }
-            } else {
-                for (std::size_t i = 0; i < len; i++)
-                    result[i] = read_value(read_stream, a_tid);
-            }
-            return result;
+        value_path&& value_path::operator[](std::uint64_t index) {
+            path.emplace_back(index);
+            return std::move(*this);
         }
 
-        std::vector<value> read_darray(std::istream& read_stream, enbt::type_id tid) {
-            std::size_t len = read_define_len(read_stream, tid);
-            std::vector<value> result(len);
-            for (std::size_t i = 0; i < len; i++)
-                result[i] = read_token(read_stream);
-            return result;
+        value_path_set::value_path_set()
+            : nodes(1) {}
+
+        value_path_set::value_path_set(std::initializer_list<value_path> paths)
+            : nodes(1) {
+            for (auto& path : paths)
+                add(path);
         }
 
-        value read_sarray(std::istream& read_stream, enbt::type_id tid) {
-            std::uint64_t len = read_compress_len(read_stream);
-            auto endian = tid.get_endian();
-            switch (tid.length) {
-            case enbt::type_len::Tiny: {
-                std::uint8_t* arr = read_array<std::uint8_t>(read_stream, len, endian);
-                return enbt::value::build_inline(arr, len, tid);
-            }
-            case enbt::type_len::Short: {
-                std::uint16_t* arr = read_array<std::uint16_t>(read_stream, len, endian);
-                return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
-            }
-            case enbt::type_len::Default: {
-                std::uint32_t* arr = read_array<std::uint32_t>(read_stream, len, endian);
-                return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
-            }
-            case enbt::type_len::Long: {
-                std::uint64_t* arr = read_array<std::uint64_t>(read_stream, len, endian);
-                return enbt::value::build_inline((std::uint8_t*)arr, len, tid);
+        std::size_t value_path_set::add(const value_path& path) {
+            std::uint32_t at = 0;
+            for (auto& index : path.path) {
+                std::string name = index;
+                auto& keys = nodes[at].keys;
+                auto it = std::lower_bound(keys.begin(), keys.end(), name, [](auto& item, const std::string& name) { return item.first < name; });
+                if (it != keys.end() && it->first == name) {
+                    at = it->second;
+                    continue;
+                }
+                std::uint32_t child = std::uint32_t(nodes.size());
+                std::optional<std::uint64_t> number;
+                if (std::holds_alternative<std::uint64_t>(index.value))
+                    number = std::get<std::uint64_t>(index.value);
+                else {
+                    std::uint64_t parsed;
+                    auto [end, error] = std::from_chars(name.data(), name.data() + name.size(), parsed);
+                    if (!name.empty() && error == std::errc() && end == name.data() + name.size())
+                        number = parsed;
+                }
+                keys.emplace(it, std::move(name), child);
+                if (number) {
+                    auto& indexes = nodes[at].indexes;
+                    indexes.emplace(std::lower_bound(indexes.begin(), indexes.end(), *number, [](auto& item, std::uint64_t number) { return item.first < number; }), *number, child);
+                }
+                nodes.emplace_back();
+                at = child;
             }
-            default:
-                throw enbt::exception();
+            nodes[at].results.push_back(paths);
+            return paths++;
+        }
+
+        void value_path_set::resolve_node(const value& val, std::uint32_t at, std::vector<std::optional<value>>& results) const {
+            const node& current = nodes[at];
+            for (std::size_t result : current.results)
+                results[result] = val;
+            if (val.is_compound()) {
+                for (auto& [name, child] : current.keys)
+                    if (val.contains(name))
+                        resolve_node(val.at(name), child, results);
+            } else if (val.is_array()) {
+                for (auto& [index, child] : current.indexes)
+                    if (index < val.size())
+                        resolve_node(val[(std::size_t)index], child, results);
             }
         }
 
-        value read_log_item(std::istream& read_stream) {
-            read_compress_len(read_stream);
-            return read_token(read_stream);
-        }
-
-        value read_value(std::istream& read_stream, enbt::type_id tid) {
+        template <class Stream>
+        void value_path_set::extract_node(Stream& read_stream, std::uint32_t at, enbt::type_id tid, std::vector<std::optional<value>>& results, std::string& scratch) const {
+            const node& current = nodes[at];
+            if (!current.results.empty()) {
+                value val = __impl__::read_value(read_stream, tid);
+                if (current.results.size() == 1 && current.keys.empty())
+                    results[current.results[0]] = std::move(val);
+                else
+                    resolve_node(val, at, results);
+                return;
+            }
             switch (tid.type) {
-            case enbt::type::integer:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    if (tid.is_signed)
-                        return read_value<std::int8_t>(read_stream, tid.get_endian());
-                    else
-                        return read_value<std::uint8_t>(read_stream, tid.get_endian());
-                case enbt::type_len::Short:
-                    if (tid.is_signed)
-                        return read_value<std::int16_t>(read_stream, tid.get_endian());
-                    else
-                        return read_value<std::uint16_t>(read_stream, tid.get_endian());
-                case enbt::type_len::Default:
-                    if (tid.is_signed)
-                        return read_value<std::int32_t>(read_stream, tid.get_endian());
-                    else
-                        return read_value<std::uint32_t>(read_stream, tid.get_endian());
-                case enbt::type_len::Long:
-                    if (tid.is_signed)
-                        return read_value<std::int64_t>(read_stream, tid.get_endian());
-                    else
-                        return read_value<std::uint64_t>(read_stream, tid.get_endian());
-                default:
-                    return value();
+            case enbt::type::compound: {
+                std::size_t len = __impl__::read_define_len(read_stream, tid);
+                std::size_t left = current.keys.size();
+                for (std::size_t i = 0; i < len; i++) {
+                    if (!left) {
+                        __impl__::skip_string(read_stream);
+                        __impl__::skip_token(read_stream);
+                        continue;
+                    }
+                    std::string_view name = __impl__::read_string_view(read_stream, scratch);
+                    auto it = std::lower_bound(current.keys.begin(), current.keys.end(), name, [](auto& item, std::string_view name) { return item.first < name; });
+                    auto item_tid = __impl__::read_type_id(read_stream);
+                    if (it != current.keys.end() && it->first == name) {
+                        --left;
+                        extract_node(read_stream, it->second, item_tid, results, scratch);
+                    } else
+                        __impl__::skip_value(read_stream, item_tid);
                 }
-            case enbt::type::floating:
-                switch (tid.length) {
-                case enbt::type_len::Default:
-                    return read_value<float>(read_stream, tid.get_endian());
-                case enbt::type_len::Long:
-                    return read_value<double>(read_stream, tid.get_endian());
-                default:
-                    return value();
+                return;
+            }
+            case enbt::type::array: {
+                std::uint64_t len = __impl__::read_define_len64(read_stream, tid);
+                if (!len)
+                    return;
+                auto items_tid = __impl__::read_type_id(read_stream);
+                std::uint8_t item_size = can_fast_index(items_tid);
+                if (items_tid.type == enbt::type::bit) {
+                    auto begin = read_stream.tellg();
+                    for (auto& [index, child] : current.indexes) {
+                        if (index >= len)
+                            break;
+                        read_stream.seekg(begin + std::streamoff(index / 8));
+                        resolve_node(value(bool(__impl__::_read_as_<std::uint8_t>(read_stream) & (1 << (index % 8)))), child, results);
+                    }
+                    read_stream.seekg(begin + std::streamoff((len + 7) / 8));
+                    return;
                 }
-            case enbt::type::var_integer:
-                switch (tid.length) {
-                case enbt::type_len::Default:
-                    if (tid.is_signed)
-                        return read_var<std::int32_t>(read_stream, tid.get_endian());
-                    else
-                        return read_var<std::uint32_t>(read_stream, tid.get_endian());
-                case enbt::type_len::Long:
-                    if (tid.is_signed)
-                        return read_var<std::int64_t>(read_stream, tid.get_endian());
+                std::uint64_t position = 0;
+                auto skip_to = [&](std::uint64_t index) {
+                    if (item_size)
+                        read_stream.seekg(read_stream.tellg() += std::streamoff((index - position) * item_size));
                     else
-                        return read_var<std::uint64_t>(read_stream, tid.get_endian());
-                default:
-                    return value();
+                        for (; position < index; position++)
+                            __impl__::skip_value(read_stream, items_tid);
+                    position = index;
+                };
+                for (auto& [index, child] : current.indexes) {
+                    if (index >= len)
+                        break;
+                    skip_to(index);
+                    extract_node(read_stream, child, items_tid, results, scratch);
+                    ++position;
                 }
-            case enbt::type::comp_integer: {
-                std::uint64_t val = read_compress_len(read_stream);
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    if (val != ((std::uint8_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    return value((std::uint8_t)val);
-                case enbt::type_len::Short:
-                    if (val != ((std::uint16_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    return value((std::uint16_t)val);
-                case enbt::type_len::Default:
-                    if (val != ((std::uint32_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    return value((std::uint32_t)val);
-                case enbt::type_len::Long:
-                    return value(val);
-                default:
-                    return value();
+                skip_to(len);
+                return;
+            }
+            case enbt::type::darray: {
+                std::uint64_t len = __impl__::read_define_len64(read_stream, tid);
+                auto index = current.indexes.begin();
+                for (std::uint64_t i = 0; i < len; i++) {
+                    if (index != current.indexes.end() && index->first == i)
+                        extract_node(read_stream, (index++)->second, __impl__::read_type_id(read_stream), results, scratch);
+                    else
+                        __impl__::skip_token(read_stream);
                 }
+                return;
             }
-            case enbt::type::uuid:
-                return read_value<enbt::raw_uuid>(read_stream, tid.get_endian());
-            case enbt::type::sarray:
-                return read_sarray(read_stream, tid);
-            case enbt::type::darray:
-                return value(read_darray(read_stream, tid), tid);
-            case enbt::type::compound:
-                return read_compound(read_stream, tid);
-            case enbt::type::array:
-                return value(read_array(read_stream, tid), tid);
-            case enbt::type::optional:
-                return tid.is_signed ? value(true, read_token(read_stream)) : value(false, value());
-            case enbt::type::bit:
-                return value((bool)tid.is_signed);
-            case enbt::type::string:
-                return read_string(read_stream);
             default:
-                return value();
+                __impl__::skip_value(read_stream, tid);
             }
         }
 
-        value read_token(std::istream& read_stream) {
-            return read_value(read_stream, read_type_id(read_stream));
+        void value_path_set::extract(std::istream& read_stream, std::vector<std::optional<value>>& results) const {
+            thread_local std::string scratch;
+            results.assign(paths, std::nullopt);
+            extract_node(read_stream, 0, __impl__::read_type_id(read_stream), results, scratch);
         }
 
-        value read_file(std::istream& read_stream) {
-            check_version(read_stream);
-            return read_token(read_stream);
+        void value_path_set::extract(span_stream& read_stream, std::vector<std::optional<value>>& results) const {
+            std::string unused;
+            results.assign(paths, std::nullopt);
+            extract_node(read_stream, 0, __impl__::read_type_id(read_stream), results, unused);
         }
 
-        std::vector<value> read_list_file(std::istream& read_stream) {
-            check_version(read_stream);
-            std::vector<value> result;
-            while (!read_stream.eof() && !read_stream.fail())
-                result.emplace_back(read_token(read_stream));
-            return result;
+        std::vector<std::optional<value>> value_path_set::extract(std::istream& read_stream) const {
+            std::vector<std::optional<value>> results;
+            extract(read_stream, results);
+            return results;
         }
 
-        void check_version(std::istream& read_stream) {
-            if (read_value<std::uint8_t>(read_stream) != ENBT_VERSION_HEX)
-                throw enbt::exception("unsupported version");
+        std::vector<std::optional<value>> value_path_set::extract(span_stream& read_stream) const {
+            std::vector<std::optional<value>> results;
+            extract(read_stream, results);
+            return results;
         }
 
-        void skip_compound(std::istream& read_stream, enbt::type_id tid) {
-            std::uint64_t len = read_define_len64(read_stream, tid);
-            for (std::uint64_t i = 0; i < len; i++) {
-                skip_string(read_stream);
-                skip_token(read_stream);
+        namespace __impl__ {
+            //size of values that are encoded without a length prefix, values with no bytes at all give 0
+            inline std::optional<std::size_t> fixed_value_size(enbt::type_id tid) noexcept {
+                switch (tid.type) {
+                case enbt::type::integer:
+                    return std::size_t(1) << (int)tid.length;
+                case enbt::type::floating:
+                    return tid.length >= enbt::type_len::Default ? std::size_t(1) << (int)tid.length : 0;
+                case enbt::type::var_integer:
+                    if (tid.length >= enbt::type_len::Default)
+                        return std::nullopt;
+                    return 0;
+                case enbt::type::uuid:
+                    return 16;
+                case enbt::type::optional:
+                    if (tid.is_signed)
+                        return std::nullopt;
+                    return 0;
+                case enbt::type::comp_integer:
+                case enbt::type::sarray:
+                case enbt::type::compound:
+                case enbt::type::darray:
+                case enbt::type::array:
+                case enbt::type::string:
+                case enbt::type::log_item:
+                    return std::nullopt;
+                default:
+                    return 0;
+                }
             }
-        }
 
-        std::uint8_t can_fast_index(enbt::type_id tid) {
-            switch (tid.type) {
-            case enbt::type::integer:
-            case enbt::type::floating:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    return 1;
-                case enbt::type_len::Short:
-                    return 2;
-                case enbt::type_len::Default:
-                    return 4;
-                case enbt::type_len::Long:
-                    return 8;
-                }
-                return 0;
-            case enbt::type::uuid:
-                return 16;
-            case enbt::type::bit:
-                return 1;
-            default:
-                return 0;
+            //0 while the compress_len prefix is incomplete
+            inline std::size_t prefixed_size(const std::uint8_t* data, std::size_t size, std::size_t item_size) {
+                std::size_t prefix = std::size_t(1) << (data[0] >> 6);
+                if (size < prefix)
+                    return 0;
+                std::uint64_t len;
+                decode_compress_len(data, prefix, len);
+                if (len > (SIZE_MAX - prefix) / item_size)
+                    throw enbt::exception("Length of value is too big");
+                return prefix + std::size_t(len) * item_size;
             }
         }
 
-        void skip_array(std::istream& read_stream, enbt::type_id tid) {
-            std::uint64_t len = read_define_len64(read_stream, tid);
-            if (!len)
-                return;
-            auto items_tid = read_type_id(read_stream);
-            if (int index_multiplier = can_fast_index(items_tid); !index_multiplier)
-                for (std::uint64_t i = 0; i < len; i++)
-                    skip_value(read_stream, items_tid);
-            else {
-                if (tid == enbt::type::bit) {
-                    std::uint64_t actual_len = len / 8;
-                    if (len % 8)
-                        ++actual_len;
-                    read_stream.seekg(read_stream.tellg() += actual_len);
+        push_decoder::push_decoder(std::function<void(value&&)> on_token)
+            : on_token(std::move(on_token)) {}
+
+        void push_decoder::feed(std::span<const std::byte> data) {
+            feed((const std::uint8_t*)data.data(), data.size());
+        }
+
+        void push_decoder::feed(const std::uint8_t* data, std::size_t size) {
+            while (size) {
+                std::size_t need;
+                if (pending.empty()) {
+                    need = field_size(data, size);
+                    if (need && need <= size) {
+                        consumed += need;
+                        on_field(data, need);
+                        data += need;
+                        size -= need;
+                        continue;
+                    }
                 } else
-                    read_stream.seekg(read_stream.tellg() += len * index_multiplier);
+                    need = field_size(pending.data(), pending.size());
+                //the field goes past the given bytes, while its size is unknown it is gathered a byte at a time
+                std::size_t take = std::min<std::size_t>(need ? need - pending.size() : 1, size);
+                pending.insert(pending.end(), data, data + take);
+                consumed += take;
+                data += take;
+                size -= take;
+                if (!need)
+                    need = field_size(pending.data(), pending.size());
+                if (need && pending.size() == need) {
+                    on_field(pending.data(), need);
+                    pending.clear();
+                }
             }
         }
 
-        void skip_darray(std::istream& read_stream, enbt::type_id tid) {
-            std::uint64_t len = read_define_len64(read_stream, tid);
-            for (std::uint64_t i = 0; i < len; i++)
-                skip_token(read_stream);
+        void push_decoder::reset() noexcept {
+            stack.clear();
+            pending.clear();
+            consumed = 0;
+            current = field::type_id;
         }
 
-        void skip_sarray(std::istream& read_stream, enbt::type_id tid) {
-            std::uint64_t index = read_compress_len(read_stream);
-            switch (tid.length) {
-            case enbt::type_len::Tiny:
-                read_stream.seekg(read_stream.tellg() += index);
-                break;
-            case enbt::type_len::Short:
-                read_stream.seekg(read_stream.tellg() += index * 2);
-                break;
-            case enbt::type_len::Default:
-                read_stream.seekg(read_stream.tellg() += index * 4);
-                break;
-            case enbt::type_len::Long:
-                read_stream.seekg(read_stream.tellg() += index * 8);
-                break;
+        std::size_t push_decoder::field_size(const std::uint8_t* data, std::size_t size) const {
+            switch (current) {
+            case field::type_id:
+            case field::item_type_id:
+                return 1;
+            case field::define_len:
+                return std::size_t(1) << (int)stack.back().tid.length;
+            case field::log_len:
+                return std::size_t(1) << (data[0] >> 6);
+            case field::key:
+                return __impl__::prefixed_size(data, size, 1);
+            case field::items: {
+                const frame& top = stack.back();
+                if (top.item_tid.type == enbt::type::bit)
+                    return std::size_t((top.remaining + 7) / 8);
+                std::size_t item_size = *__impl__::fixed_value_size(top.item_tid);
+                if (top.remaining > SIZE_MAX / item_size)
+                    throw enbt::exception("Length of array is too big");
+                return std::size_t(top.remaining) * item_size;
+            }
             default:
                 break;
             }
+            if (leaf_size)
+                return leaf_size;
+            switch (leaf_tid.type) {
+            case enbt::type::var_integer: {
+                std::size_t max = leaf_tid.length == enbt::type_len::Long ? 10 : 5;
+                for (std::size_t i = 0; i < size && i < max; i++)
+                    if (!(data[i] & 0x80))
+                        return i + 1;
+                if (size >= max)
+                    throw enbt::exception("VarInt is too big");
+                return 0;
+            }
+            case enbt::type::comp_integer:
+                return std::size_t(1) << (data[0] >> 6);
+            case enbt::type::string:
+                return __impl__::prefixed_size(data, size, 1);
+            default:
+                return __impl__::prefixed_size(data, size, std::size_t(1) << (int)leaf_tid.length);
+            }
         }
 
-        void skip_string(std::istream& read_stream) {
-            std::uint64_t len = read_compress_len(read_stream);
-            read_stream.seekg(read_stream.tellg() += len);
-        }
-
-        void skip_log_item(std::istream& read_stream) {
-            uint64_t val = read_compress_len(read_stream);
-            read_stream.seekg(read_stream.tellg() += val);
-        }
-
-        void skip_value(std::istream& read_stream, enbt::type_id tid) {
-            switch (tid.type) {
-            case enbt::type::floating:
-            case enbt::type::integer:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    read_stream.seekg(read_stream.tellg() += 1);
-                    break;
-                case enbt::type_len::Short:
-                    read_stream.seekg(read_stream.tellg() += 2);
-                    break;
-                case enbt::type_len::Default:
-                    read_stream.seekg(read_stream.tellg() += 4);
-                    break;
-                case enbt::type_len::Long:
-                    read_stream.seekg(read_stream.tellg() += 8);
-                    break;
-                }
+        void push_decoder::on_field(const std::uint8_t* data, std::size_t size) {
+            span_stream read_stream(data, size);
+            switch (current) {
+            case field::type_id:
+                begin_value(__impl__::read_type_id(read_stream));
                 break;
-            case enbt::type::var_integer:
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                case enbt::type_len::Short:
-                    throw enbt::exception("not implemented");
-                case enbt::type_len::Default:
-                    if (tid.is_signed)
-                        read_var<std::int32_t>(read_stream, std::endian::native);
-                    else
-                        read_var<std::uint32_t>(read_stream, std::endian::native);
-                    break;
-                case enbt::type_len::Long:
-                    if (tid.is_signed)
-                        read_var<std::int64_t>(read_stream, std::endian::native);
+            case field::item_type_id: {
+                frame& top = stack.back();
+                top.item_tid = __impl__::read_type_id(read_stream);
+                auto item_size = top.item_tid.type == enbt::type::bit ? std::optional<std::size_t>(1) : __impl__::fixed_value_size(top.item_tid);
+                if (!item_size)
+                    begin_value(top.item_tid);
+                else if (*item_size)
+                    current = field::items; //fixed size items are read at once like read_array does
+                else
+                    complete(finish_frame(&read_stream));
+                break;
+            }
+            case field::define_len: {
+                frame& top = stack.back();
+                top.remaining = __impl__::read_define_len64(read_stream, top.tid);
+                if (!top.remaining)
+                    complete(finish_frame(nullptr));
+                else if (top.tid.type == enbt::type::array)
+                    current = field::item_type_id;
+                else {
+                    if (top.tid.type == enbt::type::compound)
+                        top.fields.reserve(std::min<std::uint64_t>(top.remaining, 1024));
                     else
-                        read_var<std::uint64_t>(read_stream, std::endian::native);
+                        top.items.reserve(std::min<std::uint64_t>(top.remaining, 1024));
+                    next_item(top);
                 }
                 break;
-            case enbt::type::comp_integer: {
-                uint64_t val = read_compress_len(read_stream);
-                switch (tid.length) {
-                case enbt::type_len::Tiny:
-                    if (val != ((std::uint8_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    break;
-                case enbt::type_len::Short:
-                    if (val != ((std::uint16_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    break;
-                case enbt::type_len::Default:
-                    if (val != ((std::uint32_t)val))
-                        throw enbt::exception("invalid encoding for comp_integer, type is too small");
-                    break;
-                case enbt::type_len::Long:
-                    break;
-                default:
-                    break;
-                }
+            }
+            case field::log_len: {
+                std::uint64_t len;
+                __impl__::decode_compress_len(data, size, len);
+                stack.back().log_end = consumed + len;
+                current = field::type_id;
                 break;
             }
-            case enbt::type::uuid:
-                read_stream.seekg(read_stream.tellg() += 16);
+            case field::key: {
+                frame& top = stack.back();
+                top.key = __impl__::read_string(read_stream);
+                current = field::type_id;
                 break;
-            case enbt::type::sarray:
-                skip_sarray(read_stream, tid);
+            }
+            case field::leaf:
+                complete(__impl__::read_value(read_stream, leaf_tid));
                 break;
-            case enbt::type::darray:
-                skip_darray(read_stream, tid);
+            case field::items:
+                complete(finish_frame(&read_stream));
                 break;
+            }
+        }
+
+        void push_decoder::begin_value(enbt::type_id tid) {
+            auto size = __impl__::fixed_value_size(tid);
+            if (size && !*size) {
+                span_stream empty(nullptr, 0);
+                complete(__impl__::read_value(empty, tid));
+                return;
+            }
+            switch (size ? enbt::type::none : tid.type) {
             case enbt::type::compound:
-                skip_compound(read_stream, tid);
-                break;
+            case enbt::type::darray:
             case enbt::type::array:
-                skip_array(read_stream, tid);
+                stack.emplace_back().tid = tid;
+                current = field::define_len;
                 break;
             case enbt::type::optional:
-                if (tid.is_signed)
-                    skip_token(read_stream);
-                break;
-            case enbt::type::none:
-            case enbt::type::bit:
-                break;
-            case enbt::type::string:
-                skip_string(read_stream);
+                stack.emplace_back().tid = tid;
+                current = field::type_id;
                 break;
             case enbt::type::log_item:
-                skip_log_item(read_stream);
+                stack.emplace_back().tid = tid;
+                current = field::log_len;
+                break;
+            default:
+                leaf_tid = tid;
+                leaf_size = size.value_or(0);
+                current = field::leaf;
                 break;
             }
         }
 
-        void skip_token(std::istream& read_stream) {
-            return skip_value(read_stream, read_type_id(read_stream));
+        void push_decoder::next_item(frame& top) {
+            switch (top.tid.type) {
+            case enbt::type::compound:
+                current = field::key;
+                break;
+            case enbt::type::array:
+                begin_value(top.item_tid);
+                break;
+            default:
+                current = field::type_id;
+                break;
+            }
         }
 
-        bool find_value_compound(std::istream& read_stream, enbt::type_id tid, std::string_view key) {
-            std::size_t len = read_define_len(read_stream, tid);
-            for (std::size_t i = 0; i < len; i++) {
-                if (read_string(read_stream) != key)
-                    skip_value(read_stream, read_type_id(read_stream));
+        //pops the container on top of the stack, items holds the array items when they are read at once
+        value push_decoder::finish_frame(span_stream* items) {
+            frame& top = stack.back();
+            value result;
+            switch (top.tid.type) {
+            case enbt::type::compound:
+                result = value(std::move(top.fields));
+                break;
+            case enbt::type::darray:
+                result = value(std::move(top.items), top.tid);
+                if (get_array_compaction())
+                    result.compact(false);
+                break;
+            default:
+                if (!items)
+                    result = value(std::move(top.items), top.tid);
+                else if (get_array_compaction())
+                    result = __impl__::read_compact_array_items(*items, std::size_t(top.remaining), top.tid, top.item_tid);
                 else
-                    return true;
+                    result = value(__impl__::read_array_items(*items, std::size_t(top.remaining), top.item_tid), top.tid);
+                break;
             }
-            return false;
+            stack.pop_back();
+            return result;
         }
 
-        void index_static_array(std::istream& read_stream, std::uint64_t index, std::uint64_t len, enbt::type_id target_id) {
-            if (index >= len)
-                throw enbt::exception('[' + std::to_string(index) + "] out of range " + std::to_string(len));
-            if (std::uint8_t skipper = can_fast_index(target_id)) {
-                if (target_id != enbt::type::bit)
-                    read_stream.seekg(read_stream.tellg() += index * skipper);
-                else
-                    read_stream.seekg(read_stream.tellg() += index / 8);
-            } else
-                for (std::uint64_t i = 0; i < index; i++)
-                    skip_value(read_stream, target_id);
+        void push_decoder::complete(value&& val) {
+            value result = std::move(val);
+            while (!stack.empty()) {
+                frame& top = stack.back();
+                switch (top.tid.type) {
+                case enbt::type::compound:
+                    top.fields.insert_or_assign(std::move(top.key), std::move(result));
+                    break;
+                case enbt::type::optional:
+                    result = value(true, std::move(result));
+                    stack.pop_back();
+                    continue;
+                case enbt::type::log_item:
+                    if (consumed != top.log_end)
+                        throw enbt::exception("Length of log item does not match its value");
+                    result = to_log_item(std::move(result));
+                    stack.pop_back();
+                    continue;
+                default:
+                    top.items.push_back(std::move(result));
+                    break;
+                }
+                if (--top.remaining) {
+                    next_item(top);
+                    return;
+                }
+                result = finish_frame(nullptr);
+            }
+            current = field::type_id;
+            on_token(std::move(result));
         }
 
-        void index_dyn_array(std::istream& read_stream, std::uint64_t index, std::uint64_t len) {
-            if (index >= len)
-                throw enbt::exception('[' + std::to_string(index) + "] out of range " + std::to_string(len));
-            for (std::uint64_t i = 0; i < index; i++)
-                skip_token(read_stream);
+        async_pipe::async_pipe(std::size_t limit)
+            : limit(limit ? limit : 1) {}
+
+        void async_pipe::wake(std::coroutine_handle<>& slot) {
+            if (slot)
+                ready = std::exchange(slot, {});
         }
 
-        std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index, enbt::type_id arr_tid) {
-            switch (arr_tid.type) {
-            case enbt::type::array: {
-                std::uint64_t len = read_define_len64(read_stream, arr_tid);
-                if (!len)
-                    throw enbt::exception("this array is empty");
-                auto target_id = read_type_id(read_stream);
-                index_static_array(read_stream, index, len, target_id);
-                return target_id;
+        task<std::size_t> async_pipe::read_some(std::span<std::byte> out) {
+            while (read_pos == buffer.size() && !closed)
+                co_await wait{waiting_reader, ready};
+            std::size_t size = std::min({out.size(), buffer.size() - read_pos, limit});
+            std::memcpy(out.data(), buffer.data() + read_pos, size);
+            read_pos += size;
+            if (read_pos == buffer.size()) {
+                buffer.clear();
+                read_pos = 0;
             }
-            case enbt::type::darray:
-                index_dyn_array(read_stream, index, read_define_len64(read_stream, arr_tid));
-                return {};
-            default:
-                throw enbt::exception("invalid type id");
+            wake(waiting_writer);
+            co_return size;
+        }
+
+        task<> async_pipe::write(std::span<const std::byte> data) {
+            while (!data.empty()) {
+                if (closed)
+                    throw enbt::exception("Write to closed pipe");
+                std::size_t room = limit - std::min(limit, buffer.size() - read_pos);
+                if (!room) {
+                    co_await wait{waiting_writer, ready};
+                    continue;
+                }
+                std::size_t size = std::min(room, data.size());
+                buffer.insert(buffer.end(), data.begin(), data.begin() + size);
+                data = data.subspan(size);
+                wake(waiting_reader);
             }
         }
 
-        std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index) {
-            return index_array(read_stream, index, read_type_id(read_stream));
-        }
-
-        value_path::index::operator std::string() const {
-            if (std::holds_alternative<std::string>(value))
-                return std::get<std::string>(value);
-            else
-                return std::to_string(std::get<std::uint64_t>(value));
+        void async_pipe::close() {
+            closed = true;
+            wake(waiting_reader);
+            if (ready)
+                std::exchange(ready, {}).resume();
         }
 
-        value_path::index::operator std::uint64_t() const {
-            if (std::holds_alternative<std::string>(value))
-                return std::stoull(std::get<std::string>(value));
-            else
-                return std::get<std::uint64_t>(value);
-        }
+        async_value_reader::async_value_reader(async_byte_source& source, std::size_t chunk_size)
+            : source(source), buffer(chunk_size ? chunk_size : 1), decoder([this](value&& val) { ready.push_back(std::move(val)); }) {}
 
-        std::vector<std::string> split_s(std::string str, std::string_view delimiter) {
-            std::vector<std::string> res;
-            std::size_t pos = 0;
-            while ((pos = str.find(delimiter)) != std::string::npos) {
-                res.emplace_back(str.substr(0, pos));
-                str.erase(0, pos + delimiter.length());
+        task<std::optional<value>> async_value_reader::try_read() {
+            while (ready.empty()) {
+                std::size_t size = co_await source.read_some(buffer);
+                if (!size) {
+                    if (!decoder.idle())
+                        throw enbt::exception("Unexpected end of stream");
+                    co_return std::nullopt;
+                }
+                decoder.feed(std::span<const std::byte>(buffer.data(), size));
             }
-            res.push_back(str);
-            return res;
+            value result = std::move(ready.front());
+            ready.pop_front();
+            co_return std::move(result);
         }
 
-        value_path::value_path(std::string_view stringized_path) {
-            for (auto&& tmp : split_s(std::string(stringized_path), "."))
-                path.emplace_back(tmp);
+        task<value> async_value_reader::read() {
+            std::optional<value> result = co_await try_read();
+            if (!result)
+                throw enbt::exception("Unexpected end of stream");
+            co_return std::move(*result);
         }
 
-        value_path::value_path(const std::vector<index>& copy)
-            : path(copy) {}
-
-        value_path::value_path(std::vector<index>&& move)
-            : path(std::move(move)) {}
-
-        value_path::value_path(const value_path& copy)
-            : path(copy.path) {}
+        task<value> async_value_reader::read_compound() {
+            value result = co_await read();
+            if (!result.is_compound())
+                throw enbt::exception("Invalid type, expected compound");
+            co_return std::move(result);
+        }
 
-        value_path::value_path(value_path&& move) noexcept
-            : path(std::move(move.path)) {}
+        async_value_writer::async_value_writer(async_byte_sink& sink, std::size_t chunk_size)
+            : sink(sink), chunk_size(chunk_size ? chunk_size : 1) {}
 
-        value_path&& value_path::operator[](std::string_view index) {
-            path.emplace_back((std::string)index);
-            return std::move(*this);
+        task<> async_value_writer::write(const value& val) {
+            co_await write_part(val, true);
         }
 
-        value_path&& value_path::operator[](std::uint64_t index) {
-            path.emplace_back(index);
-            return std::move(*this);
+        task<> async_value_writer::flush() {
+            if (staging.empty())
+                co_return;
+            co_await sink.write(std::as_bytes(std::span(staging)));
+            staging.clear();
         }
 
-        std::optional<enbt::type_id> move_to_value_path(std::istream& read_stream, const value_path& value_path) {
-            return move_to_value_path(read_stream, value_path, read_type_id(read_stream));
+        bool async_value_writer::splits(const value& val) const {
+            switch (val.type_id().type) {
+            case enbt::type::compound:
+            case enbt::type::darray:
+            case enbt::type::optional:
+            case enbt::type::log_item:
+            case enbt::type::string:
+                break;
+            case enbt::type::array: {
+                auto& items = *(const std::vector<value>*)val.get_internal_ptr();
+                if (items.empty() || items[0].is_bit())
+                    return false;
+                break;
+            }
+            default:
+                return false;
+            }
+            return serialized_value_size(val) >= chunk_size;
         }
 
-        std::optional<enbt::type_id> move_to_value_path(std::istream& read_stream, const value_path& value_path, enbt::type_id current_id) {
-            try {
-                for (auto&& tmp : value_path.path) {
-                    switch (current_id.type) {
-                    case enbt::type::array:
-                    case enbt::type::darray: {
-                        auto opt = index_array(read_stream, tmp, current_id);
-                        if (opt)
-                            current_id = *opt;
-                        else
-                            current_id = read_type_id(read_stream);
-                        continue;
-                    }
-                    case enbt::type::compound:
-                        if (!find_value_compound(read_stream, current_id, (std::string)tmp))
-                            return {};
-                        current_id = read_type_id(read_stream);
-                        continue;
-                    default:
-                        return {};
-                    }
-                }
-                return current_id;
-            } catch (const std::out_of_range&) {
-                throw;
-            } catch (const std::exception&) {
-                return {};
-            }
+        std::size_t async_value_writer::stage(const value& val, bool with_type_id) {
+            output_sink write_stream(staging);
+            if (with_type_id)
+                write_token(write_stream, val);
+            else
+                write_value(write_stream, val);
+            write_stream.flush();
+            return staging.size();
         }
 
-        value get_value_path(std::istream& read_stream, const value_path& value_path) {
-            auto old_pos = read_stream.tellg();
-            bool is_bit_value = false;
-            bool bit_value = false;
-            try {
-                for (auto&& tmp : value_path.path) {
-                    auto tid = read_type_id(read_stream);
-                    switch (tid.type) {
-                    case enbt::type::array: {
-                        std::uint64_t len = read_define_len64(read_stream, tid);
-                        auto target_id = read_type_id(read_stream);
-                        std::uint64_t index = tmp;
-                        index_static_array(read_stream, index, len, target_id);
-                        if (target_id.type == enbt::type::bit) {
-                            is_bit_value = true;
-                            bit_value = bool(__impl__::_read_as_<std::uint8_t>(read_stream) << (index % 8));
-                        }
-                        continue;
-                    }
-                    case enbt::type::darray:
-                        index_array(read_stream, std::stoull(tmp), tid);
-                        continue;
-                    case enbt::type::compound:
-                        if (!find_value_compound(read_stream, tid, (std::string)tmp))
-                            return false;
-                        continue;
-                    default:
-                        throw std::invalid_argument("invalid path to value");
+        task<> async_value_writer::write_part(const value& val, bool with_type_id) {
+            if (!splits(val)) {
+                if (stage(val, with_type_id) >= chunk_size)
+                    co_await flush();
+                co_return;
+            }
+            //split between items, same layout as write_value
+            enbt::type_id tid = val.type_id();
+            {
+                output_sink write_stream(staging);
+                if (with_type_id)
+                    write_type_id(write_stream, tid);
+                switch (tid.type) {
+                case enbt::type::compound:
+                case enbt::type::darray:
+                case enbt::type::array:
+                    write_define_len(write_stream, val.size(), tid);
+                    if (tid.type == enbt::type::array)
+                        write_type_id(write_stream, (*(const std::vector<value>*)val.get_internal_ptr())[0].type_id());
+                    break;
+                case enbt::type::log_item:
+                    write_compress_len(write_stream, serialized_size(val.get_log_value()));
+                    break;
+                case enbt::type::string: {
+                    std::string_view str = val.as_string_view();
+                    if (!str.empty() && str.back() == 0)
+                        str.remove_suffix(1);
+                    write_compress_len(write_stream, str.size());
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+            //items that fit in a chunk are staged in this frame, only the large ones get a frame of their own
+            switch (tid.type) {
+            case enbt::type::compound:
+                for (auto& [name, item] : *(const std::unordered_map<std::string, value>*)val.get_internal_ptr()) {
+                    {
+                        output_sink write_stream(staging);
+                        write_string(write_stream, name);
                     }
+                    if (splits(item))
+                        co_await write_part(item, true);
+                    else if (stage(item, true) >= chunk_size)
+                        co_await flush();
                 }
-            } catch (...) {
-                read_stream.seekg(old_pos);
-                throw;
+                break;
+            case enbt::type::darray:
+            case enbt::type::array: {
+                bool item_type_id = tid.type == enbt::type::darray;
+                for (auto& item : *(const std::vector<value>*)val.get_internal_ptr()) {
+                    if (splits(item))
+                        co_await write_part(item, item_type_id);
+                    else if (stage(item, item_type_id) >= chunk_size)
+                        co_await flush();
+                }
+                break;
+            }
+            case enbt::type::optional:
+                co_await write_part(*val.get_optional(), true);
+                break;
+            case enbt::type::log_item:
+                co_await write_part(val.get_log_value(), true);
+                break;
+            case enbt::type::string: {
+                std::string_view str = val.as_string_view();
+                if (!str.empty() && str.back() == 0)
+                    str.remove_suffix(1);
+                co_await flush();
+                co_await sink.write(std::as_bytes(std::span(str)));
+                break;
+            }
+            default:
+                break;
             }
-            read_stream.seekg(old_pos);
-            if (is_bit_value)
-                return bit_value;
-            return read_token(read_stream);
         }
 
-        value_read_stream::value_read_stream(std::istream& read_stream)
+        template <class Stream>
+        basic_value_read_stream<Stream>::basic_value_read_stream(Stream& read_stream)
             : read_stream(read_stream) {
             current_type_id = read_type_id(read_stream);
         }
 
-        value_read_stream::~value_read_stream() {
-            if (!readed)
+        template <class Stream>
+        basic_value_read_stream<Stream>::~basic_value_read_stream() {
+            //a stream that is already broken can't be skipped
+            if (!readed && !(read_stream.rdstate() & std::ios_base::badbit))
                 skip();
         }
 
-        value_read_stream::darray::darray(std::istream& read_stream, enbt::type_id current_type_id) : read_stream(read_stream), current_type_id(current_type_id) {
+        template <class Stream>
+        basic_value_read_stream<Stream>::darray::darray(Stream& read_stream, enbt::type_id current_type_id) : read_stream(read_stream), current_type_id(current_type_id) {
             items = read_define_len(read_stream, current_type_id);
         }
 
-        value_read_stream::darray::~darray() {
+        template <class Stream>
+        basic_value_read_stream<Stream>::darray::~darray() {
             if (std::uncaught_exceptions())
                 return;
             iterable([](auto& it) {
@@ -2560,15 +6168,18 @@ namespace enbt {
             });
         }
 
-        size_t value_read_stream::darray::size() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::darray::size() const noexcept {
             return items;
         }
 
-        size_t value_read_stream::darray::current_index() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::darray::current_index() const noexcept {
             return current_item;
         }
 
-        std::vector<enbt::value> value_read_stream::darray::read() {
+        template <class Stream>
+        std::vector<enbt::value> basic_value_read_stream<Stream>::darray::read() {
             std::vector<enbt::value> res;
             res.reserve(items - current_item);
             iterable([&res](value_read_stream& stream) {
@@ -2577,7 +6188,8 @@ namespace enbt {
             return res;
         }
 
-        enbt::value value_read_stream::darray::read_one() {
+        template <class Stream>
+        enbt::value basic_value_read_stream<Stream>::darray::read_one() {
             enbt::value res;
             read_one([&res](value_read_stream& s) {
                 res = s.read();
@@ -2585,169 +6197,197 @@ namespace enbt {
             return res;
         }
 
-        auto value_read_stream::darray::read_one_into(bool& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(bool& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(uint8_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(uint8_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(uint16_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(uint16_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(uint32_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(uint32_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(uint64_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(uint64_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(int8_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(int8_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(int16_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(int16_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(int32_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(int32_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(int64_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(int64_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(float& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(float& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(double& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(double& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(enbt::raw_uuid& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(enbt::raw_uuid& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_into(std::string& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_into(std::string& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(bool& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(bool& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(uint8_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(uint8_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(uint16_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(uint16_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(uint32_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(uint32_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(uint64_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(uint64_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(int8_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(int8_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(int16_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(int16_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(int32_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(int32_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(int64_t& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(int64_t& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(float& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(float& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(double& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(double& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(enbt::raw_uuid& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(enbt::raw_uuid& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::darray::read_one_as(std::string& res) -> darray& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::darray::read_one_as(std::string& res) -> darray& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        value_read_stream::array::array(std::istream& read_stream, enbt::type_id arr_type_id) : read_stream(read_stream), arr_type_id(arr_type_id) {
+        template <class Stream>
+        basic_value_read_stream<Stream>::array::array(Stream& read_stream, enbt::type_id arr_type_id) : read_stream(read_stream), arr_type_id(arr_type_id) {
             items = read_define_len(read_stream, arr_type_id);
             if (items)
                 current_type_id = read_type_id(read_stream);
         }
 
-        value_read_stream::array::~array() {
+        template <class Stream>
+        basic_value_read_stream<Stream>::array::~array() {
             if (std::uncaught_exceptions())
                 return;
             iterable([](auto& it) {
@@ -2755,15 +6395,18 @@ namespace enbt {
             });
         }
 
-        size_t value_read_stream::array::size() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::array::size() const noexcept {
             return items;
         }
 
-        size_t value_read_stream::array::current_index() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::array::current_index() const noexcept {
             return current_item;
         }
 
-        std::vector<enbt::value> value_read_stream::array::read() {
+        template <class Stream>
+        std::vector<enbt::value> basic_value_read_stream<Stream>::array::read() {
             std::vector<enbt::value> res;
             res.reserve(items - current_item);
             iterable([&res](value_read_stream& stream) {
@@ -2772,7 +6415,8 @@ namespace enbt {
             return res;
         }
 
-        enbt::value value_read_stream::array::read_one() {
+        template <class Stream>
+        enbt::value basic_value_read_stream<Stream>::array::read_one() {
             enbt::value res;
             read_one([&res](value_read_stream& s) {
                 res = s.read();
@@ -2780,167 +6424,195 @@ namespace enbt {
             return res;
         }
 
-        auto value_read_stream::array::read_one_into(bool& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(bool& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(uint8_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(uint8_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(uint16_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(uint16_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(uint32_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(uint32_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(uint64_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(uint64_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(int8_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(int8_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(int16_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(int16_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(int32_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(int32_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(int64_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(int64_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(float& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(float& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(double& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(double& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(enbt::raw_uuid& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(enbt::raw_uuid& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_into(std::string& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_into(std::string& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_into(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(bool& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(bool& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(uint8_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(uint8_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(uint16_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(uint16_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(uint32_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(uint32_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(uint64_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(uint64_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(int8_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(int8_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(int16_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(int16_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(int32_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(int32_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(int64_t& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(int64_t& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(float& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(float& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(double& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(double& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(enbt::raw_uuid& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(enbt::raw_uuid& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        auto value_read_stream::array::read_one_as(std::string& res) -> array& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::array::read_one_as(std::string& res) -> array& {
             return read_one([&res](value_read_stream& inner) {
                 inner.read_as(res);
             });
         }
 
-        value_read_stream::compound::compound(std::istream& read_stream, enbt::type_id current_type_id, bool enable_collector_strict_order) : read_stream(read_stream), current_type_id(current_type_id), enable_collector_strict_order(enable_collector_strict_order) {
+        template <class Stream>
+        basic_value_read_stream<Stream>::compound::compound(Stream& read_stream, enbt::type_id current_type_id, bool enable_collector_strict_order) : read_stream(read_stream), current_type_id(current_type_id), enable_collector_strict_order(enable_collector_strict_order) {
             items = read_define_len(read_stream, current_type_id);
         }
 
-        value_read_stream::compound::~compound() {
+        template <class Stream>
+        basic_value_read_stream<Stream>::compound::~compound() {
             if (std::uncaught_exceptions())
                 return;
             iterable([](auto, auto& s) {
@@ -2948,15 +6620,18 @@ namespace enbt {
             });
         }
 
-        size_t value_read_stream::compound::size() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::compound::size() const noexcept {
             return items;
         }
 
-        size_t value_read_stream::compound::current_index() const noexcept {
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::compound::current_index() const noexcept {
             return current_item;
         }
 
-        std::pair<std::string, enbt::value> value_read_stream::compound::read() {
+        template <class Stream>
+        std::pair<std::string, enbt::value> basic_value_read_stream<Stream>::compound::read() {
             if (current_item == items)
                 throw std::out_of_range("Tried to read value out of compounds range.");
             auto str = read_string(read_stream);
@@ -2964,111 +6639,138 @@ namespace enbt {
             return {str, read_token(read_stream)};
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, bool& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, bool& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, uint8_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, uint8_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, uint16_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, uint16_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, uint32_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, uint32_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, uint64_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, uint64_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, int8_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, int8_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, int16_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, int16_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, int32_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, int32_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, int64_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, int64_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, float& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, float& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, double& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, double& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, enbt::raw_uuid& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, enbt::raw_uuid& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_into(const std::string& name, std::string& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_into(const std::string& name, std::string& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_into(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, bool& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, bool& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, uint8_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, uint8_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, uint16_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, uint16_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, uint32_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, uint32_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, uint64_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, uint64_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, int8_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, int8_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, int16_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, int16_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, int32_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, int32_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, int64_t& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, int64_t& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, float& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, float& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, double& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, double& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, enbt::raw_uuid& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, enbt::raw_uuid& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::collect_as(const std::string& name, std::string& res) -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::collect_as(const std::string& name, std::string& res) -> compound& {
             return collect(name, [&res](auto& stream) { stream.read_as(res); });
         }
 
-        auto value_read_stream::compound::make_collect() -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::make_collect() -> compound& {
             if (!enable_collector_strict_order)
                 return iterable([this](std::string& name, value_read_stream& stream) {
                     if (auto it = automated_collector.find(name); it != automated_collector.end())
@@ -3082,7 +6784,8 @@ namespace enbt {
                 });
         }
 
-        auto value_read_stream::compound::force_all_collect() -> compound& {
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::compound::force_all_collect() -> compound& {
             std::unordered_set<std::string> collected_items;
             collected_items.reserve(automated_collector.size());
             if (!enable_collector_strict_order)
@@ -3106,7 +6809,8 @@ namespace enbt {
             return *this;
         }
 
-        enbt::value value_read_stream::read() {
+        template <class Stream>
+        enbt::value basic_value_read_stream<Stream>::read() {
             check_io_state();
             readed = true;
             if (bit_value != -1)
@@ -3122,27 +6826,27 @@ namespace enbt {
                 switch (tid.length) {
                 case enbt::type_len::Tiny:
                     if (tid.is_signed)
-                        res = (T)read_value<std::int8_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::int8_t>(stream, tid.get_endian());
                     else
-                        res = (T)read_value<std::uint8_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::uint8_t>(stream, tid.get_endian());
                     break;
                 case enbt::type_len::Short:
                     if (tid.is_signed)
-                        res = (T)read_value<std::int16_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::int16_t>(stream, tid.get_endian());
                     else
-                        res = (T)read_value<std::uint16_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::uint16_t>(stream, tid.get_endian());
                     break;
                 case enbt::type_len::Default:
                     if (tid.is_signed)
-                        res = (T)read_value<std::int32_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::int32_t>(stream, tid.get_endian());
                     else
-                        res = (T)read_value<std::uint32_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::uint32_t>(stream, tid.get_endian());
                     break;
                 case enbt::type_len::Long:
                     if (tid.is_signed)
-                        res = (T)read_value<std::int64_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::int64_t>(stream, tid.get_endian());
                     else
-                        res = (T)read_value<std::uint64_t>(stream, tid.get_endian());
+                        res = (T)__impl__::read_value<std::uint64_t>(stream, tid.get_endian());
                     break;
                 default:
                     return;
@@ -3156,15 +6860,15 @@ namespace enbt {
                     throw enbt::exception("not implemented");
                 case enbt::type_len::Default:
                     if (tid.is_signed)
-                        res = (T)read_var<std::int32_t>(stream, std::endian::native);
+                        res = (T)__impl__::read_var<std::int32_t>(stream, std::endian::native);
                     else
-                        res = (T)read_var<std::uint32_t>(stream, std::endian::native);
+                        res = (T)__impl__::read_var<std::uint32_t>(stream, std::endian::native);
                     break;
                 case enbt::type_len::Long:
                     if (tid.is_signed)
-                        res = (T)read_var<std::int64_t>(stream, std::endian::native);
+                        res = (T)__impl__::read_var<std::int64_t>(stream, std::endian::native);
                     else
-                        res = (T)read_var<std::uint64_t>(stream, std::endian::native);
+                        res = (T)__impl__::read_var<std::uint64_t>(stream, std::endian::native);
                     break;
                 }
                 break;
@@ -3175,10 +6879,10 @@ namespace enbt {
                 case enbt::type_len::Short:
                     throw enbt::exception("not implemented");
                 case enbt::type_len::Default:
-                    res = (T)read_value<float>(stream, tid.get_endian());
+                    res = (T)__impl__::read_value<float>(stream, tid.get_endian());
                     break;
                 case enbt::type_len::Long:
-                    res = (T)read_value<double>(stream, tid.get_endian());
+                    res = (T)__impl__::read_value<double>(stream, tid.get_endian());
                     break;
                 }
                 break;
@@ -3206,27 +6910,27 @@ namespace enbt {
                 switch (tid.length) {
                 case enbt::type_len::Tiny:
                     if (tid.is_signed)
-                        res = std::to_string(read_value<std::int8_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::int8_t>(stream, tid.get_endian()));
                     else
-                        res = std::to_string(read_value<std::uint8_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::uint8_t>(stream, tid.get_endian()));
                     break;
                 case enbt::type_len::Short:
                     if (tid.is_signed)
-                        res = std::to_string(read_value<std::int16_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::int16_t>(stream, tid.get_endian()));
                     else
-                        res = std::to_string(read_value<std::uint16_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::uint16_t>(stream, tid.get_endian()));
                     break;
                 case enbt::type_len::Default:
                     if (tid.is_signed)
-                        res = std::to_string(read_value<std::int32_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::int32_t>(stream, tid.get_endian()));
                     else
-                        res = std::to_string(read_value<std::uint32_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::uint32_t>(stream, tid.get_endian()));
                     break;
                 case enbt::type_len::Long:
                     if (tid.is_signed)
-                        res = std::to_string(read_value<std::int64_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::int64_t>(stream, tid.get_endian()));
                     else
-                        res = std::to_string(read_value<std::uint64_t>(stream, tid.get_endian()));
+                        res = std::to_string(__impl__::read_value<std::uint64_t>(stream, tid.get_endian()));
                     break;
                 default:
                     return;
@@ -3240,15 +6944,15 @@ namespace enbt {
                     throw enbt::exception("not implemented");
                 case enbt::type_len::Default:
                     if (tid.is_signed)
-                        res = std::to_string(read_var<std::int32_t>(stream, std::endian::native));
+                        res = std::to_string(__impl__::read_var<std::int32_t>(stream, std::endian::native));
                     else
-                        res = std::to_string(read_var<std::uint32_t>(stream, std::endian::native));
+                        res = std::to_string(__impl__::read_var<std::uint32_t>(stream, std::endian::native));
                     break;
                 case enbt::type_len::Long:
                     if (tid.is_signed)
-                        res = std::to_string(read_var<std::int64_t>(stream, std::endian::native));
+                        res = std::to_string(__impl__::read_var<std::int64_t>(stream, std::endian::native));
                     else
-                        res = std::to_string(read_var<std::uint64_t>(stream, std::endian::native));
+                        res = std::to_string(__impl__::read_var<std::uint64_t>(stream, std::endian::native));
                     break;
                 }
                 break;
@@ -3259,10 +6963,10 @@ namespace enbt {
                 case enbt::type_len::Short:
                     throw enbt::exception("not implemented");
                 case enbt::type_len::Default:
-                    res = std::to_string(read_value<float>(stream, tid.get_endian()));
+                    res = std::to_string(__impl__::read_value<float>(stream, tid.get_endian()));
                     break;
                 case enbt::type_len::Long:
-                    res = std::to_string(read_value<double>(stream, tid.get_endian()));
+                    res = std::to_string(__impl__::read_value<double>(stream, tid.get_endian()));
                     break;
                 }
                 break;
@@ -3277,7 +6981,7 @@ namespace enbt {
                     res = "false";
                 break;
             case type::uuid:
-                res = read_value<raw_uuid>(stream, tid.get_endian()).to_string();
+                res = __impl__::read_value<raw_uuid>(stream, tid.get_endian()).to_string();
                 break;
 
             case type::none:
@@ -3388,99 +7092,113 @@ namespace enbt {
             throw enbt::exception("The type is not same as excepted");
         }
 
-        void value_read_stream::check_io_state() {
+        template <class Stream>
+        void basic_value_read_stream<Stream>::check_io_state() {
             if (readed)
                 throw enbt::exception("Invalid read state, item has been already readed");
         }
 
-        value_read_stream& value_read_stream::read_into(bool& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(bool& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(uint8_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(uint8_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(uint16_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(uint16_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(uint32_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(uint32_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(uint64_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(uint64_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(int8_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(int8_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(int16_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(int16_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(int32_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(int32_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(int64_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(int64_t& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(float& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(float& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(double& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(double& res) {
             check_io_state();
             value_read_stream__read_number_exact(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(enbt::raw_uuid& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(enbt::raw_uuid& res) {
             check_io_state();
             if (get_type_id().type == type::uuid) {
-                res = read_value<enbt::raw_uuid>(read_stream, get_type_id().get_endian());
+                res = __impl__::read_value<enbt::raw_uuid>(read_stream, get_type_id().get_endian());
                 readed = true;
             } else
                 throw enbt::exception("The type is not same as excepted");
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_into(std::string& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(std::string& res) {
             check_io_state();
             if (get_type_id().type == type::string) {
                 res = read_string(read_stream);
@@ -3490,192 +7208,914 @@ namespace enbt {
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(bool& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_into(std::string_view& res)
+            requires std::is_same_v<Stream, span_stream>
+        {
+            check_io_state();
+            if (get_type_id().type == type::string) {
+                res = read_string_view(read_stream);
+                readed = true;
+            } else
+                throw enbt::exception("The type is not same as excepted");
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(bool& res) {
+            check_io_state();
+            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(uint8_t& res) {
+            check_io_state();
+            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(uint16_t& res) {
+            check_io_state();
+            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(uint32_t& res) {
+            check_io_state();
+            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(uint64_t& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(uint8_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(int8_t& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(uint16_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(int16_t& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(uint32_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(int32_t& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(uint64_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(int64_t& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(int8_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(float& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(int16_t& res) {
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(double& res) {
             check_io_state();
             value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
             readed = true;
             return *this;
         }
 
-        value_read_stream& value_read_stream::read_as(int32_t& res) {
-            check_io_state();
-            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
-            readed = true;
-            return *this;
-        }
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(enbt::raw_uuid& res) {
+            check_io_state();
+            if (get_type_id().type == type::uuid) {
+                res = __impl__::read_value<enbt::raw_uuid>(read_stream, get_type_id().get_endian());
+                readed = true;
+            } else if (get_type_id().type == type::string)
+                raw_uuid::from_uuid_string(res, read_string(read_stream));
+            else
+                throw enbt::exception("The type is not same as excepted");
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        basic_value_read_stream<Stream>& basic_value_read_stream<Stream>::read_as(std::string& res) {
+            check_io_state();
+            value_read_stream__read_number_to_string(res, get_type_id(), bit_value, read_stream);
+            readed = true;
+            return *this;
+        }
+
+        template <class Stream>
+        void basic_value_read_stream<Stream>::skip() {
+            check_io_state();
+            skip_value(read_stream, current_type_id);
+            readed = true;
+        }
+
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::read_darray() -> darray {
+            if (readed)
+                throw enbt::exception("Invalid read state, item has been already readed");
+            readed = true;
+            return darray(read_stream, current_type_id);
+        }
+
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::read_array() -> array {
+            if (readed)
+                throw enbt::exception("Invalid read state, item has been already readed");
+            readed = true;
+            return array(read_stream, current_type_id);
+        }
+
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::read_compound(bool enable_collector_strict_order) -> compound {
+            if (readed)
+                throw enbt::exception("Invalid read state, item has been already readed");
+            readed = true;
+            return compound(read_stream, current_type_id, enable_collector_strict_order);
+        }
+
+        template <class Stream>
+        auto basic_value_read_stream<Stream>::make_peek() -> peek_stream {
+            if (readed)
+                throw enbt::exception("Invalid read state, item has been already readed");
+            return {read_stream, current_type_id, bit_value};
+        }
+
+        template <class Stream>
+        size_t basic_value_read_stream<Stream>::peek_size() {
+            check_io_state();
+            auto old_state = read_stream.rdstate();
+            auto old_pos = read_stream.tellg();
+            std::uint64_t len = 0;
+            if (current_type_id.type == enbt::type::compound) {
+                len = read_define_len64(read_stream, current_type_id);
+            } else if (current_type_id.type == enbt::type::array) {
+                len = read_define_len64(read_stream, current_type_id);
+            } else if (current_type_id.type == enbt::type::darray) {
+                len = read_define_len64(read_stream, current_type_id);
+            } else if (current_type_id.type == enbt::type::sarray) {
+                len = read_compress_len(read_stream);
+            } else if (current_type_id.type == enbt::type::string) {
+                len = read_compress_len(read_stream);
+            } else {
+                read_stream.setstate(old_state);
+                read_stream.seekg(old_pos);
+                return 0;
+            }
+            read_stream.setstate(old_state);
+            read_stream.seekg(old_pos);
+            return len;
+        }
+
+        template class basic_value_read_stream<std::istream>;
+        template class basic_value_read_stream<span_stream>;
+
+        namespace __impl__ {
+            constexpr enbt::type_id indexed_list_footer_tid{enbt::type::sarray, enbt::type_len::Long, enbt::endian::little, false};
+
+            std::uint64_t resume_indexed_list(std::iostream& stream, std::vector<std::uint64_t>& offsets) {
+                std::streampos origin = stream.tellg();
+                stream.seekg(0, std::ios_base::end);
+                bool empty = stream.tellg() == origin;
+                stream.seekg(origin);
+                if (empty) {
+                    stream.seekp(origin);
+                    return 0;
+                }
+                indexed_list_reader reader(stream);
+                offsets = reader.offsets();
+                if (reader.indexed()) {
+                    //the old footer is cleared first, a resume that is cut off before finish is then scanned instead
+                    // of being read through an index that points into the new records
+                    std::uint8_t cleared[sizeof(indexed_list_magic)] = {};
+                    stream.seekg(0, std::ios_base::end);
+                    stream.seekp(stream.tellg() - std::streamoff(sizeof(cleared)));
+                    stream.write((const char*)cleared, sizeof(cleared));
+                    stream.flush();
+                }
+                stream.seekg(origin);
+                stream.seekp(origin + std::streamoff(reader.end_of_records()));
+                return reader.end_of_records();
+            }
+        }
+
+        indexed_list_writer::indexed_list_writer(std::ostream& write_stream)
+            : sink(write_stream) {
+            initialize_version(sink);
+        }
+
+        indexed_list_writer::indexed_list_writer(std::iostream& stream)
+            : base(__impl__::resume_indexed_list(stream, offsets)), sink(stream) {
+            if (!base)
+                initialize_version(sink);
+        }
+
+        indexed_list_writer::~indexed_list_writer() {
+            if (finished)
+                return;
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+
+        void indexed_list_writer::write(const value& val) {
+            if (finished)
+                throw enbt::exception("Index of list file is already written");
+            offsets.push_back(base + std::uint64_t(std::streamoff(sink.tellp())));
+            __impl__::write_token(sink, val);
+        }
+
+        void indexed_list_writer::finish() {
+            if (finished)
+                throw enbt::exception("Index of list file is already written");
+            std::uint64_t index = base + std::uint64_t(std::streamoff(sink.tellp()));
+            //offsets grow, so the last one tells the width of all
+            bool wide = !offsets.empty() && offsets.back() > UINT32_MAX;
+            __impl__::write_type_id(sink, enbt::type_id{enbt::type::sarray, wide ? enbt::type_len::Long : enbt::type_len::Default, enbt::endian::little, false});
+            __impl__::write_compress_len(sink, offsets.size());
+            if (wide)
+                __impl__::write_array(sink, offsets.data(), offsets.size(), std::endian::little);
+            else {
+                std::uint32_t buffer[1024];
+                for (std::size_t i = 0; i < offsets.size(); i += 1024) {
+                    std::size_t items = std::min<std::size_t>(1024, offsets.size() - i);
+                    for (std::size_t j = 0; j < items; j++)
+                        buffer[j] = std::uint32_t(offsets[i + j]);
+                    __impl__::write_array(sink, buffer, items, std::endian::little);
+                }
+            }
+            std::uint64_t footer[3] = {index, offsets.size(), indexed_list_magic};
+            __impl__::write_type_id(sink, __impl__::indexed_list_footer_tid);
+            __impl__::write_compress_len(sink, 3);
+            __impl__::write_array(sink, footer, 3, std::endian::little);
+            sink.flush();
+            finished = true;
+        }
+
+        template <class Stream>
+        basic_indexed_list_reader<Stream>::basic_indexed_list_reader(Stream& read_stream)
+            : read_stream(read_stream), origin(read_stream.tellg()) {
+            read_stream.seekg(0, std::ios_base::end);
+            std::uint64_t size = std::uint64_t(read_stream.tellg() - origin);
+            bool has_footer = false;
+            if (size > indexed_list_footer_size) {
+                std::uint8_t footer[indexed_list_footer_size];
+                seek(size - indexed_list_footer_size);
+                read_stream.read((char*)footer, indexed_list_footer_size);
+                std::uint64_t fields[3];
+                std::memcpy(fields, footer + 2, sizeof(fields));
+                for (auto& field : fields)
+                    field = endian_helpers::convert_endian(std::endian::little, field);
+                has_footer = footer[0] == enbt::__impl__::raw_type_id(__impl__::indexed_list_footer_tid) && footer[1] == 3 && fields[2] == indexed_list_magic;
+                if (has_footer && fields[0] < size - indexed_list_footer_size) {
+                    std::uint64_t index = fields[0];
+                    seek(index);
+                    enbt::type_id tid = __impl__::read_type_id(read_stream);
+                    if (tid.type == enbt::type::sarray && tid.length >= enbt::type_len::Default && tid.endian == enbt::endian::little) {
+                        std::uint64_t count = __impl__::read_compress_len(read_stream);
+                        std::uint64_t table_at = std::uint64_t(read_stream.tellg() - origin);
+                        std::uint8_t item_size = std::uint8_t(1) << (int)tid.length;
+                        if (count == fields[1] && table_at <= size - indexed_list_footer_size && (size - indexed_list_footer_size - table_at) / item_size == count) {
+                            table = table_at;
+                            offset_size = item_size;
+                            records = count;
+                            records_end = index;
+                            return;
+                        }
+                    }
+                }
+            }
+            //no index or one that does not match the file, offsets are collected by skipping every record once,
+            // the scan ends at the first record that is cut off or can not be read
+            seek(0);
+            __impl__::check_version(read_stream);
+            //a read past the end of an istream throws too, so a damaged length does not skip on forever
+            std::ios_base::iostate exceptions{};
+            if constexpr (!std::is_same_v<Stream, span_stream>) {
+                exceptions = read_stream.exceptions();
+                read_stream.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+            }
+            std::uint64_t pos = 1;
+            while (pos < size) {
+                try {
+                    __impl__::skip_token(read_stream);
+                } catch (const std::exception&) {
+                    break;
+                }
+                std::uint64_t next = std::uint64_t(read_stream.tellg() - origin);
+                if (next <= pos || next > size)
+                    break;
+                scanned.push_back(pos);
+                pos = next;
+            }
+            if constexpr (!std::is_same_v<Stream, span_stream>) {
+                read_stream.clear();
+                read_stream.exceptions(exceptions);
+            }
+            //the index and footer that did not match are not records
+            if (has_footer && pos == size && scanned.size() >= 2 && scanned.back() == size - indexed_list_footer_size) {
+                scanned.pop_back();
+                pos = scanned.back();
+                scanned.pop_back();
+            }
+            records = scanned.size();
+            records_end = pos;
+        }
+
+        template <class Stream>
+        void basic_indexed_list_reader<Stream>::seek(std::uint64_t offset) {
+            read_stream.seekg(origin + std::streamoff(offset));
+        }
+
+        template <class Stream>
+        std::uint64_t basic_indexed_list_reader<Stream>::offset(std::size_t index) {
+            if (index >= records)
+                throw std::out_of_range("Record index is out of bounds");
+            if (!offset_size)
+                return scanned[index];
+            seek(table + std::uint64_t(index) * offset_size);
+            if (offset_size == sizeof(std::uint32_t))
+                return __impl__::read_value<std::uint32_t>(read_stream, std::endian::little);
+            return __impl__::read_value<std::uint64_t>(read_stream, std::endian::little);
+        }
+
+        template <class Stream>
+        std::vector<std::uint64_t> basic_indexed_list_reader<Stream>::offsets() {
+            if (!offset_size)
+                return scanned;
+            std::vector<std::uint64_t> result(records);
+            seek(table);
+            if (offset_size == sizeof(std::uint64_t)) {
+                read_stream.read((char*)result.data(), records * sizeof(std::uint64_t));
+                endian_helpers::convert_endian_arr(std::endian::little, result.data(), result.size());
+            } else {
+                std::uint32_t buffer[1024];
+                for (std::size_t i = 0; i < result.size(); i += 1024) {
+                    std::size_t items = std::min<std::size_t>(1024, result.size() - i);
+                    read_stream.read((char*)buffer, items * sizeof(std::uint32_t));
+                    for (std::size_t j = 0; j < items; j++)
+                        result[i + j] = endian_helpers::convert_endian(std::endian::little, buffer[j]);
+                }
+            }
+            return result;
+        }
+
+        template <class Stream>
+        void basic_indexed_list_reader<Stream>::seek_record(std::size_t index) {
+            seek(offset(index));
+        }
+
+        template <class Stream>
+        value basic_indexed_list_reader<Stream>::record(std::size_t index) {
+            seek_record(index);
+            return __impl__::read_token(read_stream);
+        }
+
+        template class basic_indexed_list_reader<std::istream>;
+        template class basic_indexed_list_reader<span_stream>;
+
+        namespace __impl__ {
+            //appends the items that are whole in data and returns the count of bytes they take
+            std::size_t find_log_items(std::span<const std::byte> data, std::vector<std::span<const std::byte>>& items) {
+                auto bytes = (const std::uint8_t*)data.data();
+                std::size_t pos = 0;
+                while (pos < data.size()) {
+                    union combined_t {
+                        std::uint8_t raw;
+                        enbt::type_id id;
+                    } combined{.raw = bytes[pos]};
+
+                    if (combined.id.type != enbt::type::log_item)
+                        throw enbt::exception("Invalid type, expected log item");
+                    if (pos + 1 == data.size())
+                        break;
+                    std::size_t prefix = std::size_t(1) << (bytes[pos + 1] >> 6);
+                    if (data.size() - pos - 1 < prefix)
+                        break;
+                    std::uint64_t len;
+                    decode_compress_len(bytes + pos + 1, prefix, len);
+                    std::size_t start = pos + 1 + prefix;
+                    if (len > data.size() - start)
+                        break;
+                    items.push_back(data.subspan(start, std::size_t(len)));
+                    pos = start + std::size_t(len);
+                }
+                return pos;
+            }
+
+            value read_log_payload(std::span<const std::byte> payload) {
+                span_stream read_stream(payload);
+                value result = read_token(read_stream);
+                if (!read_stream.eof())
+                    throw enbt::exception("Length of log item does not match its value");
+                return result;
+            }
+
+            //decodes queued log item payloads on worker threads, the values are handed out on the calling thread in order,
+            // workers stay at most a few batches ahead of the delivered ones so memory does not grow with the input
+            class log_decode_pool {
+                //batches are cut by bytes, the target is lowered for small inputs so every worker gets some
+                static constexpr std::size_t max_batch_bytes = 256 * 1024;
+
+                std::size_t window;
+                std::deque<std::vector<std::span<const std::byte>>> pending;
+                std::vector<std::vector<value>> slots;
+                std::vector<bool> ready;
+                std::size_t submitted = 0;
+                std::size_t taken = 0;
+                std::size_t delivered = 0;
+                bool stop = false;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable changed;
+                std::vector<std::thread> workers;
+
+                static std::vector<value> decode(const std::vector<std::span<const std::byte>>& batch) {
+                    std::vector<value> values;
+                    values.reserve(batch.size());
+                    for (auto& item : batch)
+                        values.push_back(read_log_payload(item));
+                    return values;
+                }
+
+                void work(bool compact) {
+                    compact_scope scope(compact);
+                    while (true) {
+                        std::size_t batch;
+                        std::vector<std::span<const std::byte>> items;
+                        {
+                            std::unique_lock lock(mutex);
+                            changed.wait(lock, [&] { return stop || (taken < submitted && taken < delivered + window); });
+                            if (stop)
+                                return;
+                            batch = taken++;
+                            items = std::move(pending.front());
+                            pending.pop_front();
+                        }
+                        std::vector<value> values;
+                        try {
+                            values = decode(items);
+                        } catch (...) {
+                            std::lock_guard lock(mutex);
+                            if (!error)
+                                error = std::current_exception();
+                            stop = true;
+                            changed.notify_all();
+                            return;
+                        }
+                        std::lock_guard lock(mutex);
+                        slots[batch % window] = std::move(values);
+                        ready[batch % window] = true;
+                        changed.notify_all();
+                    }
+                }
+
+            public:
+                //with less than 2 threads the batches are decoded by deliver
+                log_decode_pool(std::size_t threads)
+                    : window(std::max<std::size_t>(threads, 1) * 4), slots(window), ready(window) {
+                    if (threads < 2)
+                        return;
+                    bool compact = get_array_compaction();
+                    workers.reserve(threads);
+                    try {
+                        for (std::size_t i = 0; i < threads; i++)
+                            workers.emplace_back([this, compact] { work(compact); });
+                    } catch (...) {
+                        finish();
+                        throw;
+                    }
+                }
+
+                log_decode_pool(const log_decode_pool&) = delete;
+                log_decode_pool& operator=(const log_decode_pool&) = delete;
+
+                ~log_decode_pool() {
+                    finish();
+                }
+
+                void finish() {
+                    {
+                        std::lock_guard lock(mutex);
+                        stop = true;
+                        changed.notify_all();
+                    }
+                    for (auto& it : workers)
+                        it.join();
+                    workers.clear();
+                }
+
+                //queues the items, their bytes must stay alive until they are delivered, returns the count of queued batches
+                std::size_t submit(const std::vector<std::span<const std::byte>>& items) {
+                    std::size_t total = 0;
+                    for (auto& item : items)
+                        total += item.size();
+                    std::size_t batch_bytes = std::clamp<std::size_t>(total / window, 1, max_batch_bytes);
+                    std::lock_guard lock(mutex);
+                    for (std::size_t i = 0; i < items.size();) {
+                        std::vector<std::span<const std::byte>> batch;
+                        std::size_t bytes = 0;
+                        do {
+                            bytes += items[i].size();
+                            batch.push_back(items[i++]);
+                        } while (i < items.size() && bytes < batch_bytes);
+                        pending.push_back(std::move(batch));
+                        submitted++;
+                    }
+                    changed.notify_all();
+                    return submitted;
+                }
+
+                //hands the values of the batches before the given count to fn, rethrows the first decoding error
+                void deliver(std::size_t batches, const std::function<void(value&&)>& fn) {
+                    while (delivered < batches) {
+                        std::vector<value> values;
+                        if (workers.empty()) {
+                            values = decode(pending.front());
+                            pending.pop_front();
+                            taken++;
+                            delivered++;
+                        } else {
+                            std::unique_lock lock(mutex);
+                            changed.wait(lock, [&] { return error || ready[delivered % window]; });
+                            if (error)
+                                std::rethrow_exception(error);
+                            values = std::move(slots[delivered % window]);
+                            ready[delivered % window] = false;
+                            delivered++;
+                            changed.notify_all();
+                        }
+                        for (auto& val : values)
+                            fn(std::move(val));
+                    }
+                }
+            };
+
+            std::size_t log_decode_threads(std::size_t threads) {
+                return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            void decode_log_items(const std::vector<std::span<const std::byte>>& items, std::size_t threads, const std::function<void(value&&)>& deliver) {
+                log_decode_pool pool(std::min(log_decode_threads(threads), items.size()));
+                pool.deliver(pool.submit(items), deliver);
+            }
+        }
+
+        std::vector<std::span<const std::byte>> scan_log_items(std::span<const std::byte> data) {
+            std::vector<std::span<const std::byte>> items;
+            if (__impl__::find_log_items(data, items) != data.size())
+                throw enbt::exception("Unexpected end of buffer");
+            return items;
+        }
+
+        std::vector<value> read_log_items_parallel(std::span<const std::byte> data, std::size_t threads) {
+            auto items = scan_log_items(data);
+            std::vector<value> result;
+            result.reserve(items.size());
+            __impl__::decode_log_items(items, threads, [&](value&& val) { result.push_back(std::move(val)); });
+            return result;
+        }
+
+        void read_log_items_parallel(std::span<const std::byte> data, const std::function<void(value&&)>& fn, std::size_t threads) {
+            __impl__::decode_log_items(scan_log_items(data), threads, fn);
+        }
+
+        void read_log_items_parallel(std::istream& read_stream, const std::function<void(value&&)>& fn, std::size_t threads) {
+            //two blocks, the next one is read while the items of the last one are decoded
+            std::vector<std::byte> blocks[2] = {std::vector<std::byte>(16 * 1024 * 1024), std::vector<std::byte>(16 * 1024 * 1024)};
+            std::vector<std::span<const std::byte>> items;
+            std::optional<__impl__::log_decode_pool> pool;
+            std::size_t current = 0;
+            std::size_t filled = 0;
+            std::size_t queued = 0;
+            while (true) {
+                auto& block = blocks[current];
+                read_stream.read((char*)block.data() + filled, std::streamsize(block.size() - filled));
+                filled += std::size_t(read_stream.gcount());
+                bool end = filled < block.size();
+                items.clear();
+                std::size_t used = __impl__::find_log_items(std::span<const std::byte>(block.data(), filled), items);
+                if (items.empty() && !end) {
+                    //an item larger than the block
+                    block.resize(block.size() * 2);
+                    continue;
+                }
+                if (!pool) {
+                    threads = __impl__::log_decode_threads(threads);
+                    pool.emplace(end ? std::min(threads, items.size()) : threads);
+                }
+                std::size_t previous = queued;
+                queued = pool->submit(items);
+                //the other block is free once its items are delivered, the cut off item is moved there
+                pool->deliver(previous, fn);
+                auto& next = blocks[current ^ 1];
+                if (next.size() < block.size())
+                    next.resize(block.size());
+                std::memcpy(next.data(), block.data() + used, filled - used);
+                filled -= used;
+                current ^= 1;
+                if (end) {
+                    pool->deliver(queued, fn);
+                    if (filled)
+                        throw enbt::exception("Unexpected end of stream");
+                    return;
+                }
+            }
+        }
+
+        namespace __impl__ {
+            //larger buffers are dropped instead of being kept by the pool
+            constexpr std::size_t scratch_retain_limit = 1024 * 1024;
+
+            template <class Stream>
+            std::vector<std::unique_ptr<container_scratch<Stream>>>& scratch_pool() {
+                thread_local std::vector<std::unique_ptr<container_scratch<Stream>>> pool;
+                return pool;
+            }
+
+            //scratch buffers taken from the pool and not released yet, innermost last
+            template <class Stream>
+            std::vector<container_scratch<Stream>*>& open_scratches() {
+                thread_local std::vector<container_scratch<Stream>*> open;
+                return open;
+            }
+
+            template <class Stream>
+            container_scratch<Stream>* acquire_scratch() {
+                auto& pool = scratch_pool<Stream>();
+                auto& open = open_scratches<Stream>();
+                open.reserve(open.size() + 1);
+                container_scratch<Stream>* scratch;
+                if (pool.empty())
+                    scratch = new container_scratch<Stream>();
+                else {
+                    scratch = pool.back().release();
+                    pool.pop_back();
+                }
+                open.push_back(scratch);
+                return scratch;
+            }
+
+            template <class Stream>
+            void release_scratch(container_scratch<Stream>* scratch) {
+                auto& open = open_scratches<Stream>();
+                auto it = std::find(open.rbegin(), open.rend(), scratch);
+                if (it != open.rend())
+                    open.erase(std::next(it).base());
+                scratch->reset();
+                if (scratch->data.capacity() > scratch_retain_limit)
+                    delete scratch;
+                else
+                    scratch_pool<Stream>().emplace_back(scratch);
+            }
+
+            //the open scratch buffer that stream writes into, null when stream is a caller target
+            template <class Stream>
+            container_scratch<Stream>* find_scratch(Stream& stream) noexcept {
+                auto& open = open_scratches<Stream>();
+                for (auto it = open.rbegin(); it != open.rend(); ++it)
+                    if ((*it)->current() == &stream)
+                        return *it;
+                return nullptr;
+            }
+
+            template <class Stream>
+            void write_container_header(Stream& target, enbt::type type, std::uint64_t items, bool type_id_written, bool shared_type_id) {
+                auto typ = enbt::type_id(type, shared_type_id ? enbt::type_len::Long : enbt::calc_type_len(items));
+                if (type_id_written)
+                    write_type_id(target, typ);
+                write_define_len(target, items, typ);
+            }
+
+            //size of the body with the recorded headers written in
+            template <class Stream>
+            std::size_t scratch_size(container_scratch<Stream>& scratch) {
+                std::size_t size = scratch.close().size();
+                for (auto& header : scratch.headers) {
+                    auto len = header.shared_type_id ? enbt::type_len::Long : enbt::calc_type_len(header.items);
+                    size += header.type_id_written + (std::size_t(1) << std::size_t(len));
+                }
+                return size;
+            }
+
+            template <class Stream>
+            void emit_scratch(container_scratch<Stream>& scratch, Stream& target) {
+                auto body = scratch.close();
+                std::size_t pos = 0;
+                for (auto& header : scratch.headers) {
+                    target.write((const char*)body.data() + pos, header.pos - pos);
+                    write_container_header(target, header.type, header.items, header.type_id_written, header.shared_type_id);
+                    pos = header.pos;
+                }
+                target.write((const char*)body.data() + pos, body.size() - pos);
+            }
 
-        value_read_stream& value_read_stream::read_as(int64_t& res) {
-            check_io_state();
-            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
-            readed = true;
-            return *this;
-        }
+            //widest comp_integer form, any length fits in it
+            constexpr std::size_t log_item_slot_size = 8;
+
+            template <class Stream>
+            log_item_frame<Stream>::log_item_frame(Stream& target)
+                : target(target), stream(&target) {
+                if constexpr (std::is_same_v<Stream, output_sink>) {
+                    //moving the entry back inside a scratch body would shift the headers recorded in it
+                    if (target.seekable() && !find_scratch(target)) {
+                        slot = (std::size_t)std::streamoff(target.tellp());
+                        std::uint8_t placeholder[log_item_slot_size]{};
+                        target.write((const char*)placeholder, log_item_slot_size);
+                        return;
+                    }
+                }
+                scratch = acquire_scratch<Stream>();
+                stream = &scratch->open();
+            }
 
-        value_read_stream& value_read_stream::read_as(float& res) {
-            check_io_state();
-            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
-            readed = true;
-            return *this;
-        }
+            template <class Stream>
+            log_item_frame<Stream>::~log_item_frame() {
+                if (scratch)
+                    release_scratch(scratch);
+            }
 
-        value_read_stream& value_read_stream::read_as(double& res) {
-            check_io_state();
-            value_read_stream__read_number(res, get_type_id(), bit_value, read_stream);
-            readed = true;
-            return *this;
-        }
+            template <class Stream>
+            void log_item_frame<Stream>::close() {
+                if (scratch) {
+                    auto owned = std::exchange(scratch, nullptr);
+                    try {
+                        write_compress_len(target, scratch_size(*owned));
+                        emit_scratch(*owned, target);
+                    } catch (...) {
+                        release_scratch(owned);
+                        throw;
+                    }
+                    release_scratch(owned);
+                    return;
+                }
+                if constexpr (std::is_same_v<Stream, output_sink>) {
+                    std::size_t end = (std::size_t)std::streamoff(target.tellp());
+                    std::uint64_t len = end - slot - log_item_slot_size;
+                    std::uint8_t buf[8];
+                    std::size_t width = compress_len_size(len);
+                    //a still buffered entry is moved back over the unused slot bytes, so the output matches write_log_item
+                    if (target.erase(slot + width, log_item_slot_size - width)) {
+                        encode_compress_len(len, buf);
+                        end -= log_item_slot_size - width;
+                    } else {
+                        store_le64(buf, (len & 0x3F) | (std::uint64_t(3) << 6) | ((len >> 6) << 8));
+                        width = log_item_slot_size;
+                    }
+                    target.seekp(slot);
+                    target.write((const char*)buf, width);
+                    target.seekp(end);
+                }
+            }
 
-        value_read_stream& value_read_stream::read_as(enbt::raw_uuid& res) {
-            check_io_state();
-            if (get_type_id().type == type::uuid) {
-                res = read_value<enbt::raw_uuid>(read_stream, get_type_id().get_endian());
-                readed = true;
-            } else if (get_type_id().type == type::string)
-                raw_uuid::from_uuid_string(res, read_string(read_stream));
-            else
-                throw enbt::exception("The type is not same as excepted");
-            readed = true;
-            return *this;
-        }
+            template class log_item_frame<std::ostream>;
+            template class log_item_frame<output_sink>;
+
+            template <class Stream>
+            container_frame<Stream>::container_frame(Stream& target, enbt::type type, container_mode mode, bool type_id_written, bool shared_type_id)
+                : target(target), stream(&target), uncaught_exceptions(std::uncaught_exceptions()), type(type), type_id_written(type_id_written), shared_type_id(shared_type_id) {
+                if (auto parent = find_scratch(target)) {
+                    scratch = parent;
+                    joined = true;
+                    slot = parent->headers.size();
+                    parent->headers.push_back({parent->tell(), 0, type, type_id_written, shared_type_id});
+                    return;
+                }
+                if (mode == container_mode::buffered) {
+                    scratch = acquire_scratch<Stream>();
+                    stream = &scratch->open();
+                    return;
+                }
+                std::streamoff pos = std::streamoff(target.tellp());
+                bool seekable = pos >= 0;
+                if constexpr (std::is_same_v<Stream, output_sink>)
+                    seekable = target.seekable();
+                if (!seekable)
+                    throw enbt::exception("container_mode::backpatch needs a seekable stream, use container_mode::buffered");
+                slot = (std::size_t)pos;
+                static constexpr char placeholder[9]{}; //typeid + len
+                target.write(placeholder, type_id_written ? 9 : 8);
+            }
 
-        value_read_stream& value_read_stream::read_as(std::string& res) {
-            check_io_state();
-            value_read_stream__read_number_to_string(res, get_type_id(), bit_value, read_stream);
-            readed = true;
-            return *this;
-        }
+            template <class Stream>
+            container_frame<Stream>::container_frame(container_frame&& other) noexcept
+                : target(other.target), scratch(std::exchange(other.scratch, nullptr)), stream(other.stream), slot(other.slot), uncaught_exceptions(other.uncaught_exceptions), type(other.type), type_id_written(other.type_id_written), shared_type_id(other.shared_type_id), joined(other.joined), open(std::exchange(other.open, false)), items(other.items) {}
 
-        void value_read_stream::skip() {
-            check_io_state();
-            skip_value(read_stream, current_type_id);
-            readed = true;
-        }
+            template <class Stream>
+            container_frame<Stream>::~container_frame() {
+                if (!open)
+                    return;
+                if (std::uncaught_exceptions() > uncaught_exceptions) {
+                    open = false;
+                    if (scratch && !joined)
+                        release_scratch(scratch);
+                    return;
+                }
+                try {
+                    close();
+                } catch (...) {
+                }
+            }
 
-        auto value_read_stream::read_darray() -> darray {
-            if (readed)
-                throw enbt::exception("Invalid read state, item has been already readed");
-            readed = true;
-            return darray(read_stream, current_type_id);
-        }
+            template <class Stream>
+            void container_frame<Stream>::close() {
+                if (!open)
+                    return;
+                open = false;
+                if (joined) {
+                    scratch->headers[slot].items = items;
+                    return;
+                }
+                if (scratch) {
+                    auto owned = std::exchange(scratch, nullptr);
+                    try {
+                        write_container_header(target, type, items, type_id_written, shared_type_id);
+                        emit_scratch(*owned, target);
+                    } catch (...) {
+                        release_scratch(owned);
+                        throw;
+                    }
+                    release_scratch(owned);
+                    return;
+                }
+                auto end = target.tellp();
+                target.seekp(std::streamoff(slot));
+                write_container_header(target, type, items, type_id_written, true);
+                target.seekp(end);
+            }
 
-        auto value_read_stream::read_array() -> array {
-            if (readed)
-                throw enbt::exception("Invalid read state, item has been already readed");
-            readed = true;
-            return array(read_stream, current_type_id);
+            template class container_frame<std::ostream>;
+            template class container_frame<output_sink>;
         }
 
-        auto value_read_stream::read_compound(bool enable_collector_strict_order) -> compound {
-            if (readed)
-                throw enbt::exception("Invalid read state, item has been already readed");
-            readed = true;
-            return compound(read_stream, current_type_id, enable_collector_strict_order);
-        }
+        template <class Stream>
+        basic_value_write_stream<Stream>::darray::darray(Stream& write_stream, bool write_type_id, bool shared_type_id, container_mode mode)
+            : frame(write_stream, enbt::type::darray, mode, write_type_id, shared_type_id), write_stream(frame.body()) {}
 
-        auto value_read_stream::make_peek() -> peek_stream {
-            if (readed)
-                throw enbt::exception("Invalid read state, item has been already readed");
-            return {read_stream, current_type_id, bit_value};
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::darray& basic_value_write_stream<Stream>::darray::write(const enbt::value& value) {
+            write_token(write_stream, value);
+            frame.items++;
+            return *this;
         }
 
-        size_t value_read_stream::peek_size() {
-            check_io_state();
-            auto old_state = read_stream.rdstate();
-            auto old_pos = read_stream.tellg();
-            std::uint64_t len = 0;
-            if (current_type_id.type == enbt::type::compound) {
-                len = read_define_len64(read_stream, current_type_id);
-            } else if (current_type_id.type == enbt::type::array) {
-                len = read_define_len64(read_stream, current_type_id);
-            } else if (current_type_id.type == enbt::type::darray) {
-                len = read_define_len64(read_stream, current_type_id);
-            } else if (current_type_id.type == enbt::type::sarray) {
-                len = read_compress_len(read_stream);
-            } else if (current_type_id.type == enbt::type::string) {
-                len = read_compress_len(read_stream);
-            } else {
-                read_stream.setstate(old_state);
-                read_stream.seekg(old_pos);
-                return 0;
-            }
-            read_stream.setstate(old_state);
-            read_stream.seekg(old_pos);
-            return len;
+        template <class Stream>
+        void basic_value_write_stream<Stream>::darray::close() {
+            frame.close();
         }
 
-        value_write_stream::darray::darray(std::ostream& write_stream, bool write_type_id)
-            : write_stream(write_stream), type_id_written(write_type_id) {
-            if (write_type_id) {
-                write_stream.write("\0\0\0\0\0\0\0\0\0", 9); //typeid + len
-                type_size_field_pos = write_stream.tellp();
-                type_size_field_pos -= 9;
-            } else {
-                write_stream.write("\0\0\0\0\0\0\0\0", 8);
-                type_size_field_pos = write_stream.tellp();
-                type_size_field_pos -= 8;
-            }
+        template <class Stream>
+        basic_value_write_stream<Stream>::darray_fixed::darray_fixed(Stream& write_stream, size_t size, bool set_type_id)
+            : write_stream(write_stream), items_to_write(size) {
+            enbt::type_id type(enbt::type::darray, enbt::calc_type_len(size));
+            if (set_type_id)
+                write_type_id(write_stream, type);
+            write_define_len(write_stream, size, type);
         }
 
-        value_write_stream::darray::~darray() {
-            write_stream.flush();
-            auto pos = write_stream.tellp();
-            write_stream.seekp(type_size_field_pos);
-            auto typ = enbt::type_id(enbt::type::darray, enbt::type_len::Long);
-            if (type_id_written)
-                write_type_id(write_stream, typ);
-            write_define_len(write_stream, (uint64_t)items);
-            write_stream.seekp(pos);
-        }
+        template <class Stream>
+        basic_value_write_stream<Stream>::darray_fixed::~darray_fixed() {}
 
-        value_write_stream::darray& value_write_stream::darray::write(const enbt::value& value) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::darray_fixed& basic_value_write_stream<Stream>::darray_fixed::write(const enbt::value& value) {
+            if (items_to_write == 0)
+                throw std::invalid_argument("array is full");
+            --items_to_write;
             write_token(write_stream, value);
-            items++;
             return *this;
         }
 
-        value_write_stream::array::array(std::ostream& write_stream, size_t size, bool write_type_id_)
+        template <class Stream>
+        basic_value_write_stream<Stream>::array::array(Stream& write_stream, size_t size, bool write_type_id_)
             : write_stream(write_stream), items_to_write(size) {
             enbt::type_id type(enbt::type::array, enbt::calc_type_len(size));
             if (write_type_id_)
@@ -3683,17 +8123,22 @@ namespace enbt {
             write_define_len(write_stream, size, type);
         }
 
-        value_write_stream::array::~array() {
+        template <class Stream>
+        basic_value_write_stream<Stream>::array::~array() {
             if (current_type_id.type == type::bit)
                 if (bit_i) {
                     write_stream.write((char*)&bit_value, sizeof(bit_value));
                     bit_i = 0;
+                    bit_value = 0;
                 }
         }
 
-        value_write_stream::array& value_write_stream::array::write(const enbt::value& it) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::array& basic_value_write_stream<Stream>::array::write(const enbt::value& it) {
             if (items_to_write == 0)
                 throw std::invalid_argument("array is full");
+            if (it.is_bit())
+                return write((bool)it);
             if (!type_set) {
                 current_type_id = it.type_id();
                 write_type_id(write_stream, current_type_id);
@@ -3701,59 +8146,41 @@ namespace enbt {
             }
             if (current_type_id != it.type_id())
                 throw enbt::exception("array type mismatch");
-            if (current_type_id.type == type::bit) {
-                if (bit_i >= 8) {
-                    bit_i = 0;
-                    write_stream.write((char*)&bit_value, sizeof(bit_value));
-                }
-                bit_value = (((uint8_t)it) & (1 << bit_i));
-            } else
-                write_value(write_stream, it);
+            write_value(write_stream, it);
             items_to_write--;
             return *this;
         }
 
-        value_write_stream::compound::compound(std::ostream& write_stream, bool set_type_id)
-            : write_stream(write_stream), type_id_written(set_type_id) {
-            if (set_type_id) {
-                write_stream.write("\0\0\0\0\0\0\0\0\0", 9); //typeid + len
-                type_size_field_pos = write_stream.tellp();
-                type_size_field_pos -= 9;
-            } else {
-                write_stream.write("\0\0\0\0\0\0\0\0", 8);
-                type_size_field_pos = write_stream.tellp();
-                type_size_field_pos -= 8;
-            }
-        }
-
-        value_write_stream::compound::~compound() {
-            write_stream.flush();
-            auto pos = write_stream.tellp();
-            write_stream.seekp(type_size_field_pos);
-            auto typ = enbt::type_id(enbt::type::compound, enbt::type_len::Long);
-            if (type_id_written)
-                write_type_id(write_stream, typ);
-            write_define_len(write_stream, (uint64_t)items);
-            write_stream.seekp(pos);
-        }
+        template <class Stream>
+        basic_value_write_stream<Stream>::compound::compound(Stream& write_stream, bool write_type_id, bool shared_type_id, container_mode mode)
+            : frame(write_stream, enbt::type::compound, mode, write_type_id, shared_type_id), write_stream(frame.body()) {}
 
-        value_write_stream::compound& value_write_stream::compound::write(std::string_view filed_name, const enbt::value& value) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::compound& basic_value_write_stream<Stream>::compound::write(std::string_view filed_name, const enbt::value& value) {
             write_string(write_stream, filed_name);
             write_token(write_stream, value);
-            items++;
+            frame.items++;
             return *this;
         }
 
-        value_write_stream::compound_fixed::compound_fixed(std::ostream& write_stream, size_t size, bool set_type_id)
+        template <class Stream>
+        void basic_value_write_stream<Stream>::compound::close() {
+            frame.close();
+        }
+
+        template <class Stream>
+        basic_value_write_stream<Stream>::compound_fixed::compound_fixed(Stream& write_stream, size_t size, bool set_type_id)
             : write_stream(write_stream), items_to_write(size) {
             if (set_type_id)
                 write_type_id(write_stream, enbt::type_id(enbt::type::compound, calc_type_len(size), false));
             write_define_len(write_stream, size, enbt::type_id(enbt::type::compound, calc_type_len(size), false));
         }
 
-        value_write_stream::compound_fixed::~compound_fixed() {}
+        template <class Stream>
+        basic_value_write_stream<Stream>::compound_fixed::~compound_fixed() {}
 
-        value_write_stream::compound_fixed& value_write_stream::compound_fixed::write(std::string_view filed_name, const enbt::value& value) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::compound_fixed& basic_value_write_stream<Stream>::compound_fixed::write(std::string_view filed_name, const enbt::value& value) {
             if (items_to_write == 0)
                 throw std::invalid_argument("compound is full");
             --items_to_write;
@@ -3762,17 +8189,20 @@ namespace enbt {
             return *this;
         }
 
-        value_write_stream::optional::optional(std::ostream& write_stream, bool write_type_id_) : write_stream(write_stream) {
+        template <class Stream>
+        basic_value_write_stream<Stream>::optional::optional(Stream& write_stream, bool write_type_id_) : write_stream(write_stream) {
             if (!write_type_id_)
                 is_written = true;
         }
 
-        value_write_stream::optional::~optional() {
+        template <class Stream>
+        basic_value_write_stream<Stream>::optional::~optional() {
             if (!is_written)
                 write_type_id(write_stream, enbt::type_id(enbt::type::optional, false));
         }
 
-        void value_write_stream::optional::write(const enbt::value& value) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::optional::write(const enbt::value& value) {
             if (has_value)
                 throw std::runtime_error("Tried to write optional multiple times.");
             if (!is_written) {
@@ -3783,7 +8213,8 @@ namespace enbt {
             write_token(write_stream, value);
         }
 
-        void value_write_stream::write(const enbt::value& value) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(const enbt::value& value) {
             written_type_id = value.type_id();
             if (need_to_write_type_id)
                 write_token(write_stream, value);
@@ -3791,130 +8222,447 @@ namespace enbt {
                 write_value(write_stream, value);
         }
 
-        void value_write_stream::write(bool res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(bool res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::bit, res});
             else
                 throw std::invalid_argument("The bool value is encoded in type and could't save it without type");
         }
 
-        void value_write_stream::write(uint8_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(uint8_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Tiny, false});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(uint16_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(uint16_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Short, false});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(uint32_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(uint32_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Default, false});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(uint64_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(uint64_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Long, false});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(int8_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(int8_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Tiny, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(int16_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(int16_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Short, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(int32_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(int32_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Default, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(int64_t res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(int64_t res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::integer, type_len::Long, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(float res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(float res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::floating, type_len::Default, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(double res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(double res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::floating, type_len::Long, true});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(enbt::raw_uuid res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(enbt::raw_uuid res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::uuid});
-            write_value(write_stream, res);
+            __impl__::write_value(write_stream, res);
         }
 
-        void value_write_stream::write(const std::string& res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(const std::string& res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::string});
             write_string(write_stream, res);
         }
 
-        void value_write_stream::write(std::string_view res) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write(std::string_view res) {
             if (need_to_write_type_id)
                 write_type_id(write_stream, type_id{type::string});
             write_string(write_stream, res);
         }
 
-        value_write_stream::compound_fixed value_write_stream::write_compound(size_t size) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::compound_fixed basic_value_write_stream<Stream>::write_compound(size_t size) {
             written_type_id = enbt::type_id(enbt::type::compound, calc_type_len(size));
             return compound_fixed(write_stream, size, need_to_write_type_id);
         }
 
-        value_write_stream::compound value_write_stream::write_compound() {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::compound basic_value_write_stream<Stream>::write_compound(container_mode mode) {
             written_type_id = enbt::type_id(enbt::type::compound, enbt::type_len::Long);
-            return compound(write_stream, need_to_write_type_id);
+            return compound(write_stream, need_to_write_type_id, shared_type_id, mode);
         }
 
-        value_write_stream::darray value_write_stream::write_darray() {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::darray basic_value_write_stream<Stream>::write_darray(container_mode mode) {
             written_type_id = enbt::type_id(enbt::type::darray, enbt::type_len::Long);
-            return darray(write_stream, need_to_write_type_id);
+            return darray(write_stream, need_to_write_type_id, shared_type_id, mode);
+        }
+
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::darray_fixed basic_value_write_stream<Stream>::write_darray(size_t size) {
+            written_type_id = enbt::type_id(enbt::type::darray, enbt::calc_type_len(size));
+            return darray_fixed(write_stream, size, need_to_write_type_id);
         }
 
-        value_write_stream::array value_write_stream::write_array(size_t size) {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::array basic_value_write_stream<Stream>::write_array(size_t size) {
             written_type_id = enbt::type_id(enbt::type::array, enbt::calc_type_len(size));
             return array(write_stream, size, need_to_write_type_id);
         }
 
-        value_write_stream::optional value_write_stream::write_optional() {
+        template <class Stream>
+        typename basic_value_write_stream<Stream>::optional basic_value_write_stream<Stream>::write_optional() {
             written_type_id = enbt::type_id(enbt::type::optional);
             return optional(write_stream, need_to_write_type_id);
         }
 
-        void value_write_stream::write_log_item(const enbt::value& value) {
+        template <class Stream>
+        void basic_value_write_stream<Stream>::write_log_item(const enbt::value& value) {
             written_type_id = enbt::type_id(enbt::type::log_item);
             if (need_to_write_type_id)
                 write_type_id(write_stream, written_type_id);
-            std::ostringstream temp_stream;
-            value_write_stream inner(temp_stream);
-            inner.write(value);
-            write_compress_len(write_stream, temp_stream.tellp());
-            write_stream << temp_stream.rdbuf();
+            io_helper::write_log_item(write_stream, value);
+        }
+
+        template <class Stream>
+        basic_value_write_stream<Stream>::basic_value_write_stream(Stream& write_stream, bool need_to_write_type_id, bool shared_type_id)
+            : write_stream(write_stream), need_to_write_type_id(need_to_write_type_id), shared_type_id(shared_type_id) {
+        }
+
+        template class basic_value_write_stream<std::ostream>;
+        template class basic_value_write_stream<output_sink>;
+    }
+}
+
+namespace enbt {
+    namespace __impl__ {
+        //size of values that can be indexed in type::array without skipping, 0 if the size depends on the value
+        std::size_t fixed_value_size(enbt::type_id tid) {
+            switch (tid.type) {
+            case enbt::type::integer:
+            case enbt::type::floating:
+                return std::size_t(1) << (std::size_t)tid.length;
+            case enbt::type::uuid:
+                return 16;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    value_view::value_view(std::span<const std::byte> token)
+        : begin(token.data()), end(token.data() + token.size()) {
+        io_helper::span_stream stream(token);
+        tid = io_helper::read_type_id(stream);
+        begin += stream.position();
+    }
+
+    value_view::value_view(std::span<const std::byte> value_bytes, enbt::type_id tid)
+        : begin(value_bytes.data()), end(value_bytes.data() + value_bytes.size()), tid(tid) {}
+
+    io_helper::span_stream value_view::stream_at(std::size_t offset) const {
+        io_helper::span_stream stream(std::span<const std::byte>(begin, end));
+        stream.seekg(std::streampos(std::streamoff(offset)));
+        return stream;
+    }
+
+    value_view value_view::child_at(std::size_t offset) const {
+        return value_view(std::span<const std::byte>(begin + offset, end));
+    }
+
+    std::optional<value_view> value_view::find(std::string_view key) const {
+        auto stream = stream_at(0);
+        std::uint64_t len = io_helper::read_define_len64(stream, tid);
+        for (std::uint64_t i = 0; i < len; i++) {
+            if (io_helper::read_string_view(stream) == key)
+                return child_at(stream.position());
+            io_helper::skip_token(stream);
+        }
+        return std::nullopt;
+    }
+
+    std::size_t value_view::size() const {
+        auto stream = stream_at(0);
+        switch (tid.type) {
+        case enbt::type::sarray:
+        case enbt::type::string:
+            return io_helper::read_compress_len(stream);
+        case enbt::type::compound:
+        case enbt::type::darray:
+        case enbt::type::array:
+            return io_helper::read_define_len64(stream, tid);
+        default:
+            throw enbt::exception("This type can not be sized");
+        }
+    }
+
+    value_view value_view::operator[](std::size_t index) const {
+        if (!is_array())
+            throw std::invalid_argument("Invalid tid, cannot index array");
+        auto stream = stream_at(0);
+        if (io_helper::read_define_len64(stream, tid) <= index)
+            throw std::out_of_range("Index points out of the array range");
+        if (tid.type == enbt::type::darray) {
+            for (std::size_t i = 0; i < index; i++)
+                io_helper::skip_token(stream);
+            return child_at(stream.position());
+        }
+        enbt::type_id element_tid = io_helper::read_type_id(stream);
+        if (element_tid.type == enbt::type::bit) {
+            stream.seekg(std::streamoff(index / 8), std::ios_base::cur);
+            std::uint8_t bits = io_helper::__impl__::_read_as_<std::uint8_t>(stream);
+            return value_view(std::span<const std::byte>(), enbt::type_id(enbt::type::bit, bool(bits & (1 << (index % 8)))));
+        }
+        if (std::size_t element_size = __impl__::fixed_value_size(element_tid)) {
+            //the count comes from the bytes, so the element may lie past their end
+            if ((std::size_t)(end - begin) - stream.position() < (index + 1) * element_size)
+                throw enbt::exception("Unexpected end of buffer");
+            return value_view(std::span<const std::byte>(begin + stream.position() + index * element_size, end), element_tid);
+        }
+        for (std::size_t i = 0; i < index; i++)
+            io_helper::skip_value(stream, element_tid);
+        return value_view(std::span<const std::byte>(begin + stream.position(), end), element_tid);
+    }
+
+    std::vector<value_view> value_view::items() const {
+        if (!is_array())
+            throw std::invalid_argument("Invalid tid, cannot index array");
+        auto stream = stream_at(0);
+        std::uint64_t len = io_helper::read_define_len64(stream, tid);
+        std::vector<value_view> result;
+        if (!len)
+            return result;
+        enbt::type_id element_tid;
+        if (tid.type == enbt::type::array) {
+            element_tid = io_helper::read_type_id(stream);
+            if (element_tid.type == enbt::type::bit) {
+                auto bytes = stream.read_span(std::size_t((len + 7) / 8));
+                result.reserve(std::size_t(len));
+                for (std::size_t i = 0; i < len; i++)
+                    result.push_back(value_view(std::span<const std::byte>(), enbt::type_id(enbt::type::bit, bool(std::uint8_t(bytes[i / 8]) & (1 << (i % 8))))));
+                return result;
+            }
+        }
+        result.reserve(std::size_t(std::min<std::uint64_t>(len, stream.remaining())));
+        for (std::uint64_t i = 0; i < len; i++) {
+            if (tid.type == enbt::type::darray) {
+                result.push_back(child_at(stream.position()));
+                io_helper::skip_token(stream);
+            } else {
+                result.push_back(value_view(std::span<const std::byte>(begin + stream.position(), end), element_tid));
+                io_helper::skip_value(stream, element_tid);
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::pair<std::string_view, value_view>> value_view::entries() const {
+        if (!is_compound())
+            throw std::invalid_argument("Invalid tid, cannot index compound");
+        auto stream = stream_at(0);
+        std::uint64_t len = io_helper::read_define_len64(stream, tid);
+        std::vector<std::pair<std::string_view, value_view>> result;
+        result.reserve(std::size_t(std::min<std::uint64_t>(len, stream.remaining())));
+        for (std::uint64_t i = 0; i < len; i++) {
+            std::string_view name = io_helper::read_string_view(stream);
+            result.emplace_back(name, child_at(stream.position()));
+            io_helper::skip_token(stream);
         }
+        return result;
+    }
+
+    value_view value_view::operator[](std::string_view key) const {
+        if (!is_compound())
+            throw std::invalid_argument("Invalid tid, cannot index compound");
+        if (auto res = find(key))
+            return *res;
+        throw std::out_of_range("Key not found");
+    }
+
+    value value_view::get_index(std::size_t index) const {
+        if (is_sarray()) {
+            auto stream = stream_at(0);
+            std::uint64_t len = io_helper::read_compress_len(stream);
+            if (len <= index)
+                throw std::out_of_range("SArray len is: " + std::to_string(len) + ", but try index at: " + std::to_string(index));
+            stream.seekg(std::streamoff(index << (std::size_t)tid.length), std::ios_base::cur);
+            auto endian = tid.get_endian();
+            if (tid.is_signed) {
+                switch (tid.length) {
+                case type_len::Tiny:
+                    return io_helper::__impl__::read_value<std::int8_t>(stream, endian);
+                case type_len::Short:
+                    return io_helper::__impl__::read_value<std::int16_t>(stream, endian);
+                case type_len::Default:
+                    return io_helper::__impl__::read_value<std::int32_t>(stream, endian);
+                case type_len::Long:
+                    return io_helper::__impl__::read_value<std::int64_t>(stream, endian);
+                }
+            } else {
+                switch (tid.length) {
+                case type_len::Tiny:
+                    return io_helper::__impl__::read_value<std::uint8_t>(stream, endian);
+                case type_len::Short:
+                    return io_helper::__impl__::read_value<std::uint16_t>(stream, endian);
+                case type_len::Default:
+                    return io_helper::__impl__::read_value<std::uint32_t>(stream, endian);
+                case type_len::Long:
+                    return io_helper::__impl__::read_value<std::uint64_t>(stream, endian);
+                }
+            }
+            return value();
+        } else if (is_array())
+            return operator[](index).to_value();
+        else
+            throw std::invalid_argument("Invalid tid, cannot index array");
+    }
+
+    bool value_view::contains() const {
+        if (tid.type == enbt::type::optional)
+            return tid.is_signed;
+        return tid.type != enbt::type::none;
+    }
+
+    bool value_view::contains(std::string_view key) const {
+        if (is_compound())
+            return find(key).has_value();
+        return false;
+    }
+
+    std::optional<value_view> value_view::get_optional() const {
+        if (tid.type == enbt::type::optional)
+            if (tid.is_signed)
+                return child_at(0);
+        return std::nullopt;
+    }
 
-        value_write_stream::value_write_stream(std::ostream& write_stream, bool need_to_write_type_id)
-            : write_stream(write_stream), need_to_write_type_id(need_to_write_type_id) {
+    value_view value_view::get_log_value() const {
+        if (tid.type == enbt::type::log_item) {
+            auto stream = stream_at(0);
+            io_helper::read_compress_len(stream);
+            return child_at(stream.position());
         }
+        return *this;
+    }
+
+    std::string_view value_view::as_string() const {
+        if (!is_string())
+            throw enbt::exception("The type is not same as excepted");
+        auto stream = stream_at(0);
+        return io_helper::read_string_view(stream);
+    }
+
+    std::span<const std::byte> value_view::raw() const {
+        auto stream = stream_at(0);
+        io_helper::skip_value(stream, tid);
+        return std::span<const std::byte>(begin, stream.position());
+    }
+
+    value value_view::to_value() const {
+        auto stream = stream_at(0);
+        return io_helper::read_value(stream, tid);
+    }
+
+    value_view::operator bool() const {
+        return (bool)to_value();
+    }
+
+    value_view::operator std::int8_t() const {
+        return (std::int8_t)to_value();
+    }
+
+    value_view::operator std::int16_t() const {
+        return (std::int16_t)to_value();
+    }
+
+    value_view::operator std::int32_t() const {
+        return (std::int32_t)to_value();
+    }
+
+    value_view::operator std::int64_t() const {
+        return (std::int64_t)to_value();
+    }
+
+    value_view::operator std::uint8_t() const {
+        return (std::uint8_t)to_value();
+    }
+
+    value_view::operator std::uint16_t() const {
+        return (std::uint16_t)to_value();
+    }
+
+    value_view::operator std::uint32_t() const {
+        return (std::uint32_t)to_value();
+    }
+
+    value_view::operator std::uint64_t() const {
+        return (std::uint64_t)to_value();
+    }
+
+    value_view::operator float() const {
+        return (float)to_value();
+    }
+
+    value_view::operator double() const {
+        return (double)to_value();
+    }
+
+    value_view::operator enbt::raw_uuid() const {
+        if (!is_uuid())
+            throw enbt::exception("The type is not same as excepted");
+        auto stream = stream_at(0);
+        return io_helper::__impl__::read_value<enbt::raw_uuid>(stream, tid.get_endian());
+    }
+
+    value_view::operator std::string_view() const {
+        return as_string();
+    }
+
+    value_view::operator std::string() const {
+        if (is_string())
+            return std::string(as_string());
+        return to_value().operator std::string();
     }
 }
 
@@ -4465,7 +9213,7 @@ namespace senbt {
             res += "{}";
     }
 
-    void serialize(std::string& res, std::string& spaces, const enbt::fixed_array_ref& arr, bool compress, bool type_erasure) {
+    void serialize(std::string& res, std::string& spaces, const enbt::fixed_array_const_ref& arr, bool compress, bool type_erasure) {
         if (!compress)
             spaces.push_back('\t');
         if (type_erasure)
@@ -4491,7 +9239,7 @@ namespace senbt {
             res += ']';
     }
 
-    void serialize(std::string& res, std::string& spaces, const enbt::dynamic_array_ref& arr, bool compress, bool type_erasure) {
+    void serialize(std::string& res, std::string& spaces, const enbt::dynamic_array_const_ref& arr, bool compress, bool type_erasure) {
         if (!compress)
             spaces.push_back('\t');
         res += "[";
@@ -4859,14 +9607,14 @@ namespace senbt {
         return res;
     }
 
-    std::string serialize(const enbt::fixed_array_ref& value, bool compress, bool type_erasure) {
+    std::string serialize(const enbt::fixed_array_const_ref& value, bool compress, bool type_erasure) {
         std::string res;
         std::string spaces;
         serialize(res, spaces, value, compress, type_erasure);
         return res;
     }
 
-    std::string serialize(const enbt::dynamic_array_ref& value, bool compress, bool type_erasure) {
+    std::string serialize(const enbt::dynamic_array_const_ref& value, bool compress, bool type_erasure) {
         std::string res;
         std::string spaces;
         serialize(res, spaces, value, compress, type_erasure);
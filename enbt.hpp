@@ -1,14 +1,22 @@
 #pragma once
 #ifndef ENBT
     #define ENBT 1.1
+    #include <algorithm>
     #include <any>
     #include <bit>
+    #include <compare>
+    #include <cstddef>
     #include <cstdint>
     #include <cstring>
     #include <initializer_list>
+    #include <iterator>
+    #include <memory>
+    #include <memory_resource>
     #include <optional>
+    #include <shared_mutex>
     #include <stdexcept>
     #include <string>
+    #include <string_view>
     #include <unordered_map>
     #include <variant>
     #include <vector>
@@ -33,18 +41,26 @@ namespace enbt {
             return val;
         }
 
+        //reverses the bytes of each item_size wide item from in into out, in and out may be the same buffer
+        void byteswap_items(void* out, const void* in, std::size_t item_size, std::size_t count);
+
         template <class T>
         void convert_endian_arr(std::endian value_endian, T* val, std::size_t size) {
             if (std::endian::native != value_endian)
-                for (std::size_t i = 0; i < size; i++)
-                    endian_swap(&val[i], sizeof(T));
+                byteswap_items(val, val, sizeof(T), size);
         }
 
         template <class T>
-        void convert_endian_arr(std::endian value_endian, std::vector<T>& val) {
+        void convert_endian_arr(std::endian value_endian, const T* in, T* out, std::size_t size) {
             if (std::endian::native != value_endian)
-                for (auto& it : val)
-                    endian_swap(&it, sizeof(T));
+                byteswap_items(out, in, sizeof(T), size);
+            else if (in != out && size)
+                std::memcpy(out, in, size * sizeof(T));
+        }
+
+        template <class T>
+        void convert_endian_arr(std::endian value_endian, std::vector<T>& val) {
+            convert_endian_arr(value_endian, val.data(), val.size());
         }
     }
 
@@ -62,7 +78,9 @@ namespace enbt {
 
     class compound_ref;
     class compound_const_ref;
+    class fixed_array_const_ref;
     class fixed_array_ref;
+    class dynamic_array_const_ref;
     class dynamic_array_ref;
     template <class T>
     class simple_array_const_ref;
@@ -103,6 +121,8 @@ namespace enbt {
     using simple_array_i64 = simple_array<std::int64_t>;
 
     class bit;
+    class bit_array_ref;
+    class bit_array;
     class optional;
     class uuid;
 
@@ -362,7 +382,217 @@ namespace enbt {
         value_type data[16];
     };
 
+    //resource used for payloads of values created on the current thread, nullptr means global operator new
+    std::pmr::memory_resource* get_memory_resource() noexcept;
+
+    //values created on this thread while the scope lives allocate their payload boxes from the resource,
+    // these payloads are headed with the resource and each one is returned to it, so values must not outlive the resource
+    // only the boxes and sarray bytes live in the resource, string chars, array buffers and compound nodes use std::allocator,
+    // so the tree is still destroyed value by value
+    class memory_scope {
+        std::pmr::memory_resource* previous;
+
+    public:
+        explicit memory_scope(std::pmr::memory_resource* resource) noexcept;
+        memory_scope(const memory_scope&) = delete;
+        memory_scope& operator=(const memory_scope&) = delete;
+        ~memory_scope();
+    };
+
+    namespace __impl__ {
+        //payloads are bare blocks of global operator new, only payloads allocated inside a memory scope and
+        // payloads moved by value::share are headed, preceded by a header with the resource, owners and hash
+        void* allocate_payload(std::size_t size);
+        //payloads allocated now on this thread are headed
+        bool allocates_headed() noexcept;
+        //headed block from global operator new, for payloads that are about to be shared
+        void* allocate_headed_payload(std::size_t size);
+        void deallocate_payload(void* payload, bool headed) noexcept;
+
+        template <class T, class... Args>
+        T* new_payload(Args&&... args) {
+            void* memory = allocate_payload(sizeof(T));
+            try {
+                return new (memory) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate_payload(memory, allocates_headed());
+                throw;
+            }
+        }
+
+        template <class T>
+        T* new_headed_payload(T&& move) {
+            return new (allocate_headed_payload(sizeof(T))) T(std::move(move));
+        }
+
+        template <class T>
+        void delete_payload(T* payload, bool headed) noexcept {
+            payload->~T();
+            deallocate_payload(payload, headed);
+        }
+
+        template <class T>
+        T* new_payload_array(std::size_t len, bool zeroed = false) {
+            T* res = (T*)allocate_payload(len * sizeof(T));
+            if (zeroed)
+                std::memset(res, 0, len * sizeof(T));
+            return res;
+        }
+
+        inline void delete_payload_array(void* payload, bool headed) noexcept {
+            deallocate_payload(payload, headed);
+        }
+
+        //the functions below take headed payloads only
+        //payloads are deep copied until share_payload switches them to reference counting
+        void share_payload(void* payload) noexcept;
+        //share_payload was called on the payload
+        bool payload_counted(const void* payload) noexcept;
+        //adds an owner to a shared payload, returns false if the payload is not shared
+        bool retain_payload(void* payload) noexcept;
+        //drops an owner, returns true if the caller held the last one and must destroy the payload
+        bool release_payload(void* payload) noexcept;
+        //more than one value holds the payload
+        bool payload_has_owners(const void* payload) noexcept;
+        //structural hashes are memoized only on payloads with several owners, mutation unshares those first
+        bool cached_payload_hash(const void* payload, std::uint64_t& hash) noexcept;
+        void cache_payload_hash(const void* payload, std::uint64_t hash) noexcept;
+        void forget_payload_hash(void* payload) noexcept;
+
+        struct interned_name {
+            std::string name;
+            std::size_t hash; //std::hash<std::string_view> of name
+        };
+    }
+
+    //handle to a name interned in a symbol_table, copying is free and handles of one table compare by pointer
+    // the hash of the name is computed once, so handles can be hoisted out of loops
+    // only lookups take keys, compounds store std::string keys and the decoder does not intern
+    // handles stay valid while their table lives, the global table is never destroyed
+    class key {
+        const __impl__::interned_name* entry;
+
+        friend class symbol_table;
+
+        key(const __impl__::interned_name* entry) noexcept
+            : entry(entry) {}
+
+    public:
+        //interns name in symbol_table::global()
+        explicit key(std::string_view name);
+
+        explicit key(const char* name)
+            : key(std::string_view(name)) {}
+
+        explicit key(const std::string& name)
+            : key(std::string_view(name)) {}
+
+        const std::string& name() const noexcept {
+            return entry->name;
+        }
+
+        std::size_t hash() const noexcept {
+            return entry->hash;
+        }
+
+        operator std::string_view() const noexcept {
+            return entry->name;
+        }
+
+        bool operator==(const key& other) const noexcept {
+            return entry == other.entry;
+        }
+
+        bool operator!=(const key& other) const noexcept {
+            return entry != other.entry;
+        }
+    };
+
+    //thread safe set of interned names, names are never removed while the table lives
+    class symbol_table {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, std::unique_ptr<__impl__::interned_name>> names;
+
+    public:
+        symbol_table() = default;
+        symbol_table(const symbol_table&) = delete;
+        symbol_table& operator=(const symbol_table&) = delete;
+
+        key intern(std::string_view name);
+        //does not intern, returns nullopt if name is not in the table
+        std::optional<key> find(std::string_view name) const;
+        std::size_t size() const;
+
+        static symbol_table& global();
+    };
+
+    enum class simd_level : std::uint8_t {
+        scalar,
+        sse42,
+        avx2,
+        neon
+    };
+
+    //instruction set used by sarray kernels, picked at runtime on x86 and at compile time on aarch64,
+    // other targets use plain loops and report scalar
+    simd_level get_simd_level() noexcept;
+
+    namespace __impl__ {
+        template <class T>
+        using sarray_sum_t = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+
+        //kernels over sarray items, instantiated for all 8 integer types in enbt.cpp
+        template <class T>
+        std::size_t sarray_find(const T* data, std::size_t size, T value) noexcept;
+        template <class T>
+        std::size_t sarray_count(const T* data, std::size_t size, T value) noexcept;
+        //index of the first item that differs or size
+        template <class T>
+        std::size_t sarray_mismatch(const T* left, const T* right, std::size_t size) noexcept;
+        //size must not be 0
+        template <class T>
+        T sarray_min(const T* data, std::size_t size) noexcept;
+        template <class T>
+        T sarray_max(const T* data, std::size_t size) noexcept;
+        //wraps around modulo 2^64
+        template <class T>
+        sarray_sum_t<T> sarray_sum(const T* data, std::size_t size) noexcept;
+        //out may be data, wraps around like T
+        template <class T>
+        void sarray_prefix_sum(const T* data, std::size_t size, T* out) noexcept;
+
+        //sarray items are held in host order whatever endian their type id names, that one is only the wire order,
+        // so items compare as they are
+        template <class T>
+        std::strong_ordering sarray_compare(const T* left, const T* right, std::size_t size) noexcept {
+            std::size_t index = sarray_mismatch(left, right, size);
+            if (index == size)
+                return std::strong_ordering::equal;
+            return left[index] < right[index] ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+    }
+
+    //arrays decoded on the current thread are compacted as by value::compact
+    bool get_array_compaction() noexcept;
+
+    //while the scope lives arrays decoded on this thread are compacted as they are read,
+    // arrays of integers are read straight into sarray storage
+    class compact_scope {
+        bool previous;
+
+    public:
+        explicit compact_scope(bool enabled = true) noexcept;
+        compact_scope(const compact_scope&) = delete;
+        compact_scope& operator=(const compact_scope&) = delete;
+        ~compact_scope();
+    };
+
     class value {
+    public:
+        //strings up to this length are stored inside the value without a payload
+        static constexpr std::size_t short_string_capacity = sizeof(std::uint8_t*) + sizeof(std::size_t) - 1;
+
+    private:
         friend inline value from_log_item(const value& val);
         friend inline value from_log_item(value&& val);
         friend class fixed_array_ref;
@@ -454,7 +684,13 @@ namespace enbt {
         static value_variants get_content(std::uint8_t* data, type_id data_type_id);
         static std::uint8_t* clone_data(std::uint8_t* data, type_id data_type_id, std::size_t data_len);
 
-        std::uint8_t* clone_data() const {
+        //headed receives the flag of the returned payload
+        std::uint8_t* clone_data(bool& headed) const {
+            if (data && data_headed && is_shareable(data_type_id) && __impl__::retain_payload(data)) {
+                headed = true;
+                return data;
+            }
+            headed = __impl__::allocates_headed();
             return clone_data(data, data_type_id, data_len);
         }
 
@@ -479,9 +715,32 @@ namespace enbt {
             }
         }
 
-        static void free_data(std::uint8_t* data, type_id data_type_id) {
+        static bool is_shareable(type_id data_type_id) {
+            switch (data_type_id.type) {
+            case enbt::type::sarray:
+            case enbt::type::array:
+            case enbt::type::darray:
+                return true;
+            case enbt::type::compound:
+            case enbt::type::string:
+                return !data_type_id.is_signed;
+            default:
+                return false;
+            }
+        }
+
+        //copies item, switching a headed payload to reference counting first, bare payloads are deep copied
+        static value share_item(const value& item) {
+            if (item.data && item.data_headed && is_shareable(item.data_type_id))
+                __impl__::share_payload(item.data);
+            return item;
+        }
+
+        static void free_data(std::uint8_t* data, type_id data_type_id, bool headed) {
             if (data == nullptr)
                 return;
+            if (headed && is_shareable(data_type_id) && !__impl__::release_payload(data))
+                return;
             switch (data_type_id.type) {
             case enbt::type::none:
             case enbt::type::bit:
@@ -492,26 +751,27 @@ namespace enbt {
                 break;
             case enbt::type::array:
             case enbt::type::darray:
-                delete (std::vector<value>*)data;
+                __impl__::delete_payload((std::vector<value>*)data, headed);
                 break;
             case enbt::type::compound:
-                delete (std::unordered_map<std::string, value>*)data;
+                __impl__::delete_payload((std::unordered_map<std::string, value>*)data, headed);
                 break;
             case enbt::type::optional:
                 if (data_type_id.is_signed)
-                    delete (value*)data;
+                    __impl__::delete_payload((value*)data, headed);
                 break;
             case enbt::type::uuid:
-                delete (enbt::raw_uuid*)data;
+                __impl__::delete_payload((enbt::raw_uuid*)data, headed);
                 break;
             case enbt::type::string:
-                delete (std::string*)data;
+                if (!data_type_id.is_signed)
+                    __impl__::delete_payload((std::string*)data, headed);
                 break;
             case enbt::type::log_item:
-                delete (value*)data;
+                __impl__::delete_payload((value*)data, headed);
                 break;
             default:
-                delete[] data;
+                __impl__::delete_payload_array(data, headed);
             }
             data = nullptr;
         }
@@ -520,9 +780,38 @@ namespace enbt {
         //if data_len > 8 contain ptr to bytes array
         //if typeid is darray contain ptr to std::vector<value>
         //if typeid is array contain ptr to array_value struct
+        //if typeid is string with is_signed set, data and data_len contain the chars, last byte is the unused capacity,
+        // so the chars are always followed by a zero byte
         std::uint8_t* data = nullptr;
         std::size_t data_len;
         type_id data_type_id;
+        //data is preceded by a payload header, set for payloads allocated in a memory scope and by share,
+        // every other payload is a bare block, fits in the padding after data_type_id
+        bool data_headed = __impl__::allocates_headed();
+
+        char* short_string() noexcept {
+            return reinterpret_cast<char*>(this) + offsetof(value, data);
+        }
+
+        const char* short_string() const noexcept {
+            return reinterpret_cast<const char*>(this) + offsetof(value, data);
+        }
+
+        bool is_short_string() const noexcept {
+            return data_type_id.type == enbt::type::string && data_type_id.is_signed;
+        }
+
+        //type id without the short string flag or the bit value, both live in is_signed
+        enbt::type_id stored_type_id() const noexcept {
+            enbt::type_id res = data_type_id;
+            if (is_short_string() || data_type_id.type == enbt::type::bit)
+                res.is_signed = false;
+            return res;
+        }
+
+        void init_string(std::string_view str);
+        //moves a short string to the heap, std::string references need a real std::string, only for mutable access
+        void box_short_string();
 
         template <class T>
         void set_data(T val) {
@@ -531,8 +820,9 @@ namespace enbt {
                 data = nullptr;
                 std::memcpy((char*)&data, (char*)&val, data_len);
             } else {
-                free_data(data, data_type_id);
-                data = (std::uint8_t*)new T(val);
+                free_data(data, data_type_id, data_headed);
+                data = (std::uint8_t*)__impl__::new_payload<T>(val);
+                data_headed = __impl__::allocates_headed();
             }
         }
 
@@ -542,11 +832,12 @@ namespace enbt {
             if (data_len <= 8) {
                 std::memcpy((char*)&data, (char*)&val, data_len);
             } else {
-                free_data(data, data_type_id);
-                T* tmp = new T[len / sizeof(T)];
+                free_data(data, data_type_id, data_headed);
+                T* tmp = __impl__::new_payload_array<T>(len / sizeof(T));
                 for (std::size_t i = 0; i < len; i++)
                     tmp[i] = val[i];
                 data = (std::uint8_t*)tmp;
+                data_headed = __impl__::allocates_headed();
             }
         }
 
@@ -581,7 +872,7 @@ namespace enbt {
                 data_type_id.length = enbt::type_len::Default;
             else
                 data_type_id.length = enbt::type_len::Long;
-            auto res = new std::vector<value>();
+            auto res = __impl__::new_payload<std::vector<value>>();
             res->reserve(data_len);
             for (const auto& it : array)
                 res->push_back(it);
@@ -612,7 +903,7 @@ namespace enbt {
                 data_type_id.length = enbt::type_len::Long;
             data_type_id.is_signed = 0;
             data_type_id.endian = enbt::endian::native;
-            data = (std::uint8_t*)new std::vector<value>(array);
+            data = (std::uint8_t*)__impl__::new_payload<std::vector<value>>(array);
         }
 
         value();
@@ -727,14 +1018,14 @@ namespace enbt {
         value(uuid&& copy) noexcept;
 
         ~value() {
-            free_data(data, data_type_id);
+            free_data(data, data_type_id, data_headed);
         }
 
         value& operator=(const value& copy) {
             if (this == &copy)
                 return *this;
-            free_data(data, data_type_id);
-            data = copy.clone_data();
+            free_data(data, data_type_id, data_headed);
+            data = copy.clone_data(data_headed);
             data_len = copy.data_len;
             data_type_id = copy.data_type_id;
             return *this;
@@ -746,6 +1037,7 @@ namespace enbt {
             data = move.data;
             data_len = move.data_len;
             data_type_id = move.data_type_id;
+            data_headed = move.data_headed;
 
             move.data_type_id = {};
             move.data = nullptr;
@@ -796,7 +1088,9 @@ namespace enbt {
         }
 
         bool type_equal(type_id tid) const {
-            return !(data_type_id != tid);
+            if (tid.type == enbt::type::string || tid.type == enbt::type::bit)
+                tid.is_signed = false;
+            return !(stored_type_id() != tid);
         }
 
         bool is_log_item() const {
@@ -873,6 +1167,25 @@ namespace enbt {
 
         value& at(const std::string& index);
         const value& at(const std::string& index) const;
+
+        value& operator[](const enbt::key& index) {
+            unshare();
+            if (is_compound())
+                return ((std::unordered_map<std::string, value>*)data)->operator[](index.name());
+            throw std::invalid_argument("Invalid tid, cannot index compound");
+        }
+
+        const value& operator[](const enbt::key& index) const {
+            return at(index.name());
+        }
+
+        value& at(const enbt::key& index) {
+            return at(index.name());
+        }
+
+        const value& at(const enbt::key& index) const {
+            return at(index.name());
+        }
         value& at(std::size_t index);
         const value& at(std::size_t index) const;
 
@@ -886,7 +1199,7 @@ namespace enbt {
             case enbt::type::array:
                 return (*(std::vector<value>*)data).size();
             case enbt::type::string:
-                return (*(std::string*)data).size();
+                return as_string_view().size();
             default:
                 throw enbt::exception("This type can not be sized");
             }
@@ -912,6 +1225,11 @@ namespace enbt {
             default:
                 break;
             }
+            if (is_short_string()) {
+                enbt::type_id res = data_type_id;
+                res.is_signed = false;
+                return res;
+            }
             return data_type_id;
         }
 
@@ -922,6 +1240,7 @@ namespace enbt {
             case enbt::type::array:
             case enbt::type::string: {
                 enbt::type_id res = data_type_id;
+                res.is_signed = false;
                 auto siz = size();
                 if (siz < UINT8_MAX)
                     res.length = enbt::type_len::Tiny;
@@ -938,29 +1257,44 @@ namespace enbt {
             }
         }
 
+        //a short string is returned as its zero terminated chars, std::uint8_t*, not as std::string*,
+        // use as_string_view or the const char* conversion to read strings in either form
         value_variants content() const {
+            if (is_short_string())
+                return (std::uint8_t*)short_string();
+            return get_content(data, data_type_id);
+        }
+
+        //short strings are moved to the heap so strings are always returned as std::string*,
+        // a shared payload is cloned first since the pointers allow mutation
+        value_variants content() {
+            unshare();
+            if (is_short_string())
+                box_short_string();
             return get_content(data, data_type_id);
         }
 
         void set_optional(const value& _value) {
             if (data_type_id.type == enbt::type::optional) {
                 data_type_id.is_signed = true;
-                free_data(data, data_type_id);
-                data = (std::uint8_t*)new value(_value);
+                free_data(data, data_type_id, data_headed);
+                data = (std::uint8_t*)__impl__::new_payload<value>(_value);
+                data_headed = __impl__::allocates_headed();
             }
         }
 
         void set_optional(value&& _value) {
             if (data_type_id.type == enbt::type::optional) {
                 data_type_id.is_signed = true;
-                free_data(data, data_type_id);
-                data = (std::uint8_t*)new value(std::move(_value));
+                free_data(data, data_type_id, data_headed);
+                data = (std::uint8_t*)__impl__::new_payload<value>(std::move(_value));
+                data_headed = __impl__::allocates_headed();
             }
         }
 
         void set_optional() {
             if (data_type_id.type == enbt::type::optional) {
-                free_data(data, data_type_id);
+                free_data(data, data_type_id, data_headed);
                 data_type_id.is_signed = false;
             }
         }
@@ -973,6 +1307,7 @@ namespace enbt {
         }
 
         value* get_optional() {
+            unshare();
             if (data_type_id.type == enbt::type::optional)
                 if (data_type_id.is_signed)
                     return (value*)data;
@@ -986,6 +1321,7 @@ namespace enbt {
         }
 
         value& get_log_value() {
+            unshare();
             if (data_type_id.type == enbt::type::log_item)
                 return *(value*)data;
             return *this;
@@ -1013,6 +1349,10 @@ namespace enbt {
             return false;
         }
 
+        bool contains(const enbt::key& index) const {
+            return contains(index.name());
+        }
+
         value& merge(const value& copy) &;
         value& merge(value&& move) &;
 
@@ -1028,7 +1368,7 @@ namespace enbt {
         }
 
         bool get_type_sign() const {
-            return data_type_id.is_signed;
+            return data_type_id.is_signed && data_type_id.type != enbt::type::string;
         }
 
         const std::uint8_t* get_internal_ptr() const {
@@ -1036,6 +1376,7 @@ namespace enbt {
         }
 
         void remove(std::size_t index) {
+            unshare();
             if (is_array()) {
                 if (((std::vector<value>*)data)->size() <= index)
                     throw std::out_of_range("Index is out of range.");
@@ -1047,10 +1388,11 @@ namespace enbt {
         void remove(const std::string& name);
 
         std::size_t push(const value& enbt) {
+            unshare();
             if (is_array()) {
                 if (data_type_id.type == enbt::type::array) {
                     if (((std::vector<value>*)data)->size())
-                        if (operator[](0).data_type_id != enbt.data_type_id)
+                        if (operator[](0).stored_type_id() != enbt.stored_type_id())
                             throw enbt::exception("Invalid type for pushing array");
                 }
                 ((std::vector<value>*)data)->push_back(enbt);
@@ -1060,10 +1402,11 @@ namespace enbt {
         }
 
         std::size_t push(value&& enbt) {
+            unshare();
             if (is_array()) {
                 if (data_type_id.type == enbt::type::array) {
                     if (((std::vector<value>*)data)->size())
-                        if (operator[](0).data_type_id != enbt.data_type_id)
+                        if (operator[](0).stored_type_id() != enbt.stored_type_id())
                             throw enbt::exception("Invalid type for pushing array");
                 }
                 ((std::vector<value>*)data)->push_back(std::move(enbt));
@@ -1073,6 +1416,7 @@ namespace enbt {
         }
 
         value& front() {
+            unshare();
             if (is_array()) {
                 if (!((std::vector<value>*)data)->size())
                     throw enbt::exception("Array empty");
@@ -1091,6 +1435,7 @@ namespace enbt {
         }
 
         value& back() {
+            unshare();
             if (is_array()) {
                 if (!((std::vector<value>*)data)->size())
                     throw enbt::exception("Array empty");
@@ -1110,6 +1455,7 @@ namespace enbt {
 
 
         void pop() {
+            unshare();
             if (is_array()) {
                 if (!((std::vector<value>*)data)->size())
                     throw enbt::exception("Array empty");
@@ -1119,6 +1465,7 @@ namespace enbt {
         }
 
         void resize(std::size_t siz) {
+            unshare();
             if (is_array()) {
                 ((std::vector<value>*)data)->resize(siz);
                 if (siz < UINT8_MAX)
@@ -1132,40 +1479,44 @@ namespace enbt {
             } else if (is_sarray()) {
                 switch (data_type_id.length) {
                 case enbt::type_len::Tiny: {
-                    std::uint8_t* n = new std::uint8_t[siz];
+                    std::uint8_t* n = __impl__::new_payload_array<std::uint8_t>(siz);
                     for (std::size_t i = 0; i < siz && i < data_len; i++)
                         n[i] = data[i];
-                    delete[] data;
+                    __impl__::delete_payload_array(data, data_headed);
+                    data_headed = __impl__::allocates_headed();
                     data_len = siz;
                     data = n;
                     break;
                 }
                 case enbt::type_len::Short: {
-                    std::uint16_t* n = new std::uint16_t[siz];
+                    std::uint16_t* n = __impl__::new_payload_array<std::uint16_t>(siz);
                     std::uint16_t* prox = (std::uint16_t*)data;
                     for (std::size_t i = 0; i < siz && i < data_len; i++)
                         n[i] = prox[i];
-                    delete[] data;
+                    __impl__::delete_payload_array(data, data_headed);
+                    data_headed = __impl__::allocates_headed();
                     data_len = siz;
                     data = (std::uint8_t*)n;
                     break;
                 }
                 case enbt::type_len::Default: {
-                    std::uint32_t* n = new std::uint32_t[siz];
+                    std::uint32_t* n = __impl__::new_payload_array<std::uint32_t>(siz);
                     std::uint32_t* prox = (std::uint32_t*)data;
                     for (std::size_t i = 0; i < siz && i < data_len; i++)
                         n[i] = prox[i];
-                    delete[] data;
+                    __impl__::delete_payload_array(data, data_headed);
+                    data_headed = __impl__::allocates_headed();
                     data_len = siz;
                     data = (std::uint8_t*)n;
                     break;
                 }
                 case enbt::type_len::Long: {
-                    std::uint64_t* n = new std::uint64_t[siz];
+                    std::uint64_t* n = __impl__::new_payload_array<std::uint64_t>(siz);
                     std::uint64_t* prox = (std::uint64_t*)data;
                     for (std::size_t i = 0; i < siz && i < data_len; i++)
                         n[i] = prox[i];
-                    delete[] data;
+                    __impl__::delete_payload_array(data, data_headed);
+                    data_headed = __impl__::allocates_headed();
                     data_len = siz;
                     data = (std::uint8_t*)n;
                     break;
@@ -1181,45 +1532,32 @@ namespace enbt {
 
         void freeze();
         void unfreeze();
+        //arrays of integers with one type id become sarray of the same width, sign and endian,
+        // darrays of one floating type are frozen to array, which is already stored densely on the wire
+        // when nested is set, arrays inside compounds and arrays are compacted too
+        value& compact(bool nested = true);
+
+        //switches the payload of a compound, array, string or sarray to reference counting,
+        // copies of the value then share it and a mutating call on a shared value clones one level of it,
+        // the elements of that level are shared in turn, so untouched subtrees are never copied,
+        // the first call moves the payloads of the subtree to headed blocks
+        value& share();
+        //the payload is held by more than one value
+        bool is_shared() const;
+        //gives the value its own copy of a shared payload, every mutating accessor calls it
+        void unshare();
 
         bool operator==(const value& enbt) const {
-            if (enbt.data_type_id == data_type_id && data_len == enbt.data_len) {
+            if (data_type_id.type == enbt::type::string)
+                return enbt.data_type_id.type == enbt::type::string && as_string_view() == enbt.as_string_view();
+            //arrays keep their size in the payload, data_len of an array depends on how it was built
+            if (enbt.data_type_id == data_type_id && (data_len == enbt.data_len || is_array())) {
                 switch (data_type_id.type) {
-                case enbt::type::sarray:
-                    switch (data_type_id.length) {
-                    case enbt::type_len::Tiny: {
-                        std::uint8_t* other = enbt.data;
-                        for (std::size_t i = 0; i < data_len; i++)
-                            if (data[i] != other[i])
-                                return false;
-                        break;
-                    }
-                    case enbt::type_len::Short: {
-                        std::uint16_t* im = (std::uint16_t*)data;
-                        std::uint16_t* other = (std::uint16_t*)enbt.data;
-                        for (std::size_t i = 0; i < data_len; i++)
-                            if (im[i] != other[i])
-                                return false;
-                        break;
-                    }
-                    case enbt::type_len::Default: {
-                        std::uint32_t* im = (std::uint32_t*)data;
-                        std::uint32_t* other = (std::uint32_t*)enbt.data;
-                        for (std::size_t i = 0; i < data_len; i++)
-                            if (im[i] != other[i])
-                                return false;
-                        break;
-                    }
-                    case enbt::type_len::Long: {
-                        std::uint64_t* im = (std::uint64_t*)data;
-                        std::uint64_t* other = (std::uint64_t*)enbt.data;
-                        for (std::size_t i = 0; i < data_len; i++)
-                            if (im[i] != other[i])
-                                return false;
-                        break;
-                    }
-                    }
-                    return true;
+                case enbt::type::sarray: {
+                    //items are 1 << length bytes wide, equal items are equal bytes
+                    std::size_t bytes = data_len << (std::size_t)data_type_id.length;
+                    return __impl__::sarray_mismatch<std::uint8_t>(data, enbt.data, bytes) == bytes;
+                }
                 case enbt::type::array:
                 case enbt::type::darray:
                     return (*std::get<std::vector<value>*>(content())) == (*std::get<std::vector<value>*>(enbt.content()));
@@ -1235,8 +1573,9 @@ namespace enbt {
                     return std::get<enbt::raw_uuid>(content()) == std::get<enbt::raw_uuid>(enbt.content());
                 case enbt::type::none:
                     return true;
-                case enbt::type::string:
-                    return *std::get<std::string*>(content()) == *std::get<std::string*>(enbt.content());
+                case enbt::type::floating:
+                case enbt::type::log_item:
+                    return compare(enbt) == 0;
                 default:
                     return content() == enbt.content();
                 }
@@ -1248,10 +1587,18 @@ namespace enbt {
             return !operator==(enbt);
         }
 
+        //orders by type first, then by content: numbers by value, strings and uuids bytewise, sarrays and arrays
+        // element by element, compounds by size and then by their entries sorted by key,
+        // values with equal content but different type ids (int8 5 and int32 5) are ordered by the type id byte
         std::strong_ordering operator<=>(const value& enbt) const {
-            return operator==(enbt) ? std::strong_ordering::equal : std::strong_ordering::less;
+            return compare(enbt);
         }
 
+        std::strong_ordering compare(const value& enbt) const;
+
+        //structural 64 bit hash, equal values hash equally, compounds hash independently of entry order
+        std::uint64_t hash() const;
+
         operator bool() const;
         operator std::int8_t() const;
         operator std::int16_t() const;
@@ -1265,7 +1612,6 @@ namespace enbt {
         operator double() const;
 
         explicit operator std::string&();
-        explicit operator const std::string&() const;
 
         enbt::value cast_to(enbt::type_id id) const;
 
@@ -1289,7 +1635,7 @@ namespace enbt {
         operator std::vector<T>() const {
             std::vector<T> res;
             res.reserve(size());
-            std::vector<value>& tmp = *std::get<std::vector<value>*>(content());
+            const std::vector<value>& tmp = *std::get<std::vector<value>*>(content());
             for (auto& temp : tmp)
                 res.push_back((T)temp);
             return res;
@@ -1303,82 +1649,140 @@ namespace enbt {
             return operator std::string();
         }
 
-        class const_interator {
-        protected:
-            enbt::type_id iterate_type;
-            void* pointer;
+    private:
+        //keeps the container iterator inside the interator, so iterating a value does not allocate
+        class interator_storage {
+            alignas(void*) std::byte holder[4 * sizeof(void*)];
+            enbt::type kind = enbt::type::none;
 
-        public:
-            const_interator(const value& enbt, bool in_begin = true) {
-                iterate_type = enbt.data_type_id;
-                switch (enbt.data_type_id.type) {
-                case enbt::type::none:
-                    pointer = nullptr;
+            void copy_from(const interator_storage& other) {
+                switch (other.kind) {
+                case enbt::type::sarray:
+                    emplace(other.kind, other.get<void*>());
                     break;
-                case enbt::type::array:
                 case enbt::type::darray:
-                    if (in_begin)
-                        pointer = new std::vector<value>::iterator(
-                            (*(std::vector<value>*)enbt.data).begin()
-                        );
-                    else
-                        pointer = new std::vector<value>::iterator(
-                            (*(std::vector<value>*)enbt.data).end()
-                        );
+                    emplace(other.kind, other.get<std::vector<value>::iterator>());
                     break;
                 case enbt::type::compound:
-                    if (in_begin)
-                        pointer = new std::unordered_map<std::string, value>::iterator(
-                            (*(std::unordered_map<std::string, value>*)enbt.data).begin()
-                        );
-                    else
-                        pointer = new std::unordered_map<std::string, value>::iterator(
-                            (*(std::unordered_map<std::string, value>*)enbt.data).end()
-                        );
+                    emplace(other.kind, other.get<std::unordered_map<std::string, value>::iterator>());
                     break;
                 default:
-                    throw enbt::exception("Invalid type");
+                    break;
                 }
             }
 
-            const_interator(const_interator&& interator) noexcept {
-                iterate_type = interator.iterate_type;
-                pointer = interator.pointer;
-                interator.pointer = nullptr;
+        public:
+            interator_storage() noexcept {}
+
+            interator_storage(const interator_storage& other) {
+                copy_from(other);
             }
 
-            const_interator(const const_interator& interator) {
-                iterate_type = interator.iterate_type;
-                switch (iterate_type.type) {
-                case enbt::type::none:
-                    pointer = nullptr;
+            interator_storage& operator=(const interator_storage& other) {
+                if (this != &other) {
+                    reset();
+                    copy_from(other);
+                }
+                return *this;
+            }
+
+            ~interator_storage() {
+                reset();
+            }
+
+            //sarray holds void*, array and darray hold std::vector<value>::iterator, compound holds std::unordered_map<std::string, value>::iterator
+            enbt::type type() const noexcept {
+                return kind;
+            }
+
+            template <class It>
+            It& get() noexcept {
+                return *std::launder(reinterpret_cast<It*>(holder));
+            }
+
+            template <class It>
+            const It& get() const noexcept {
+                return *std::launder(reinterpret_cast<const It*>(holder));
+            }
+
+            template <class It>
+            void emplace(enbt::type set_kind, It it) {
+                static_assert(sizeof(It) <= sizeof(holder) && alignof(It) <= alignof(void*), "iterator does not fit in interator_storage");
+                reset();
+                new (holder) It(std::move(it));
+                kind = set_kind;
+            }
+
+            void reset() noexcept {
+                switch (kind) {
+                case enbt::type::sarray:
+                    std::destroy_at(&get<void*>());
                     break;
-                case enbt::type::array:
                 case enbt::type::darray:
-                    pointer = new std::vector<value>::iterator(
-                        (*(std::vector<value>::iterator*)interator.pointer)
-                    );
+                    std::destroy_at(&get<std::vector<value>::iterator>());
                     break;
                 case enbt::type::compound:
-                    pointer = new std::unordered_map<std::string, value>::iterator(
-                        (*(std::unordered_map<std::string, value>::iterator*)interator.pointer)
-                    );
+                    std::destroy_at(&get<std::unordered_map<std::string, value>::iterator>());
                     break;
                 default:
-                    throw enbt::exception("Unreachable exception in non debug environment");
+                    break;
                 }
+                kind = enbt::type::none;
             }
+        };
 
-            const_interator& operator++() {
-                switch (iterate_type.type) {
+        //name returned for array elements
+        static const std::string& unnamed() noexcept {
+            static const std::string name;
+            return name;
+        }
+
+    public:
+        //satisfies std::forward_iterator, dereferencing yields a pair of references instead of a stored pair
+        class const_interator {
+        protected:
+            enbt::type_id iterate_type;
+            interator_storage position;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const std::string&, const value&>;
+            using reference = value_type;
+            using pointer = void;
+
+            const_interator() = default;
+
+            const_interator(const value& enbt, bool in_begin = true) {
+                iterate_type = enbt.data_type_id;
+                switch (enbt.data_type_id.type) {
                 case enbt::type::none:
                     break;
                 case enbt::type::array:
+                case enbt::type::darray: {
+                    auto& items = *(std::vector<value>*)enbt.data;
+                    position.emplace(enbt::type::darray, in_begin ? items.begin() : items.end());
+                    break;
+                }
+                case enbt::type::compound: {
+                    auto& items = *(std::unordered_map<std::string, value>*)enbt.data;
+                    position.emplace(enbt::type::compound, in_begin ? items.begin() : items.end());
+                    break;
+                }
+                default:
+                    throw enbt::exception("Invalid type");
+                }
+            }
+
+            const_interator& operator++() {
+                switch (position.type()) {
+                case enbt::type::none:
+                    break;
                 case enbt::type::darray:
-                    (*(std::vector<value>::iterator*)pointer)++;
+                    ++position.get<std::vector<value>::iterator>();
                     break;
                 case enbt::type::compound:
-                    (*(std::unordered_map<std::string, value>::iterator*)pointer)++;
+                    ++position.get<std::unordered_map<std::string, value>::iterator>();
                     break;
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
@@ -1393,16 +1797,15 @@ namespace enbt {
             }
 
             const_interator& operator--() {
-                switch (iterate_type.type) {
+                switch (position.type()) {
                 case enbt::type::none:
                     break;
-                case enbt::type::array:
                 case enbt::type::darray:
-                    (*(std::vector<value>::iterator*)pointer)--;
+                    --position.get<std::vector<value>::iterator>();
                     break;
     #ifdef _WIN32
                 case enbt::type::compound:
-                    (*(std::unordered_map<std::string, value>::iterator*)pointer)--;
+                    --position.get<std::unordered_map<std::string, value>::iterator>();
                     break;
     #endif
                 default:
@@ -1418,46 +1821,33 @@ namespace enbt {
             }
 
             bool operator==(const const_interator& interator) const {
-                switch (iterate_type.type) {
-                case enbt::type::none:
+                if (position.type() != interator.position.type())
                     return false;
-                case enbt::type::array:
+                switch (position.type()) {
+                case enbt::type::none:
+                    return true;
                 case enbt::type::darray:
-                    return (*(std::vector<value>::iterator*)pointer) == (*(std::vector<value>::iterator*)interator.pointer);
+                    return position.get<std::vector<value>::iterator>() == interator.position.get<std::vector<value>::iterator>();
                 case enbt::type::compound:
-                    return (*(std::unordered_map<std::string, value>::iterator*)pointer) == (*(std::unordered_map<std::string, value>::iterator*)interator.pointer);
+                    return position.get<std::unordered_map<std::string, value>::iterator>() == interator.position.get<std::unordered_map<std::string, value>::iterator>();
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
                 }
             }
 
             bool operator!=(const const_interator& interator) const {
-                switch (iterate_type.type) {
-                case enbt::type::none:
-                    return true;
-                case enbt::type::array:
-                case enbt::type::darray:
-                    return (*(std::vector<value>::iterator*)pointer) != (*(std::vector<value>::iterator*)interator.pointer);
-                case enbt::type::compound:
-                    return (*(std::unordered_map<std::string, value>::iterator*)pointer) != (*(std::unordered_map<std::string, value>::iterator*)interator.pointer);
-                default:
-                    throw enbt::exception("Unreachable exception in non debug environment");
-                }
+                return !operator==(interator);
             }
 
-            std::pair<std::string, const value&> operator*() const {
-                switch (iterate_type.type) {
+            reference operator*() const {
+                switch (position.type()) {
                 case enbt::type::none:
-                    return {"", value()};
-                case enbt::type::array:
+                    throw enbt::exception("Invalid type");
                 case enbt::type::darray:
-                    return {"", *(*(std::vector<value>::iterator*)pointer)};
+                    return {unnamed(), *position.get<std::vector<value>::iterator>()};
                 case enbt::type::compound: {
-                    auto& tmp = (*(std::unordered_map<std::string, value>::iterator*)pointer);
-                    return std::pair<std::string, const value&>(
-                        tmp->first,
-                        tmp->second
-                    );
+                    auto& tmp = *position.get<std::unordered_map<std::string, value>::iterator>();
+                    return {tmp.first, tmp.second};
                 }
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
@@ -1468,13 +1858,13 @@ namespace enbt {
         class interator : public const_interator {
 
         public:
+            using value_type = std::pair<const std::string&, value&>;
+            using reference = value_type;
+
+            interator() = default;
+
             interator(value& enbt, bool in_begin = true)
                 : const_interator(enbt, in_begin) {};
-            interator(interator&& interator) noexcept
-                : const_interator(interator) {};
-
-            interator(const interator& interator)
-                : const_interator(interator) {}
 
             interator& operator++() {
                 const_interator::operator++();
@@ -1506,19 +1896,15 @@ namespace enbt {
                 return const_interator::operator!=(interator);
             }
 
-            std::pair<std::string, value&> operator*() {
-                switch (iterate_type.type) {
+            reference operator*() const {
+                switch (position.type()) {
                 case enbt::type::none:
                     throw enbt::exception("Invalid type");
-                case enbt::type::array:
                 case enbt::type::darray:
-                    return {"", *(*(std::vector<value>::iterator*)pointer)};
+                    return {unnamed(), *position.get<std::vector<value>::iterator>()};
                 case enbt::type::compound: {
-                    auto& tmp = (*(std::unordered_map<std::string, value>::iterator*)pointer);
-                    return std::pair<std::string, value&>(
-                        tmp->first,
-                        tmp->second
-                    );
+                    auto& tmp = *position.get<std::unordered_map<std::string, value>::iterator>();
+                    return {tmp.first, tmp.second};
                 }
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
@@ -1526,17 +1912,26 @@ namespace enbt {
             }
         };
 
+        //like const_interator, but yields copies and can also walk sarray values
         class copy_interator {
         protected:
             enbt::type_id iterate_type;
-            void* pointer;
+            interator_storage position;
 
         public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const std::string&, value>;
+            using reference = value_type;
+            using pointer = void;
+
+            copy_interator() = default;
+
             copy_interator(const value& enbt, bool in_begin = true) {
                 iterate_type = enbt.data_type_id;
                 switch (enbt.data_type_id.type) {
-                case enbt::type::sarray:
-                    pointer = const_cast<std::uint8_t*>(enbt.get_internal_ptr());
+                case enbt::type::sarray: {
+                    void* pointer = const_cast<std::uint8_t*>(enbt.get_internal_ptr());
                     if (!in_begin) {
                         switch (enbt.data_type_id.length) {
                         case type_len::Tiny:
@@ -1553,64 +1948,29 @@ namespace enbt {
                             break;
                         }
                     }
+                    position.emplace(enbt::type::sarray, pointer);
                     break;
-                case enbt::type::array:
-                case enbt::type::darray:
-                    if (in_begin)
-                        pointer = new std::vector<value>::iterator(
-                            (*(std::vector<value>*)enbt.data).begin()
-                        );
-                    else
-                        pointer = new std::vector<value>::iterator(
-                            (*(std::vector<value>*)enbt.data).end()
-                        );
-                    break;
-                case enbt::type::compound:
-                    if (in_begin)
-                        pointer = new std::unordered_map<std::string, value>::iterator(
-                            (*(std::unordered_map<std::string, value>*)enbt.data).begin()
-                        );
-                    else
-                        pointer = new std::unordered_map<std::string, value>::iterator(
-                            (*(std::unordered_map<std::string, value>*)enbt.data).end()
-                        );
-                    break;
-                default:
-                    throw enbt::exception("Invalid type");
                 }
-            }
-
-            copy_interator(copy_interator&& interator) noexcept {
-                iterate_type = interator.iterate_type;
-                pointer = interator.pointer;
-                interator.pointer = nullptr;
-            }
-
-            copy_interator(const copy_interator& interator) {
-                iterate_type = interator.iterate_type;
-                switch (iterate_type.type) {
-                case enbt::type::sarray:
-                    pointer = interator.pointer;
-                    break;
                 case enbt::type::array:
-                case enbt::type::darray:
-                    pointer = new std::vector<value>::iterator(
-                        (*(std::vector<value>::iterator*)interator.pointer)
-                    );
+                case enbt::type::darray: {
+                    auto& items = *(std::vector<value>*)enbt.data;
+                    position.emplace(enbt::type::darray, in_begin ? items.begin() : items.end());
                     break;
-                case enbt::type::compound:
-                    pointer = new std::unordered_map<std::string, value>::iterator(
-                        (*(std::unordered_map<std::string, value>::iterator*)interator.pointer)
-                    );
+                }
+                case enbt::type::compound: {
+                    auto& items = *(std::unordered_map<std::string, value>*)enbt.data;
+                    position.emplace(enbt::type::compound, in_begin ? items.begin() : items.end());
                     break;
+                }
                 default:
-                    throw enbt::exception("Unreachable exception in non debug environment");
+                    throw enbt::exception("Invalid type");
                 }
             }
 
             copy_interator& operator++() {
-                switch (iterate_type.type) {
-                case enbt::type::sarray:
+                switch (position.type()) {
+                case enbt::type::sarray: {
+                    void*& pointer = position.get<void*>();
                     switch (iterate_type.length) {
                     case enbt::type_len::Tiny:
                         pointer = ((std::uint8_t*)pointer) + 1;
@@ -1628,12 +1988,12 @@ namespace enbt {
                         break;
                     }
                     break;
-                case enbt::type::array:
+                }
                 case enbt::type::darray:
-                    (*(std::vector<value>::iterator*)pointer)++;
+                    ++position.get<std::vector<value>::iterator>();
                     break;
                 case enbt::type::compound:
-                    (*(std::unordered_map<std::string, value>::iterator*)pointer)++;
+                    ++position.get<std::unordered_map<std::string, value>::iterator>();
                     break;
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
@@ -1648,8 +2008,9 @@ namespace enbt {
             }
 
             copy_interator& operator--() {
-                switch (iterate_type.type) {
-                case enbt::type::sarray:
+                switch (position.type()) {
+                case enbt::type::sarray: {
+                    void*& pointer = position.get<void*>();
                     switch (iterate_type.length) {
                     case enbt::type_len::Tiny:
                         pointer = ((std::uint8_t*)pointer) - 1;
@@ -1667,13 +2028,13 @@ namespace enbt {
                         break;
                     }
                     break;
-                case enbt::type::array:
+                }
                 case enbt::type::darray:
-                    (*(std::vector<value>::iterator*)pointer)--;
+                    --position.get<std::vector<value>::iterator>();
                     break;
     #ifdef _WIN32
                 case enbt::type::compound:
-                    (*(std::unordered_map<std::string, value>::iterator*)pointer)--;
+                    --position.get<std::unordered_map<std::string, value>::iterator>();
                     break;
     #endif
                 default:
@@ -1689,42 +2050,27 @@ namespace enbt {
             }
 
             bool operator==(const copy_interator& interator) const {
-                if (interator.iterate_type != iterate_type)
+                if (interator.iterate_type != iterate_type || position.type() != interator.position.type())
                     return false;
-                switch (iterate_type.type) {
+                switch (position.type()) {
+                case enbt::type::none:
+                    return true;
                 case enbt::type::sarray:
-                    return pointer == interator.pointer;
-                case enbt::type::array:
+                    return position.get<void*>() == interator.position.get<void*>();
                 case enbt::type::darray:
-                    return (*(std::vector<value>::iterator*)pointer) == (*(std::vector<value>::iterator*)interator.pointer);
+                    return position.get<std::vector<value>::iterator>() == interator.position.get<std::vector<value>::iterator>();
                 case enbt::type::compound:
-                    return (*(std::unordered_map<std::string, value>::iterator*)pointer) == (*(std::unordered_map<std::string, value>::iterator*)interator.pointer);
-                    break;
+                    return position.get<std::unordered_map<std::string, value>::iterator>() == interator.position.get<std::unordered_map<std::string, value>::iterator>();
                 default:
                     throw enbt::exception("Unreachable exception in non debug environment");
                 }
-                return false;
             }
 
             bool operator!=(const copy_interator& interator) const {
-                if (interator.iterate_type != iterate_type)
-                    return false;
-                switch (iterate_type.type) {
-                case enbt::type::sarray:
-                    return pointer == interator.pointer;
-                case enbt::type::array:
-                case enbt::type::darray:
-                    return (*(std::vector<value>::iterator*)pointer) != (*(std::vector<value>::iterator*)interator.pointer);
-                case enbt::type::compound:
-                    return (*(std::unordered_map<std::string, value>::iterator*)pointer) != (*(std::unordered_map<std::string, value>::iterator*)interator.pointer);
-                    break;
-                default:
-                    throw enbt::exception("Unreachable exception in non debug environment");
-                }
-                return false;
+                return !operator==(interator);
             }
 
-            std::pair<std::string, value> operator*() const;
+            reference operator*() const;
         };
 
         const_interator begin() const {
@@ -1736,11 +2082,12 @@ namespace enbt {
         }
 
         interator begin() {
-            interator test(*this, true);
+            unshare();
             return interator(*this, true);
         }
 
         interator end() {
+            unshare();
             return interator(*this, false);
         }
 
@@ -1761,16 +2108,27 @@ namespace enbt {
         }
 
         raw_uuid as_uuid() const;
-        const std::string& as_string() const;
+        //copy of the string, as_string_view reads it without one
+        std::string as_string() const;
+        //moves a short string to the heap
         std::string& as_string();
+
+        //valid until the value is modified or destroyed
+        std::string_view as_string_view() const {
+            if (data_type_id.type != enbt::type::string)
+                throw enbt::exception("value is not a string");
+            if (data_type_id.is_signed)
+                return std::string_view(short_string(), short_string_capacity - (std::uint8_t)short_string()[short_string_capacity]);
+            return *(const std::string*)data;
+        }
         compound_ref as_compound();
         compound_const_ref as_compound() const;
         dynamic_array_ref as_array();
-        dynamic_array_ref as_array() const;
+        dynamic_array_const_ref as_array() const;
         dynamic_array_ref as_dyn_array();
-        dynamic_array_ref as_dyn_array() const;
+        dynamic_array_const_ref as_dyn_array() const;
         fixed_array_ref as_fixed_array();
-        fixed_array_ref as_fixed_array() const;
+        fixed_array_const_ref as_fixed_array() const;
         simple_array_ref_ui8 as_ui8_array();
         simple_array_const_ref_ui8 as_ui8_array() const;
         simple_array_ref_ui16 as_ui16_array();
@@ -1790,11 +2148,11 @@ namespace enbt {
     };
 
     inline value to_log_item(const value& val) {
-        return value(new value(val), enbt::type_id(enbt::type::log_item, enbt::type_len::Tiny, true), 0, false);
+        return value(__impl__::new_payload<value>(val), enbt::type_id(enbt::type::log_item, enbt::type_len::Tiny, true), 0, false);
     }
 
     inline value to_log_item(value&& val) {
-        return value(new value(std::move(val)), enbt::type_id(enbt::type::log_item, enbt::type_len::Tiny, false), 0, false);
+        return value(__impl__::new_payload<value>(std::move(val)), enbt::type_id(enbt::type::log_item, enbt::type_len::Tiny, false), 0, false);
     }
 
     inline value from_log_item(const value& val) {
@@ -1807,10 +2165,15 @@ namespace enbt {
         if (val.data_type_id.type != enbt::type::log_item)
             throw enbt::exception("Invalid type");
         value res = std::move(*(value*)val.data);
-        delete (value*)val.data;
+        __impl__::delete_payload((value*)val.data, val.data_headed);
         val.data = nullptr;
         return res;
     }
+
+    namespace __impl__ {
+        std::strong_ordering compare_compounds(const std::unordered_map<std::string, value>& left, const std::unordered_map<std::string, value>& right);
+        std::strong_ordering compare_arrays(const std::vector<value>& left, const std::vector<value>& right);
+    }
 }
 
 namespace enbt {
@@ -1865,8 +2228,9 @@ namespace enbt {
             proxy = tag.proxy;
         }
 
-        const mapped_type& operator[](key_type&& key_val) const {
-            return proxy->operator[](std::move(key_val));
+        //does not insert, the payload may be shared with other values
+        const mapped_type& operator[](const key_type& key_val) const {
+            return proxy->at(key_val);
         }
 
         hasher hash_function() const {
@@ -1881,6 +2245,10 @@ namespace enbt {
             return proxy->at(key_value);
         }
 
+        [[nodiscard]] const mapped_type& at(const enbt::key& key_value) const {
+            return proxy->at(key_value.name());
+        }
+
         size_type bucket(const std::string& index) const noexcept {
             return proxy->bucket(index);
         }
@@ -1897,10 +2265,18 @@ namespace enbt {
             return proxy->contains(key_value);
         }
 
+        [[nodiscard]] bool contains(const enbt::key& key_value) const {
+            return proxy->contains(key_value.name());
+        }
+
         [[nodiscard]] size_type count(const key_type& key_value) const {
             return proxy->count(key_value);
         }
 
+        [[nodiscard]] size_type count(const enbt::key& key_value) const {
+            return proxy->count(key_value.name());
+        }
+
         [[nodiscard]] bool empty() const noexcept {
             return proxy->empty();
         }
@@ -1913,6 +2289,10 @@ namespace enbt {
             return proxy->find(key_value);
         }
 
+        [[nodiscard]] decltype(auto) find(const enbt::key& key_value) const {
+            return proxy->find(key_value.name());
+        }
+
         [[nodiscard]] float load_factor() const noexcept {
             return proxy->load_factor();
         }
@@ -1950,13 +2330,14 @@ namespace enbt {
         }
 
         std::strong_ordering operator<=>(const compound_const_ref& enbt) const {
-            return *proxy == *enbt.proxy ? std::strong_ordering::equal : std::strong_ordering::less;
+            return __impl__::compare_compounds(*proxy, *enbt.proxy);
         }
     };
 
     class compound_ref : public compound_const_ref {
     protected:
         compound_ref(value& abstract) {
+            abstract.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(abstract.content());
         }
 
@@ -2095,6 +2476,10 @@ namespace enbt {
             return proxy->operator[](key_value);
         }
 
+        [[nodiscard]] mapped_type& operator[](const enbt::key& key_value) {
+            return proxy->operator[](key_value.name());
+        }
+
         [[nodiscard]] mapped_type& at(const key_type& key_value) {
             return proxy->at(key_value);
         }
@@ -2103,6 +2488,14 @@ namespace enbt {
             return proxy->at(key_value);
         }
 
+        [[nodiscard]] mapped_type& at(const enbt::key& key_value) {
+            return proxy->at(key_value.name());
+        }
+
+        [[nodiscard]] const mapped_type& at(const enbt::key& key_value) const {
+            return proxy->at(key_value.name());
+        }
+
         compound_ref& operator=(const compound_ref& tag) {
             proxy = tag.proxy;
             return *this;
@@ -2139,6 +2532,10 @@ namespace enbt {
             return proxy->erase(key_value);
         }
 
+        size_type erase(const enbt::key& key_value) {
+            return proxy->erase(key_value.name());
+        }
+
         [[nodiscard]] node_type extract(const key_type& key_value) {
             return proxy->extract(key_value);
         }
@@ -2151,6 +2548,14 @@ namespace enbt {
             return proxy->find(key_value);
         }
 
+        [[nodiscard]] decltype(auto) find(const enbt::key& key_value) {
+            return proxy->find(key_value.name());
+        }
+
+        [[nodiscard]] decltype(auto) find(const enbt::key& key_value) const {
+            return proxy->find(key_value.name());
+        }
+
         [[nodiscard]] iterator begin() {
             return proxy->begin();
         }
@@ -2168,32 +2573,26 @@ namespace enbt {
         }
     };
 
-    class fixed_array_ref {
+    class fixed_array_const_ref {
+        friend class fixed_array_ref;
+        friend class fixed_array;
+
     protected:
         enbt::type_id fixed_type = enbt::type::none;
         std::vector<value>* proxy;
-        bool as_const = false;
-
-        friend class fixed_array;
-
-        fixed_array_ref(value& abstract) {
-            proxy = std::get<std::vector<value>*>(abstract.content());
-            as_const = false;
-        }
 
-        fixed_array_ref(const value& abstract) {
+        fixed_array_const_ref(const value& abstract) {
             proxy = std::get<std::vector<value>*>(abstract.content());
-            as_const = true;
         }
 
-        fixed_array_ref() {
+        fixed_array_const_ref() {
             proxy = nullptr;
         }
 
     public:
-        [[nodiscard]] static fixed_array_ref make_ref(value& enbt) {
+        [[nodiscard]] static fixed_array_const_ref make_ref(const value& enbt) {
             if (enbt.get_type() == enbt::type::array)
-                return fixed_array_ref(enbt);
+                return fixed_array_const_ref(enbt);
             else if (enbt.get_type() == enbt::type::darray) {
                 if (enbt.size()) {
                     enbt::type_id tid_check = enbt[0].type_id();
@@ -2201,13 +2600,126 @@ namespace enbt {
                         if (!check.type_equal(tid_check))
                             throw enbt::exception("value is not a fixed array");
                 }
-                enbt.data_type_id.type = enbt::type::array;
-                return fixed_array_ref(enbt);
+                return fixed_array_const_ref(enbt);
             } else
                 throw enbt::exception("value is not a fixed array");
         }
 
-        [[nodiscard]] static fixed_array_ref make_ref(const value& enbt) {
+        using value_type = value;
+        using allocator_type = std::vector<value>::allocator_type;
+        using pointer = std::vector<value>::pointer;
+        using const_pointer = std::vector<value>::const_pointer;
+        using reference = value&;
+        using const_reference = const value&;
+        using size_type = std::vector<value>::size_type;
+        using difference_type = std::vector<value>::difference_type;
+        using iterator = std::vector<value>::iterator;
+        using const_iterator = std::vector<value>::const_iterator;
+        using reverse_iterator = std::vector<value>::reverse_iterator;
+        using const_reverse_iterator = std::vector<value>::const_reverse_iterator;
+
+        fixed_array_const_ref(const fixed_array_const_ref& tag) {
+            fixed_type = tag.fixed_type;
+            proxy = tag.proxy;
+        }
+
+        fixed_array_const_ref(fixed_array_const_ref&& tag) {
+            fixed_type = tag.fixed_type;
+            proxy = tag.proxy;
+        }
+
+        fixed_array_const_ref& operator=(const fixed_array_const_ref& tag) {
+            fixed_type = tag.fixed_type;
+            proxy = tag.proxy;
+            return *this;
+        }
+
+        fixed_array_const_ref& operator=(fixed_array_const_ref&& tag) {
+            fixed_type = tag.fixed_type;
+            proxy = tag.proxy;
+            return *this;
+        }
+
+        [[nodiscard]] const value& operator[](std::size_t index) const noexcept {
+            return (*proxy)[index];
+        }
+
+        [[nodiscard]] const value& at(size_type index) const {
+            return proxy->at(index);
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return proxy->size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return proxy->empty();
+        }
+
+        [[nodiscard]] const_iterator begin() const {
+            return proxy->cbegin();
+        }
+
+        [[nodiscard]] const_iterator end() const {
+            return proxy->cend();
+        }
+
+        [[nodiscard]] const_iterator cbegin() const {
+            return proxy->cbegin();
+        }
+
+        [[nodiscard]] const_iterator cend() const {
+            return proxy->cend();
+        }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const {
+            return proxy->crbegin();
+        }
+
+        [[nodiscard]] const_reverse_iterator rend() const {
+            return proxy->crend();
+        }
+
+        [[nodiscard]] const_reverse_iterator crbegin() const {
+            return proxy->crbegin();
+        }
+
+        [[nodiscard]] const_reverse_iterator crend() const {
+            return proxy->crend();
+        }
+
+        [[nodiscard]] size_t max_size() const noexcept {
+            return proxy->max_size();
+        }
+
+        [[nodiscard]] const value& front() const {
+            return proxy->front();
+        }
+
+        [[nodiscard]] const value& back() const {
+            return proxy->back();
+        }
+
+        std::strong_ordering operator<=>(const fixed_array_const_ref& enbt) const {
+            return __impl__::compare_arrays(*proxy, *enbt.proxy);
+        }
+    };
+
+    class fixed_array_ref : public fixed_array_const_ref {
+        friend class fixed_array;
+
+    protected:
+        fixed_array_ref(value& abstract) {
+            abstract.unshare();
+            proxy = std::get<std::vector<value>*>(abstract.content());
+        }
+
+        fixed_array_ref() {
+            proxy = nullptr;
+        }
+
+    public:
+        [[nodiscard]] static fixed_array_ref make_ref(value& enbt) {
             if (enbt.get_type() == enbt::type::array)
                 return fixed_array_ref(enbt);
             else if (enbt.get_type() == enbt::type::darray) {
@@ -2217,23 +2729,15 @@ namespace enbt {
                         if (!check.type_equal(tid_check))
                             throw enbt::exception("value is not a fixed array");
                 }
+                enbt.data_type_id.type = enbt::type::array;
                 return fixed_array_ref(enbt);
             } else
                 throw enbt::exception("value is not a fixed array");
         }
 
-        using value_type = value;
-        using allocator_type = std::vector<value>::allocator_type;
-        using pointer = std::vector<value>::pointer;
-        using const_pointer = std::vector<value>::const_pointer;
-        using reference = value&;
-        using const_reference = const value&;
-        using size_type = std::vector<value>::size_type;
-        using difference_type = std::vector<value>::difference_type;
-        using iterator = std::vector<value>::iterator;
-        using const_iterator = std::vector<value>::const_iterator;
-        using reverse_iterator = std::vector<value>::reverse_iterator;
-        using const_reverse_iterator = std::vector<value>::const_reverse_iterator;
+        [[nodiscard]] static fixed_array_const_ref make_ref(const value& enbt) {
+            return fixed_array_const_ref::make_ref(enbt);
+        }
 
         fixed_array_ref(const fixed_array_ref& tag) {
             fixed_type = tag.fixed_type;
@@ -2259,8 +2763,6 @@ namespace enbt {
 
         template <class T>
         void set(std::size_t index, T&& _value) {
-            if (as_const)
-                throw enbt::exception("This array is constant");
             value to_set(std::forward<T>(_value));
 
             if (index != 0 && fixed_type.type != enbt::type::none) {
@@ -2287,8 +2789,6 @@ namespace enbt {
 
         template <class T>
         void push_back(T&& _value) {
-            if (as_const)
-                throw enbt::exception("This array is constant");
             value to_set(std::forward<T>(_value));
 
 
@@ -2301,19 +2801,9 @@ namespace enbt {
         }
 
         void pop_back() {
-            if (as_const)
-                throw enbt::exception("This array is constant");
             (*proxy).pop_back();
         }
 
-        [[nodiscard]] const value& operator[](std::size_t index) const noexcept {
-            return (*proxy)[index];
-        }
-
-        [[nodiscard]] const value& at(size_type index) const {
-            return proxy->at(index);
-        }
-
         void remove(std::size_t index) {
             proxy->erase(proxy->begin() + index);
         }
@@ -2321,8 +2811,65 @@ namespace enbt {
         void reserve(std::size_t count) {
             proxy->reserve(count);
         }
+    };
 
-        [[nodiscard]] std::size_t size() const {
+    class dynamic_array_const_ref {
+        friend class dynamic_array_ref;
+        friend class dynamic_array;
+
+    protected:
+        std::vector<value>* proxy;
+
+        dynamic_array_const_ref(const value& abstract) {
+            proxy = std::get<std::vector<value>*>(abstract.content());
+        }
+
+        dynamic_array_const_ref() {
+            proxy = nullptr;
+        }
+
+    public:
+        [[nodiscard]] static dynamic_array_const_ref make_ref(const value& enbt) {
+            if (enbt.get_type() == enbt::type::darray)
+                return dynamic_array_const_ref(enbt);
+            else if (enbt.get_type() == enbt::type::array)
+                return dynamic_array_const_ref(enbt);
+            else
+                throw enbt::exception("value is not a dynamic array");
+        }
+
+        using value_type = value;
+        using allocator_type = std::vector<value>::allocator_type;
+        using pointer = std::vector<value>::pointer;
+        using const_pointer = std::vector<value>::const_pointer;
+        using reference = value&;
+        using const_reference = const value&;
+        using size_type = std::vector<value>::size_type;
+        using difference_type = std::vector<value>::difference_type;
+        using iterator = std::vector<value>::iterator;
+        using const_iterator = std::vector<value>::const_iterator;
+        using reverse_iterator = std::vector<value>::reverse_iterator;
+        using const_reverse_iterator = std::vector<value>::const_reverse_iterator;
+
+        dynamic_array_const_ref(const dynamic_array_const_ref& tag) {
+            proxy = tag.proxy;
+        }
+
+        dynamic_array_const_ref(dynamic_array_const_ref&& tag) noexcept {
+            proxy = tag.proxy;
+        }
+
+        dynamic_array_const_ref& operator=(const dynamic_array_const_ref& tag) {
+            proxy = tag.proxy;
+            return *this;
+        }
+
+        dynamic_array_const_ref& operator=(dynamic_array_const_ref&& tag) noexcept {
+            proxy = tag.proxy;
+            return *this;
+        }
+
+        [[nodiscard]] size_type size() const {
             return proxy->size();
         }
 
@@ -2330,6 +2877,10 @@ namespace enbt {
             return proxy->empty();
         }
 
+        [[nodiscard]] const value* data() const {
+            return proxy->data();
+        }
+
         [[nodiscard]] const_iterator begin() const {
             return proxy->cbegin();
         }
@@ -2362,10 +2913,18 @@ namespace enbt {
             return proxy->crend();
         }
 
-        [[nodiscard]] size_t max_size() const noexcept {
+        [[nodiscard]] std::size_t max_size() const noexcept {
             return proxy->max_size();
         }
 
+        [[nodiscard]] const value& operator[](size_type index) const noexcept {
+            return proxy->operator[](index);
+        }
+
+        [[nodiscard]] const value& at(size_type index) const {
+            return proxy->at(index);
+        }
+
         [[nodiscard]] const value& front() const {
             return proxy->front();
         }
@@ -2374,17 +2933,17 @@ namespace enbt {
             return proxy->back();
         }
 
-        std::strong_ordering operator<=>(const fixed_array_ref& enbt) const {
-            return *proxy == *enbt.proxy ? std::strong_ordering::equal : std::strong_ordering::less;
+        std::strong_ordering operator<=>(const dynamic_array_const_ref& enbt) const {
+            return __impl__::compare_arrays(*proxy, *enbt.proxy);
         }
     };
 
-    class dynamic_array_ref {
-    protected:
-        std::vector<value>* proxy;
+    class dynamic_array_ref : public dynamic_array_const_ref {
         friend class dynamic_array;
 
-        dynamic_array_ref(const value& abstract) {
+    protected:
+        dynamic_array_ref(value& abstract) {
+            abstract.unshare();
             proxy = std::get<std::vector<value>*>(abstract.content());
         }
 
@@ -2403,28 +2962,10 @@ namespace enbt {
                 throw enbt::exception("value is not a dynamic array");
         }
 
-        [[nodiscard]] static const dynamic_array_ref make_ref(const value& enbt) {
-            if (enbt.get_type() == enbt::type::darray)
-                return dynamic_array_ref(enbt);
-            else if (enbt.get_type() == enbt::type::array)
-                return dynamic_array_ref(enbt);
-            else
-                throw enbt::exception("value is not a dynamic array");
+        [[nodiscard]] static dynamic_array_const_ref make_ref(const value& enbt) {
+            return dynamic_array_const_ref::make_ref(enbt);
         }
 
-        using value_type = value;
-        using allocator_type = std::vector<value>::allocator_type;
-        using pointer = std::vector<value>::pointer;
-        using const_pointer = std::vector<value>::const_pointer;
-        using reference = value&;
-        using const_reference = const value&;
-        using size_type = std::vector<value>::size_type;
-        using difference_type = std::vector<value>::difference_type;
-        using iterator = std::vector<value>::iterator;
-        using const_iterator = std::vector<value>::const_iterator;
-        using reverse_iterator = std::vector<value>::reverse_iterator;
-        using const_reverse_iterator = std::vector<value>::const_reverse_iterator;
-
         dynamic_array_ref(const dynamic_array_ref& tag) {
             proxy = tag.proxy;
         }
@@ -2483,14 +3024,6 @@ namespace enbt {
             proxy->resize(siz, def_init);
         }
 
-        [[nodiscard]] size_type size() const {
-            return proxy->size();
-        }
-
-        [[nodiscard]] bool empty() const {
-            return proxy->empty();
-        }
-
         void assign(size_type new_size, const value& val) {
             proxy->assign(new_size, val);
         }
@@ -2551,14 +3084,6 @@ namespace enbt {
             return proxy->cend();
         }
 
-        [[nodiscard]] const_iterator cbegin() const {
-            return proxy->cbegin();
-        }
-
-        [[nodiscard]] const_iterator cend() const {
-            return proxy->cend();
-        }
-
         [[nodiscard]] reverse_iterator rbegin() {
             return proxy->rbegin();
         }
@@ -2575,18 +3100,6 @@ namespace enbt {
             return proxy->crend();
         }
 
-        [[nodiscard]] const_reverse_iterator crbegin() const {
-            return proxy->crbegin();
-        }
-
-        [[nodiscard]] const_reverse_iterator crend() const {
-            return proxy->crend();
-        }
-
-        [[nodiscard]] std::size_t max_size() const noexcept {
-            return proxy->max_size();
-        }
-
         [[nodiscard]] value& operator[](size_type index) noexcept {
             return proxy->operator[](index);
         }
@@ -2618,10 +3131,6 @@ namespace enbt {
         [[nodiscard]] value& back() {
             return proxy->back();
         }
-
-        std::strong_ordering operator<=>(const dynamic_array_ref& enbt) const {
-            return *proxy == *enbt.proxy ? std::strong_ordering::equal : std::strong_ordering::less;
-        }
     };
 
     template <class T>
@@ -2699,7 +3208,7 @@ namespace enbt {
         }
 
         [[nodiscard]] T at(std::size_t index) const {
-            if (size_ >= index)
+            if (index >= size_)
                 throw std::out_of_range("invalid simple_array index");
             return proxy[index];
         }
@@ -2720,35 +3229,83 @@ namespace enbt {
             return proxy;
         }
 
-        [[nodiscard]] const T* cend() const {
-            return proxy + size_;
+        [[nodiscard]] const T* cend() const {
+            return proxy + size_;
+        }
+
+        [[nodiscard]] const T* rbegin() const {
+            return proxy + size_;
+        }
+
+        [[nodiscard]] const T* rend() const {
+            return proxy;
+        }
+
+        [[nodiscard]] const T* crbegin() const {
+            return proxy + size_;
+        }
+
+        [[nodiscard]] const T* crend() const {
+            return proxy;
+        }
+
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        [[nodiscard]] __impl__::sarray_sum_t<T> sum() const noexcept {
+            return __impl__::sarray_sum(proxy, size_);
+        }
+
+        [[nodiscard]] T min() const {
+            if (!size_)
+                throw std::out_of_range("simple_array is empty");
+            return __impl__::sarray_min(proxy, size_);
+        }
+
+        [[nodiscard]] T max() const {
+            if (!size_)
+                throw std::out_of_range("simple_array is empty");
+            return __impl__::sarray_max(proxy, size_);
+        }
+
+        [[nodiscard]] std::size_t count(T value) const noexcept {
+            return __impl__::sarray_count(proxy, size_, value);
+        }
+
+        //index of the first item equal to value or npos
+        [[nodiscard]] std::size_t find(T value) const noexcept {
+            std::size_t index = __impl__::sarray_find(proxy, size_, value);
+            return index == size_ ? npos : index;
+        }
+
+        [[nodiscard]] bool contains(T value) const noexcept {
+            return __impl__::sarray_find(proxy, size_, value) != size_;
         }
 
-        [[nodiscard]] const T* rbegin() const {
-            return proxy + size_;
+        //running totals into out, which must hold size() items and may alias this array
+        void prefix_sum(T* out) const noexcept {
+            __impl__::sarray_prefix_sum(proxy, size_, out);
         }
 
-        [[nodiscard]] const T* rend() const {
-            return proxy;
+        [[nodiscard]] bool equal(const simple_array_const_ref& other) const noexcept {
+            return size_ == other.size_ && __impl__::sarray_mismatch(proxy, other.proxy, size_) == size_;
         }
 
-        [[nodiscard]] const T* crbegin() const {
-            return proxy + size_;
+        //item by item, a prefix orders before the longer array
+        [[nodiscard]] std::strong_ordering lexicographic_compare(const simple_array_const_ref& other) const noexcept {
+            if (auto order = __impl__::sarray_compare(proxy, other.proxy, std::min(size_, other.size_)); order != 0)
+                return order;
+            return size_ <=> other.size_;
         }
 
-        [[nodiscard]] const T* crend() const {
-            return proxy;
+        [[nodiscard]] bool operator==(const simple_array_const_ref& other) const noexcept {
+            return equal(other);
         }
 
+        //by size first, then item by item
         std::strong_ordering operator<=>(const simple_array_const_ref& enbt) const {
             if (size_ != enbt.size_)
                 return size_ < enbt.size_ ? std::strong_ordering::less : std::strong_ordering::greater;
-
-            for (std::size_t i = 0; i < size_; ++i) {
-                if (proxy[i] != enbt.proxy[i])
-                    return proxy[i] < enbt.proxy[i] ? std::strong_ordering::less : std::strong_ordering::greater;
-            }
-            return std::strong_ordering::equal;
+            return __impl__::sarray_compare(proxy, enbt.proxy, size_);
         }
     };
 
@@ -2772,6 +3329,7 @@ namespace enbt {
         }();
 
         simple_array_ref(value& abstract) {
+            abstract.unshare();
             proxy = std::get<T*>(abstract.content());
             size_ = abstract.size();
         }
@@ -2837,13 +3395,13 @@ namespace enbt {
         }
 
         [[nodiscard]] T at(std::size_t index) const {
-            if (size_ >= index)
+            if (index >= size_)
                 throw std::out_of_range("invalid simple_array index");
             return proxy[index];
         }
 
         [[nodiscard]] T& at(std::size_t index) {
-            if (size_ >= index)
+            if (index >= size_)
                 throw std::out_of_range("invalid simple_array index");
             return proxy[index];
         }
@@ -2900,15 +3458,67 @@ namespace enbt {
             return proxy;
         }
 
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        [[nodiscard]] __impl__::sarray_sum_t<T> sum() const noexcept {
+            return __impl__::sarray_sum(proxy, size_);
+        }
+
+        [[nodiscard]] T min() const {
+            if (!size_)
+                throw std::out_of_range("simple_array is empty");
+            return __impl__::sarray_min(proxy, size_);
+        }
+
+        [[nodiscard]] T max() const {
+            if (!size_)
+                throw std::out_of_range("simple_array is empty");
+            return __impl__::sarray_max(proxy, size_);
+        }
+
+        [[nodiscard]] std::size_t count(T value) const noexcept {
+            return __impl__::sarray_count(proxy, size_, value);
+        }
+
+        //index of the first item equal to value or npos
+        [[nodiscard]] std::size_t find(T value) const noexcept {
+            std::size_t index = __impl__::sarray_find(proxy, size_, value);
+            return index == size_ ? npos : index;
+        }
+
+        [[nodiscard]] bool contains(T value) const noexcept {
+            return __impl__::sarray_find(proxy, size_, value) != size_;
+        }
+
+        //running totals into out, which must hold size() items and may alias this array
+        void prefix_sum(T* out) const noexcept {
+            __impl__::sarray_prefix_sum(proxy, size_, out);
+        }
+
+        void prefix_sum() noexcept {
+            __impl__::sarray_prefix_sum(proxy, size_, proxy);
+        }
+
+        [[nodiscard]] bool equal(const simple_array_ref& other) const noexcept {
+            return size_ == other.size_ && __impl__::sarray_mismatch(proxy, other.proxy, size_) == size_;
+        }
+
+        //item by item, a prefix orders before the longer array
+        [[nodiscard]] std::strong_ordering lexicographic_compare(const simple_array_ref& other) const noexcept {
+            if (auto order = __impl__::sarray_compare(proxy, other.proxy, std::min(size_, other.size_)); order != 0)
+                return order;
+            return size_ <=> other.size_;
+        }
+
+        [[nodiscard]] bool operator==(const simple_array_ref& other) const noexcept {
+            return equal(other);
+        }
+
+        //by size first, then item by item
         std::strong_ordering operator<=>(const simple_array_ref& enbt) const {
             if (size_ != enbt.size_)
                 return size_ < enbt.size_ ? std::strong_ordering::less : std::strong_ordering::greater;
-
-            for (std::size_t i = 0; i < size_; ++i) {
-                if (proxy[i] != enbt.proxy[i])
-                    return proxy[i] < enbt.proxy[i] ? std::strong_ordering::less : std::strong_ordering::greater;
-            }
-            return std::strong_ordering::equal;
+            return __impl__::sarray_compare(proxy, enbt.proxy, size_);
         }
     };
 
@@ -2920,41 +3530,49 @@ namespace enbt {
     public:
         compound()
             : holder(std::unordered_map<std::string, value>()) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(const compound& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(compound&& move) {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(std::unordered_map<std::string, value>&& init)
             : holder(init) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(const std::unordered_map<std::string, value>& init)
             : holder(init) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(std::initializer_list<std::pair<const std::string, value>> init)
             : holder(std::unordered_map<std::string, value>(init)) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(compound_ref ref)
             : holder(*ref.proxy) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
         compound(compound_const_ref ref)
             : holder(*ref.proxy) {
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
         }
 
@@ -2962,6 +3580,7 @@ namespace enbt {
             if (!copy.is_compound())
                 throw enbt::exception("value is not a compound");
             holder = copy;
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
             return *this;
         }
@@ -2970,18 +3589,21 @@ namespace enbt {
             if (!copy.is_compound())
                 throw enbt::exception("value is not a compound");
             holder = std::move(copy);
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
             return *this;
         }
 
         compound& operator=(const compound& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
             return *this;
         }
 
         compound& operator=(compound&& move) {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::unordered_map<std::string, value>*>(holder.content());
             return *this;
         }
@@ -3002,6 +3624,276 @@ namespace enbt {
         [[nodiscard]] compound merge(std::unordered_map<std::string, value>&& move) &&;
     };
 
+    //compound storage without per key nodes, entries are kept in one vector
+    // up to small_limit entries the vector is sorted by key and lookups scan it comparing lengths first,
+    // past it an open addressing index of control bytes and entry slots is built over the vector
+    // iteration follows the vector, sorted in small mode and insertion order after that
+    // keys must not be changed through iterators
+    class flat_compound {
+    public:
+        using key_type = std::string;
+        using mapped_type = value;
+        using value_type = std::pair<const std::string, value>;
+        using size_type = std::size_t;
+
+    private:
+        //entries are moved while sorted and erased, so the stored key is not const
+        using entry_type = std::pair<std::string, value>;
+
+        //dereferencing yields a pair of references with a const key, the entry can't be renamed past the index
+        template <class Base, class Mapped>
+        class basic_iterator {
+            Base position;
+
+            friend class flat_compound;
+            template <class, class>
+            friend class basic_iterator;
+
+            basic_iterator(Base position) noexcept
+                : position(position) {}
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const std::string&, Mapped&>;
+            using reference = value_type;
+
+            struct pointer {
+                reference item;
+
+                const reference* operator->() const noexcept {
+                    return &item;
+                }
+            };
+
+            basic_iterator() = default;
+
+            template <class OtherBase, class OtherMapped>
+            basic_iterator(const basic_iterator<OtherBase, OtherMapped>& other) noexcept
+                requires(std::is_const_v<Mapped> && !std::is_const_v<OtherMapped>)
+                : position(other.position) {}
+
+            reference operator*() const noexcept {
+                return {position->first, position->second};
+            }
+
+            pointer operator->() const noexcept {
+                return {**this};
+            }
+
+            basic_iterator& operator++() noexcept {
+                ++position;
+                return *this;
+            }
+
+            basic_iterator operator++(int) noexcept {
+                return basic_iterator(position++);
+            }
+
+            basic_iterator& operator--() noexcept {
+                --position;
+                return *this;
+            }
+
+            basic_iterator operator--(int) noexcept {
+                return basic_iterator(position--);
+            }
+
+            difference_type operator-(const basic_iterator& other) const noexcept {
+                return position - other.position;
+            }
+
+            bool operator==(const basic_iterator& other) const noexcept {
+                return position == other.position;
+            }
+
+            bool operator!=(const basic_iterator& other) const noexcept {
+                return position != other.position;
+            }
+        };
+
+    public:
+        using iterator = basic_iterator<std::vector<entry_type>::iterator, value>;
+        using const_iterator = basic_iterator<std::vector<entry_type>::const_iterator, const value>;
+
+        static constexpr size_type small_limit = 16;
+
+    private:
+        std::vector<entry_type> entries;
+        //index, only filled past small_limit
+        std::vector<std::size_t> hashes; //hash of each entry key, parallel to entries
+        std::vector<std::uint8_t> control; //empty, deleted or 7 low bits of the hash
+        std::vector<std::uint32_t> slots; //entry index of each used control byte
+        size_type tombstones = 0;
+
+        size_type find_index(std::string_view key) const;
+        size_type find_index(std::string_view key, std::size_t hash) const;
+        size_type find_slot(std::size_t hash, size_type entry) const;
+        std::pair<size_type, bool> emplace_key(std::string_view key);
+        std::pair<size_type, bool> emplace_key(std::string_view key, std::size_t hash);
+        void insert_slot(std::size_t hash, size_type entry);
+        void rebuild_index(size_type min_capacity);
+        void erase_index(size_type entry);
+
+    public:
+        flat_compound() = default;
+        flat_compound(const flat_compound&) = default;
+        flat_compound(flat_compound&&) noexcept = default;
+        flat_compound(std::initializer_list<value_type> list);
+        explicit flat_compound(const std::unordered_map<std::string, value>& compound);
+        explicit flat_compound(std::unordered_map<std::string, value>&& compound);
+        //throws enbt::exception if value is not a compound
+        explicit flat_compound(const value& compound);
+        explicit flat_compound(value&& compound);
+
+        flat_compound& operator=(const flat_compound&) = default;
+        flat_compound& operator=(flat_compound&&) noexcept = default;
+
+        [[nodiscard]] iterator find(std::string_view key) {
+            return iterator(entries.begin() + find_index(key));
+        }
+
+        [[nodiscard]] const_iterator find(std::string_view key) const {
+            return const_iterator(entries.begin() + find_index(key));
+        }
+
+        [[nodiscard]] bool contains(std::string_view key) const {
+            return find_index(key) != entries.size();
+        }
+
+        [[nodiscard]] size_type count(std::string_view key) const {
+            return contains(key);
+        }
+
+        //lookups by interned key reuse its hash
+        [[nodiscard]] iterator find(const enbt::key& key) {
+            return iterator(entries.begin() + find_index(key, key.hash()));
+        }
+
+        [[nodiscard]] const_iterator find(const enbt::key& key) const {
+            return const_iterator(entries.begin() + find_index(key, key.hash()));
+        }
+
+        [[nodiscard]] bool contains(const enbt::key& key) const {
+            return find_index(key, key.hash()) != entries.size();
+        }
+
+        [[nodiscard]] size_type count(const enbt::key& key) const {
+            return contains(key);
+        }
+
+        //throws std::out_of_range if key not found
+        [[nodiscard]] value& at(std::string_view key);
+        [[nodiscard]] const value& at(std::string_view key) const;
+        [[nodiscard]] value& at(const enbt::key& key);
+        [[nodiscard]] const value& at(const enbt::key& key) const;
+
+        value& operator[](std::string_view key) {
+            return entries[emplace_key(key).first].second;
+        }
+
+        value& operator[](const enbt::key& key) {
+            return entries[emplace_key(key, key.hash()).first].second;
+        }
+
+        std::pair<iterator, bool> insert(const value_type& item) {
+            return try_emplace(item.first, item.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& item) {
+            return try_emplace(item.first, std::move(item.second));
+        }
+
+        template <class... Ts>
+        std::pair<iterator, bool> try_emplace(std::string_view key, Ts&&... values) {
+            auto [index, inserted] = emplace_key(key);
+            if constexpr (sizeof...(Ts) != 0)
+                if (inserted) {
+                    try {
+                        entries[index].second = value(std::forward<Ts>(values)...);
+                    } catch (...) {
+                        erase(const_iterator(entries.cbegin() + index));
+                        throw;
+                    }
+                }
+            return {iterator(entries.begin() + index), inserted};
+        }
+
+        template <class T>
+        std::pair<iterator, bool> insert_or_assign(std::string_view key, T&& val) {
+            value set(std::forward<T>(val));
+            auto [index, inserted] = emplace_key(key);
+            entries[index].second = std::move(set);
+            return {iterator(entries.begin() + index), inserted};
+        }
+
+        size_type erase(std::string_view key);
+        //returns iterator to the entry that took the place of the erased one
+        iterator erase(const_iterator where);
+        void clear() noexcept;
+        void reserve(size_type count);
+
+        [[nodiscard]] size_type size() const noexcept {
+            return entries.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return entries.empty();
+        }
+
+        //true when lookups go through the open addressing index
+        [[nodiscard]] bool is_indexed() const noexcept {
+            return !control.empty();
+        }
+
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator(entries.begin());
+        }
+
+        [[nodiscard]] iterator end() noexcept {
+            return iterator(entries.end());
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return const_iterator(entries.begin());
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return const_iterator(entries.end());
+        }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept {
+            return const_iterator(entries.cbegin());
+        }
+
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return const_iterator(entries.cend());
+        }
+
+        //same rules as value::merge, nested compounds are merged, other values replaced
+        flat_compound& merge(const flat_compound& copy) &;
+        flat_compound& merge(flat_compound&& move) &;
+        flat_compound& merge(const value& copy) &;
+        flat_compound& merge(value&& move) &;
+
+        [[nodiscard]] bool operator==(const flat_compound& other) const;
+
+        [[nodiscard]] bool operator!=(const flat_compound& other) const {
+            return !operator==(other);
+        }
+
+        [[nodiscard]] value to_value() const&;
+        [[nodiscard]] value to_value() &&;
+
+        operator value() const& {
+            return to_value();
+        }
+
+        operator value() && {
+            return std::move(*this).to_value();
+        }
+    };
+
     class fixed_array : public fixed_array_ref {
         value holder;
 
@@ -3018,26 +3910,31 @@ namespace enbt {
 
         fixed_array()
             : holder(std::vector<value>(), enbt::type::array) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         fixed_array(std::size_t array_size)
             : holder(std::vector<value>(array_size), enbt::type::array) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         fixed_array(const fixed_array& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         fixed_array(fixed_array&& move) noexcept {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
-        fixed_array(fixed_array_ref ref)
+        fixed_array(fixed_array_const_ref ref)
             : holder(*ref.proxy, ref.fixed_type) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             fixed_type = ref.fixed_type;
         }
@@ -3046,6 +3943,7 @@ namespace enbt {
             if (!copy.is_fixed_array())
                 throw enbt::exception("value is not a fixed array");
             holder = copy;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
@@ -3054,18 +3952,21 @@ namespace enbt {
             if (!move.is_fixed_array())
                 throw enbt::exception("value is not a fixed array");
             holder = std::move(move);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
 
         fixed_array& operator=(const fixed_array& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
 
         fixed_array& operator=(fixed_array&& move) noexcept {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
@@ -3104,31 +4005,37 @@ namespace enbt {
 
         dynamic_array()
             : holder(std::vector<value>(), enbt::type::darray) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         dynamic_array(const std::vector<value>& arr)
             : holder(arr, enbt::type::darray) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         dynamic_array(std::vector<value>&& arr)
             : holder(std::move(arr), enbt::type::darray) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         dynamic_array(const dynamic_array& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
         dynamic_array(dynamic_array&& move) noexcept {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
-        dynamic_array(dynamic_array_ref ref)
+        dynamic_array(dynamic_array_const_ref ref)
             : holder(*ref.proxy) {
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
         }
 
@@ -3136,6 +4043,7 @@ namespace enbt {
             if (!copy.is_dyn_array())
                 throw enbt::exception("value is not a dynamic array");
             holder = copy;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
@@ -3144,18 +4052,21 @@ namespace enbt {
             if (!copy.is_dyn_array())
                 throw enbt::exception("value is not a dynamic array");
             holder = std::move(copy);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
 
         dynamic_array& operator=(const dynamic_array& copy) {
             holder = copy.holder;
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
 
         dynamic_array& operator=(dynamic_array&& move) noexcept {
             holder = std::move(move.holder);
+            holder.unshare();
             proxy = std::get<std::vector<value>*>(holder.content());
             return *this;
         }
@@ -3197,36 +4108,42 @@ namespace enbt {
 
         simple_array(std::size_t array_size)
             : holder(enbt_type, array_size) {
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
         }
 
         simple_array(const simple_array& copy)
             : holder(copy.holder) {
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
         }
 
         simple_array(simple_array&& move) noexcept
             : holder(std::move(move.holder)) {
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
         }
 
         simple_array(simple_array_ref<T> ref)
             : holder(*ref.proxy, ref.size_) {
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<std::vector<value>*>(holder.content());
             simple_array_ref<T>::size_ = ref.size_;
         }
 
         simple_array(simple_array_const_ref<T> ref)
             : holder(*ref.proxy, ref.size_) {
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<std::vector<value>*>(holder.content());
             simple_array_ref<T>::size_ = ref.size_;
         }
 
         simple_array& operator=(const simple_array& copy) {
             holder = copy.holder;
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
 
@@ -3235,6 +4152,7 @@ namespace enbt {
 
         simple_array& operator=(simple_array&& move) noexcept {
             holder = std::move(move.holder);
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
             return *this;
@@ -3244,6 +4162,7 @@ namespace enbt {
             if (copy.get_type() != enbt_type.type || copy.get_type_len() != enbt_type.length || copy.get_type_sign() != enbt_type.is_signed)
                 throw enbt::exception("value is not a same simple_array");
             holder = copy;
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
             return *this;
@@ -3253,6 +4172,7 @@ namespace enbt {
             if (move.get_type() != enbt_type.type || move.get_type_len() != enbt_type.length || move.get_type_sign() != enbt_type.is_signed)
                 throw enbt::exception("value is not a same simple_array");
             holder = std::move(move);
+            holder.unshare();
             simple_array_ref<T>::proxy = std::get<T*>(holder.content());
             simple_array_ref<T>::size_ = holder.size();
             return *this;
@@ -3344,8 +4264,254 @@ namespace enbt {
         }
 
         std::strong_ordering operator<=>(const bit& enbt) const {
-            return holder == enbt.holder ? std::strong_ordering::equal : std::strong_ordering::less;
+            return holder <=> enbt.holder;
+        }
+    };
+
+    //view over packed bits, bit i is bit i % 64 of words[i / 64]
+    // bits past size() in the last word are kept zero so whole word operations stay exact
+    class bit_array_ref {
+    protected:
+        std::uint64_t* words = nullptr;
+        std::size_t size_ = 0;
+
+        static constexpr std::size_t word_bits = 64;
+
+        static constexpr std::size_t words_for(std::size_t bits) noexcept {
+            return (bits + word_bits - 1) / word_bits;
+        }
+
+        std::uint64_t tail_mask() const noexcept {
+            std::size_t rem = size_ % word_bits;
+            return rem ? (std::uint64_t(1) << rem) - 1 : ~std::uint64_t(0);
+        }
+
+        void clear_tail() noexcept {
+            if (size_)
+                words[words_for(size_) - 1] &= tail_mask();
+        }
+
+        bit_array_ref() = default;
+
+    public:
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        bit_array_ref(std::uint64_t* words, std::size_t size)
+            : words(words), size_(size) {}
+
+        bit_array_ref(const bit_array_ref&) = default;
+        bit_array_ref& operator=(const bit_array_ref&) = default;
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] std::size_t word_count() const noexcept {
+            return words_for(size_);
+        }
+
+        [[nodiscard]] std::uint64_t* data() noexcept {
+            return words;
+        }
+
+        [[nodiscard]] const std::uint64_t* data() const noexcept {
+            return words;
+        }
+
+        [[nodiscard]] bool test(std::size_t index) const noexcept {
+            return (words[index / word_bits] >> (index % word_bits)) & 1;
+        }
+
+        [[nodiscard]] bool operator[](std::size_t index) const noexcept {
+            return test(index);
+        }
+
+        [[nodiscard]] bool at(std::size_t index) const {
+            if (index >= size_)
+                throw std::out_of_range("invalid bit_array index");
+            return test(index);
+        }
+
+        bit_array_ref& set(std::size_t index, bool value = true) noexcept {
+            std::uint64_t mask = std::uint64_t(1) << (index % word_bits);
+            if (value)
+                words[index / word_bits] |= mask;
+            else
+                words[index / word_bits] &= ~mask;
+            return *this;
+        }
+
+        bit_array_ref& reset(std::size_t index) noexcept {
+            return set(index, false);
+        }
+
+        bit_array_ref& flip(std::size_t index) noexcept {
+            words[index / word_bits] ^= std::uint64_t(1) << (index % word_bits);
+            return *this;
+        }
+
+        bit_array_ref& flip() noexcept {
+            for (std::size_t i = 0, n = word_count(); i < n; i++)
+                words[i] = ~words[i];
+            clear_tail();
+            return *this;
+        }
+
+        bit_array_ref& fill(bool value) noexcept {
+            std::fill_n(words, word_count(), value ? ~std::uint64_t(0) : 0);
+            clear_tail();
+            return *this;
+        }
+
+        [[nodiscard]] std::size_t count() const noexcept {
+            std::size_t res = 0;
+            for (std::size_t i = 0, n = word_count(); i < n; i++)
+                res += std::popcount(words[i]);
+            return res;
+        }
+
+        [[nodiscard]] bool any() const noexcept {
+            for (std::size_t i = 0, n = word_count(); i < n; i++)
+                if (words[i])
+                    return true;
+            return false;
+        }
+
+        [[nodiscard]] bool none() const noexcept {
+            return !any();
+        }
+
+        [[nodiscard]] bool all() const noexcept {
+            return count() == size_;
+        }
+
+        //npos when no bit with that value is found
+        [[nodiscard]] std::size_t find_first(bool value = true) const noexcept {
+            return find_next(0, value);
+        }
+
+        [[nodiscard]] std::size_t find_next(std::size_t pos, bool value = true) const noexcept;
+
+        //sizes must match, throws enbt::exception otherwise
+        bit_array_ref& operator&=(const bit_array_ref& other);
+        bit_array_ref& operator|=(const bit_array_ref& other);
+        bit_array_ref& operator^=(const bit_array_ref& other);
+
+        [[nodiscard]] bool operator==(const bit_array_ref& other) const noexcept {
+            return size_ == other.size_ && std::equal(words, words + word_count(), other.words);
+        }
+
+        [[nodiscard]] bool operator!=(const bit_array_ref& other) const noexcept {
+            return !operator==(other);
+        }
+
+        //array of bits, the same value the writer packs 8 per byte
+        [[nodiscard]] value to_value() const;
+
+        operator value() const {
+            return to_value();
+        }
+    };
+
+    class bit_array : public bit_array_ref {
+        std::vector<std::uint64_t> storage;
+
+        void sync() noexcept {
+            words = storage.data();
+        }
+
+    public:
+        bit_array() = default;
+
+        explicit bit_array(std::size_t size, bool value = false)
+            : storage(words_for(size), value ? ~std::uint64_t(0) : 0) {
+            size_ = size;
+            sync();
+            clear_tail();
+        }
+
+        bit_array(std::initializer_list<bool> list)
+            : bit_array(list.size()) {
+            std::size_t i = 0;
+            for (bool item : list)
+                set(i++, item);
+        }
+
+        //accepts array or darray of bits, throws enbt::exception otherwise
+        explicit bit_array(const value& abstract);
+
+        bit_array(const bit_array& copy)
+            : bit_array_ref(nullptr, copy.size_), storage(copy.storage) {
+            sync();
+        }
+
+        bit_array(bit_array&& move) noexcept
+            : bit_array_ref(nullptr, move.size_), storage(std::move(move.storage)) {
+            move.size_ = 0;
+            move.sync();
+            sync();
+        }
+
+        bit_array& operator=(const bit_array& copy) {
+            storage = copy.storage;
+            size_ = copy.size_;
+            sync();
+            return *this;
+        }
+
+        bit_array& operator=(bit_array&& move) noexcept {
+            storage = std::move(move.storage);
+            size_ = move.size_;
+            move.size_ = 0;
+            move.sync();
+            sync();
+            return *this;
+        }
+
+        void reserve(std::size_t bits) {
+            storage.reserve(words_for(bits));
+            sync();
+        }
+
+        void resize(std::size_t bits, bool value = false) {
+            std::size_t old = size_;
+            storage.resize(words_for(bits), value ? ~std::uint64_t(0) : 0);
+            sync();
+            if (value && bits > old && old % word_bits)
+                words[old / word_bits] |= ~std::uint64_t(0) << (old % word_bits);
+            size_ = bits;
+            clear_tail();
+        }
+
+        void push_back(bool value) {
+            if (size_ % word_bits == 0) {
+                storage.push_back(0);
+                sync();
+            }
+            size_++;
+            set(size_ - 1, value);
+        }
+
+        void pop_back() noexcept {
+            size_--;
+            if (size_ % word_bits == 0)
+                storage.pop_back();
+            else
+                clear_tail();
+        }
+
+        void clear() noexcept {
+            storage.clear();
+            size_ = 0;
+            sync();
         }
+
+        //takes over the words, size must fit in them and bits past it are cleared
+        [[nodiscard]] static bit_array from_words(std::vector<std::uint64_t>&& words, std::size_t size);
     };
 
     class optional {
@@ -3457,7 +4623,7 @@ namespace enbt {
         }
 
         std::strong_ordering operator<=>(const optional& enbt) const {
-            return holder == enbt.holder ? std::strong_ordering::equal : std::strong_ordering::less;
+            return holder <=> enbt.holder;
         }
     };
 
@@ -3522,7 +4688,7 @@ namespace enbt {
         }
 
         std::strong_ordering operator<=>(const uuid& enbt) const {
-            return holder == enbt.holder ? std::strong_ordering::equal : std::strong_ordering::less;
+            return holder <=> enbt.holder;
         }
     };
 }
@@ -3537,6 +4703,13 @@ namespace std {
             return std::hash<std::uint64_t>()(parts[0]) ^ std::hash<std::uint64_t>()(parts[1]);
         }
     };
+
+    template <>
+    struct hash<enbt::value> {
+        std::size_t operator()(const enbt::value& value) const {
+            return (std::size_t)value.hash();
+        }
+    };
 }
 
 #endif /* ENBT */
@@ -1,14 +1,272 @@
 #ifndef ENBT_IO
 #define ENBT_IO
 #include "enbt.hpp"
+#include <cstddef>
+#include <filesystem>
 #include <functional>
 #include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
 #include <sstream>
 #include <type_traits>
 #include <unordered_set>
 
 namespace enbt {
     namespace io_helper {
+        //non owning reader over contiguous memory, implements the subset of std::istream used by readers
+        // bounds are checked once per read call instead of per byte, reading or seeking out of range throws enbt::exception
+        class span_stream {
+            std::span<const std::byte> buffer;
+            std::size_t cursor = 0;
+
+        public:
+            span_stream(std::span<const std::byte> buffer)
+                : buffer(buffer) {}
+
+            span_stream(const std::uint8_t* data, std::size_t size)
+                : buffer((const std::byte*)data, size) {}
+
+            span_stream& read(char* res, std::streamsize size) {
+                if ((std::size_t)size > buffer.size() - cursor)
+                    throw enbt::exception("Unexpected end of buffer");
+                std::memcpy(res, buffer.data() + cursor, (std::size_t)size);
+                cursor += (std::size_t)size;
+                return *this;
+            }
+
+            std::streampos tellg() const noexcept {
+                return std::streamoff(cursor);
+            }
+
+            span_stream& seekg(std::streampos pos) {
+                if ((std::size_t)std::streamoff(pos) > buffer.size())
+                    throw enbt::exception("Unexpected end of buffer");
+                cursor = (std::size_t)std::streamoff(pos);
+                return *this;
+            }
+
+            span_stream& seekg(std::streamoff off, std::ios_base::seekdir dir) {
+                switch (dir) {
+                case std::ios_base::beg:
+                    return seekg(std::streampos(off));
+                case std::ios_base::end:
+                    return seekg(std::streampos(std::streamoff(buffer.size()) + off));
+                default:
+                    return seekg(std::streampos(std::streamoff(cursor) + off));
+                }
+            }
+
+            bool eof() const noexcept {
+                return cursor == buffer.size();
+            }
+
+            bool fail() const noexcept {
+                return false;
+            }
+
+            std::ios_base::iostate rdstate() const noexcept {
+                return eof() ? std::ios_base::eofbit : std::ios_base::goodbit;
+            }
+
+            void setstate(std::ios_base::iostate) noexcept {}
+
+            std::span<const std::byte> data() const noexcept {
+                return buffer;
+            }
+
+            std::size_t position() const noexcept {
+                return cursor;
+            }
+
+            std::size_t remaining() const noexcept {
+                return buffer.size() - cursor;
+            }
+
+            //returns the next size bytes without copying and moves the cursor past them
+            std::span<const std::byte> read_span(std::size_t size) {
+                if (size > buffer.size() - cursor)
+                    throw enbt::exception("Unexpected end of buffer");
+                auto res = buffer.subspan(cursor, size);
+                cursor += size;
+                return res;
+            }
+        };
+
+        //read only mapping of a whole file, the memory stays valid while the object lives
+        // reads through stream() touch only the pages they reach
+        class mapped_file {
+            const std::byte* mapping = nullptr;
+            std::size_t length = 0;
+
+        public:
+            //throws enbt::exception if the file can't be opened or mapped
+            mapped_file(const std::filesystem::path& path);
+            mapped_file(mapped_file&& other) noexcept;
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(mapped_file&& other) noexcept;
+            mapped_file& operator=(const mapped_file&) = delete;
+            ~mapped_file();
+
+            std::span<const std::byte> data() const noexcept {
+                return {mapping, length};
+            }
+
+            std::size_t size() const noexcept {
+                return length;
+            }
+
+            span_stream stream() const noexcept {
+                return span_stream(data());
+            }
+        };
+
+        //streambuf over another one that keeps the last history bytes it handed out
+        // tellg and seekg inside that window are served from memory, so they work on pipes and sockets and never reach the source
+        // seeking forward reads and drops bytes, seeking further back than the window fails
+        class lookahead_buffer : public std::streambuf {
+            std::streambuf* source;
+            std::size_t history;
+            std::size_t capacity;
+            std::unique_ptr<char[]> storage;
+            std::streamoff base = 0; //stream position of eback
+
+            bool fill();
+
+        protected:
+            int_type underflow() override;
+            std::streamsize showmanyc() override;
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+            pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+        public:
+            static constexpr std::size_t default_history = 64 * 1024;
+
+            lookahead_buffer(std::streambuf* source, std::size_t history = default_history);
+        };
+
+        //istream reading through a lookahead_buffer, makes value_read_stream peeks work on streams that can't seek
+        // the source is read ahead, it must not be read directly while this stream is used
+        // a seek outside the window throws and sets badbit, later reads and seeks on the stream throw std::ios_base::failure
+        class lookahead_stream : public std::istream {
+            lookahead_buffer buffer;
+
+        public:
+            lookahead_stream(std::istream& source, std::size_t history = lookahead_buffer::default_history)
+                : std::istream(nullptr), buffer(source.rdbuf(), history) {
+                rdbuf(&buffer);
+                exceptions(std::ios_base::badbit);
+            }
+        };
+
+        //buffered byte sink for writers, implements the subset of std::ostream used by writers
+        // appends to a growable vector, fills a fixed caller buffer or stages writes for std::ostream in 64 KiB blocks
+        // positions are relative to the first byte written through the sink
+        class output_sink {
+            std::byte* window = nullptr;
+            std::byte* cursor = nullptr;
+            std::byte* window_end = nullptr;
+            std::size_t high_mark = 0;
+            std::size_t flushed = 0;
+
+            std::vector<std::uint8_t>* growable = nullptr;
+            std::size_t growable_origin = 0;
+            std::ostream* stream = nullptr;
+            std::streampos stream_origin;
+            std::unique_ptr<std::byte[]> staging;
+
+            std::size_t window_size() const noexcept {
+                return std::max(high_mark, std::size_t(cursor - window));
+            }
+
+            void flush_staging();
+            void write_slow(const char* data, std::size_t size);
+
+        public:
+            static constexpr std::size_t staging_size = 64 * 1024;
+
+            //appends to the end of the vector, the vector is trimmed to the written size on flush
+            output_sink(std::vector<std::uint8_t>& buffer);
+            //writes into caller memory, writing past the end throws std::overflow_error
+            output_sink(std::span<std::byte> buffer);
+            output_sink(std::ostream& stream);
+            output_sink(const output_sink&) = delete;
+            output_sink& operator=(const output_sink&) = delete;
+            ~output_sink();
+
+            output_sink& write(const char* data, std::streamsize size) {
+                if ((std::size_t)size <= std::size_t(window_end - cursor)) {
+                    std::memcpy(cursor, data, (std::size_t)size);
+                    cursor += size;
+                } else
+                    write_slow(data, (std::size_t)size);
+                return *this;
+            }
+
+            output_sink& put(char c) {
+                if (cursor != window_end)
+                    *cursor++ = std::byte(c);
+                else
+                    write_slow(&c, 1);
+                return *this;
+            }
+
+            std::streampos tellp() const noexcept {
+                return std::streamoff(flushed + (cursor - window));
+            }
+
+            output_sink& seekp(std::streampos pos);
+            output_sink& flush();
+
+            //count of bytes written through the sink
+            std::size_t size() const noexcept {
+                return flushed + window_size();
+            }
+
+            //makes room for size more bytes in a vector sink so the next writes don't regrow it, other sinks ignore it
+            output_sink& reserve(std::size_t size);
+
+            //true for vector sinks, the only ones reserve has an effect on
+            bool resizable() const noexcept {
+                return growable;
+            }
+
+            //drops count written bytes at pos and moves the ones after them back, false when pos was already flushed to the stream
+            bool erase(std::size_t pos, std::size_t count);
+
+            //false for stream sinks over streams without positions, seekp into flushed bytes fails on them
+            bool seekable() const noexcept {
+                return !stream || stream_origin != std::streampos(-1);
+            }
+
+            //bytes that can be written before the sink has to grow its vector or flush its staging block
+            std::size_t capacity() const noexcept {
+                if (growable)
+                    return growable->capacity() - growable_origin - std::size_t(cursor - window);
+                return std::size_t(window_end - cursor);
+            }
+        };
+
+        //longest var_integer encoding
+        inline constexpr std::size_t max_var_size = 10;
+
+        //buffer codecs for the var_integer and comp_integer encodings, zigzag of signed values is left to the caller
+        // decoders return the count of consumed bytes and throw enbt::exception on truncated or too long input
+        // encoders return the count of written bytes and store whole words, out needs max_var_size or 8 bytes of room
+        std::size_t decode_var(const std::uint8_t* data, std::size_t size, std::uint64_t& value);
+        std::size_t decode_vars(const std::uint8_t* data, std::size_t size, std::uint64_t* values, std::size_t count);
+        std::size_t encode_var(std::uint64_t value, std::uint8_t* out) noexcept;
+        //out needs count * max_var_size bytes of room
+        std::size_t encode_vars(const std::uint64_t* values, std::size_t count, std::uint8_t* out) noexcept;
+        std::size_t decode_compress_len(const std::uint8_t* data, std::size_t size, std::uint64_t& value);
+        std::size_t encode_compress_len(std::uint64_t value, std::uint8_t* out);
+
+        //exact count of bytes write_token produces for the value, computed without encoding it
+        std::size_t serialized_size(const value& val);
+        //same for write_value, without the type id
+        std::size_t serialized_value_size(const value& val);
+
         void write_compress_len(std::ostream& write_stream, std::uint64_t len);
         void write_type_id(std::ostream& write_stream, enbt::type_id tid);
         void write_string(std::ostream& write_stream, const value& val);
@@ -27,10 +285,42 @@ namespace enbt {
             write_string(write_stream, (std::string_view)val);
         }
 
+        void write_compress_len(output_sink& write_stream, std::uint64_t len);
+        void write_type_id(output_sink& write_stream, enbt::type_id tid);
+        void write_string(output_sink& write_stream, const value& val);
+        void write_string(output_sink& write_stream, std::string_view val);
+        void write_define_len(output_sink& write_stream, std::uint64_t len, enbt::type_id tid);
+        void initialize_version(output_sink& write_stream);
+        void write_compound(output_sink& write_stream, const value& val);
+        void write_array(output_sink& write_stream, const value& val);
+        void write_darray(output_sink& write_stream, const value& val);
+        void write_simple_array(output_sink& write_stream, const value& val);
+        void write_log_item(output_sink& write_stream, const value& val);
+        void write_value(output_sink& write_stream, const value& val);
+        void write_token(output_sink& write_stream, const value& val);
+
+        inline void write_string(output_sink& write_stream, const std::string& val) {
+            write_string(write_stream, (std::string_view)val);
+        }
+
+        //encoded exactly like a compound value with the same entries
+        void write_compound(std::ostream& write_stream, const flat_compound& val);
+        void write_compound(output_sink& write_stream, const flat_compound& val);
+        void write_token(std::ostream& write_stream, const flat_compound& val);
+        void write_token(output_sink& write_stream, const flat_compound& val);
+
+        //packed the same way as an array value of bits
+        void write_array(std::ostream& write_stream, const bit_array_ref& val);
+        void write_array(output_sink& write_stream, const bit_array_ref& val);
+        void write_token(std::ostream& write_stream, const bit_array_ref& val);
+        void write_token(output_sink& write_stream, const bit_array_ref& val);
+
         enbt::type_id read_type_id(std::istream& read_stream);
         std::size_t read_define_len(std::istream& read_stream, enbt::type_id tid);
         std::uint64_t read_define_len64(std::istream& read_stream, enbt::type_id tid);
         std::uint64_t read_compress_len(std::istream& read_stream);
+        //reads count consecutive unsigned varints
+        void read_vars(std::istream& read_stream, std::uint64_t* values, std::size_t count);
 
         std::string read_string(std::istream& read_stream);
         value read_compound(std::istream& read_stream, enbt::type_id tid);
@@ -40,12 +330,50 @@ namespace enbt {
         value read_log_item(std::istream& read_stream);
         value read_value(std::istream& read_stream, enbt::type_id tid);
         value read_token(std::istream& read_stream);
+        //payload boxes of the decoded tree are allocated from resource, their contents are not, see enbt::memory_scope
+        value read_token(std::istream& read_stream, std::pmr::memory_resource* resource);
 
         value read_file(std::istream& read_stream);
+        value read_file(std::istream& read_stream, std::pmr::memory_resource* resource);
         std::vector<value> read_list_file(std::istream& read_stream);
+        std::vector<value> read_list_file(std::istream& read_stream, std::pmr::memory_resource* resource);
 
         void check_version(std::istream& read_stream);
 
+        enbt::type_id read_type_id(span_stream& read_stream);
+        std::size_t read_define_len(span_stream& read_stream, enbt::type_id tid);
+        std::uint64_t read_define_len64(span_stream& read_stream, enbt::type_id tid);
+        std::uint64_t read_compress_len(span_stream& read_stream);
+        void read_vars(span_stream& read_stream, std::uint64_t* values, std::size_t count);
+
+        std::string read_string(span_stream& read_stream);
+        //zero copy, the view points into the buffer of read_stream
+        std::string_view read_string_view(span_stream& read_stream);
+        value read_compound(span_stream& read_stream, enbt::type_id tid);
+        //reads a string and interns it without allocating a std::string for it
+        enbt::key read_key(std::istream& read_stream, symbol_table& table);
+        enbt::key read_key(span_stream& read_stream, symbol_table& table);
+        //reads a compound directly into flat storage
+        flat_compound read_flat_compound(std::istream& read_stream, enbt::type_id tid);
+        flat_compound read_flat_compound(span_stream& read_stream, enbt::type_id tid);
+        //reads an array of bits straight into packed words
+        bit_array read_bit_array(std::istream& read_stream, enbt::type_id tid);
+        bit_array read_bit_array(span_stream& read_stream, enbt::type_id tid);
+        std::vector<value> read_array(span_stream& read_stream, enbt::type_id tid);
+        std::vector<value> read_darray(span_stream& read_stream, enbt::type_id tid);
+        value read_sarray(span_stream& read_stream, enbt::type_id tid);
+        value read_log_item(span_stream& read_stream);
+        value read_value(span_stream& read_stream, enbt::type_id tid);
+        value read_token(span_stream& read_stream);
+        //payload boxes of the decoded tree are allocated from resource, their contents are not, see enbt::memory_scope
+        value read_token(span_stream& read_stream, std::pmr::memory_resource* resource);
+
+        value read_file(span_stream& read_stream);
+        value read_file(span_stream& read_stream, std::pmr::memory_resource* resource);
+        std::vector<value> read_list_file(span_stream& read_stream);
+        std::vector<value> read_list_file(span_stream& read_stream, std::pmr::memory_resource* resource);
+
+        void check_version(span_stream& read_stream);
 
         //return zero if cannot, else return type size
         std::uint8_t can_fast_index(enbt::type_id tid);
@@ -59,6 +387,15 @@ namespace enbt {
         void skip_value(std::istream& read_stream, enbt::type_id tid);
         void skip_token(std::istream& read_stream);
 
+        void skip_compound(span_stream& read_stream, enbt::type_id tid);
+        void skip_array(span_stream& read_stream, enbt::type_id tid);
+        void skip_darray(span_stream& read_stream, enbt::type_id tid);
+        void skip_sarray(span_stream& read_stream, enbt::type_id tid);
+        void skip_string(span_stream& read_stream);
+        void skip_log_item(span_stream& read_stream);
+        void skip_value(span_stream& read_stream, enbt::type_id tid);
+        void skip_token(span_stream& read_stream);
+
 
         //move read stream cursor to value in compound, return true if value found
         bool find_value_compound(std::istream& read_stream, enbt::type_id tid, std::string_view key);
@@ -67,6 +404,12 @@ namespace enbt {
         std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index, enbt::type_id arr_tid);
         std::optional<enbt::type_id> index_array(std::istream& read_stream, std::uint64_t index);
 
+        bool find_value_compound(span_stream& read_stream, enbt::type_id tid, std::string_view key);
+        void index_static_array(span_stream& read_stream, std::uint64_t index, std::uint64_t len, enbt::type_id target_id);
+        void index_dyn_array(span_stream& read_stream, std::uint64_t index, std::uint64_t len);
+        std::optional<enbt::type_id> index_array(span_stream& read_stream, std::uint64_t index, enbt::type_id arr_tid);
+        std::optional<enbt::type_id> index_array(span_stream& read_stream, std::uint64_t index);
+
         struct value_path {
             struct index {
                 std::variant<std::string, std::uint64_t> value;
@@ -94,27 +437,127 @@ namespace enbt {
         std::optional<enbt::type_id> move_to_value_path(std::istream& read_stream, const value_path& value_path, enbt::type_id current_id);
         value get_value_path(std::istream& read_stream, const value_path& value_path);
 
+        std::optional<enbt::type_id> move_to_value_path(span_stream& read_stream, const value_path& value_path);
+        std::optional<enbt::type_id> move_to_value_path(span_stream& read_stream, const value_path& value_path, enbt::type_id current_id);
+        value get_value_path(span_stream& read_stream, const value_path& value_path);
+
+        //value paths compiled into a trie, paths with a common prefix share its nodes
+        // extract reads one token and fills the result of every path in a single forward pass,
+        // compound keys are compared without allocating and subtrees that no path enters are skipped
+        class value_path_set {
+            struct node {
+                //sorted, both map to indexes of nodes, a numeric key is also listed as an index
+                std::vector<std::pair<std::string, std::uint32_t>> keys;
+                std::vector<std::pair<std::uint64_t, std::uint32_t>> indexes;
+                //results of the paths that end at this node
+                std::vector<std::size_t> results;
+            };
+
+            std::vector<node> nodes;
+            std::size_t paths = 0;
+
+            template <class Stream>
+            void extract_node(Stream& read_stream, std::uint32_t at, enbt::type_id tid, std::vector<std::optional<value>>& results, std::string& scratch) const;
+            void resolve_node(const value& val, std::uint32_t at, std::vector<std::optional<value>>& results) const;
+
+        public:
+            value_path_set();
+            value_path_set(std::initializer_list<value_path> paths);
+
+            //returns the position of the path in the results of extract
+            std::size_t add(const value_path& path);
+
+            std::size_t size() const noexcept {
+                return paths;
+            }
+
+            //the cursor ends after the token, results is resized to size() and paths that are not found stay empty
+            void extract(std::istream& read_stream, std::vector<std::optional<value>>& results) const;
+            void extract(span_stream& read_stream, std::vector<std::optional<value>>& results) const;
+            std::vector<std::optional<value>> extract(std::istream& read_stream) const;
+            std::vector<std::optional<value>> extract(span_stream& read_stream) const;
+        };
+
+        //incremental decoder for tokens that arrive in pieces, like segments of a socket
+        // bytes may be split anywhere between feed calls, every completed top level token is passed to on_token
+        // nested values are tracked on an explicit stack, so feed never blocks and no byte is decoded twice,
+        // throws enbt::exception on malformed input, after that reset must be called before feeding more
+        class push_decoder {
+            enum class field : std::uint8_t {
+                type_id,
+                item_type_id,
+                define_len,
+                log_len,
+                key,
+                leaf,
+                items,
+            };
+
+            struct frame {
+                enbt::type_id tid;
+                enbt::type_id item_tid;
+                std::uint64_t remaining = 0;
+                std::uint64_t log_end = 0;
+                std::string key;
+                std::vector<value> items;
+                std::unordered_map<std::string, value> fields;
+            };
+
+            std::function<void(value&&)> on_token;
+            std::vector<frame> stack;
+            //bytes of a field that is split between feed calls
+            std::vector<std::uint8_t> pending;
+            std::uint64_t consumed = 0;
+            enbt::type_id leaf_tid;
+            //0 when the size of the leaf depends on its prefix
+            std::size_t leaf_size = 0;
+            field current = field::type_id;
+
+            std::size_t field_size(const std::uint8_t* data, std::size_t size) const;
+            void on_field(const std::uint8_t* data, std::size_t size);
+            void begin_value(enbt::type_id tid);
+            void next_item(frame& top);
+            value finish_frame(span_stream* items);
+            void complete(value&& val);
+
+        public:
+            explicit push_decoder(std::function<void(value&&)> on_token);
+
+            void feed(std::span<const std::byte> data);
+            void feed(const std::uint8_t* data, std::size_t size);
+
+            //true when no token is partially decoded
+            bool idle() const noexcept {
+                return stack.empty() && pending.empty() && current == field::type_id;
+            }
+
+            void reset() noexcept;
+        };
+
         //reader class for reading from stream without allocations,
         // all functions except peek_* is final and do not preserve position of read_stream, and must be used once for lifetime of value_read_stream
-        // peek_* functions require istream to be seekable
-        class value_read_stream {
-            std::istream& read_stream;
+        // peek_* functions require istream to be seekable, span_stream is always seekable, other streams can be read through lookahead_stream
+        template <class Stream>
+        class basic_value_read_stream {
+            using value_read_stream = basic_value_read_stream;
+
+            Stream& read_stream;
 
             enbt::type_id current_type_id;
             bool readed = false;
             int8_t bit_value = -1; //-1 set, 0 and 1 is values
 
-            value_read_stream(std::istream& read_stream, enbt::type_id current_type_id)
+            basic_value_read_stream(Stream& read_stream, enbt::type_id current_type_id)
                 : read_stream(read_stream), current_type_id(current_type_id) {}
 
-            value_read_stream(std::istream& read_stream, enbt::type_id current_type_id, uint8_t bit_value)
+            basic_value_read_stream(Stream& read_stream, enbt::type_id current_type_id, uint8_t bit_value)
                 : read_stream(read_stream), current_type_id(current_type_id), bit_value((int8_t)bit_value) {}
 
             void check_io_state();
 
         public:
-            value_read_stream(std::istream& read_stream);
-            ~value_read_stream();
+            basic_value_read_stream(Stream& read_stream);
+            ~basic_value_read_stream();
             enbt::value read(); //default read
             value_read_stream& read_into(bool& res);
             value_read_stream& read_into(uint8_t& res);
@@ -129,6 +572,9 @@ namespace enbt {
             value_read_stream& read_into(double& res);
             value_read_stream& read_into(enbt::raw_uuid& res);
             value_read_stream& read_into(std::string& res);
+            //zero copy, the view points into the buffer of span_stream
+            value_read_stream& read_into(std::string_view& res)
+                requires std::is_same_v<Stream, span_stream>;
             value_read_stream& read_as(bool& res);
             value_read_stream& read_as(uint8_t& res);
             value_read_stream& read_as(uint16_t& res);
@@ -150,13 +596,13 @@ namespace enbt {
             }
 
             class peek_stream {
-                std::istream& read_stream;
+                Stream& read_stream;
                 enbt::type_id current_type_id;
                 std::streampos pos;
                 int8_t bit_value;
 
             public:
-                peek_stream(std::istream& read_stream, enbt::type_id current_type_id, int8_t bit_value) : read_stream(read_stream), current_type_id(current_type_id), bit_value(bit_value) {
+                peek_stream(Stream& read_stream, enbt::type_id current_type_id, int8_t bit_value) : read_stream(read_stream), current_type_id(current_type_id), bit_value(bit_value) {
                     pos = read_stream.tellg();
                 }
 
@@ -269,13 +715,13 @@ namespace enbt {
             };
 
             class darray {
-                std::istream& read_stream;
+                Stream& read_stream;
                 std::size_t current_item = 0;
                 std::size_t items = 0;
                 enbt::type_id current_type_id;
 
             public:
-                darray(std::istream& read_stream, enbt::type_id current_type_id);
+                darray(Stream& read_stream, enbt::type_id current_type_id);
 
                 ~darray();
 
@@ -333,7 +779,7 @@ namespace enbt {
             };
 
             class array {
-                std::istream& read_stream;
+                Stream& read_stream;
                 std::size_t current_item = 0;
                 std::size_t items = 0;
                 enbt::type_id arr_type_id;
@@ -341,7 +787,7 @@ namespace enbt {
                 uint8_t current_byte = 0;
 
             public:
-                array(std::istream& read_stream, enbt::type_id arr_type_id);
+                array(Stream& read_stream, enbt::type_id arr_type_id);
                 ~array();
                 size_t size() const noexcept;
                 size_t current_index() const noexcept;
@@ -380,10 +826,10 @@ namespace enbt {
                 {
                     if (current_item == items)
                         throw std::out_of_range("Tried to read value out of arrays range.");
-                    if (current_item % 8 == 0)
-                        read_stream.read((char*)&current_byte, 1);
                     if (current_type_id.type == type::bit) {
-                        value_read_stream stream(read_stream, current_type_id, (int8_t)bool(current_byte & uint8_t(current_item % 8)));
+                        if (current_item % 8 == 0)
+                            read_stream.read((char*)&current_byte, 1);
+                        value_read_stream stream(read_stream, current_type_id, (int8_t)bool(current_byte & (1 << (current_item % 8))));
                         fn(stream);
                     } else {
                         value_read_stream stream(read_stream, current_type_id);
@@ -405,16 +851,16 @@ namespace enbt {
 
             template <class T>
             class sarray {
-                std::istream& read_stream;
+                Stream& read_stream;
                 std::size_t current_item = 0;
                 std::size_t items = 0;
                 enbt::type_id current_type_id;
 
-                sarray(std::istream& read_stream, enbt::type_id current_type_id)
+                sarray(Stream& read_stream, enbt::type_id current_type_id)
                     : read_stream(read_stream), current_type_id(current_type_id) {}
 
             public:
-                sarray make_sarray(std::istream& read_stream, enbt::type_id check) {
+                static sarray make_sarray(Stream& read_stream, enbt::type_id check) {
                     static constexpr enbt::type_id check_s = simple_array<T>::enbt_type;
                     if (check.length != check_s.length || check.type != check_s.type || check.is_signed != check_s.is_signed)
                         throw std::invalid_argument("Type mismatch");
@@ -439,11 +885,10 @@ namespace enbt {
                 }
 
                 std::vector<T> read() {
-                    std::vector<T> res;
-                    res.reserve(items - current_item);
-                    iterable([&res](T item) {
-                        res.push_back(item);
-                    });
+                    std::vector<T> res(items - current_item);
+                    read_stream.read((char*)res.data(), res.size() * sizeof(T));
+                    enbt::endian_helpers::convert_endian_arr(current_type_id.get_endian(), res);
+                    current_item = items;
                     return res;
                 }
 
@@ -464,6 +909,26 @@ namespace enbt {
                     return val;
                 }
 
+                //true when the remaining items can be returned by read_view
+                bool viewable() const
+                    requires std::is_same_v<Stream, span_stream>
+                {
+                    if (sizeof(T) != 1 && current_type_id.get_endian() != std::endian::native)
+                        return false;
+                    return (std::uintptr_t)(read_stream.data().data() + read_stream.position()) % alignof(T) == 0;
+                }
+
+                //zero copy view of the remaining items, throws enbt::exception if the items are not viewable
+                std::span<const T> read_view()
+                    requires std::is_same_v<Stream, span_stream>
+                {
+                    if (!viewable())
+                        throw enbt::exception("The array can't be viewed in place");
+                    auto bytes = read_stream.read_span((items - current_item) * sizeof(T));
+                    current_item = items;
+                    return std::span<const T>((const T*)bytes.data(), bytes.size() / sizeof(T));
+                }
+
                 T read_one() {
                     if (current_item == items)
                         throw std::out_of_range("Tried to read value out of arrays range.");
@@ -475,7 +940,7 @@ namespace enbt {
                 }
 
                 template <class FN>
-                darray& read_one(FN&& fn)
+                sarray& read_one(FN&& fn)
                     requires(std::is_invocable_v<FN, T>)
                 {
                     fn(read_one());
@@ -483,7 +948,7 @@ namespace enbt {
                 }
 
                 template <class FN>
-                darray& iterable(FN&& fn)
+                sarray& iterable(FN&& fn)
                     requires(std::is_invocable_v<FN, T>)
                 {
                     while (current_item != items)
@@ -493,7 +958,7 @@ namespace enbt {
             };
 
             class compound {
-                std::istream& read_stream;
+                Stream& read_stream;
                 std::size_t current_item = 0;
                 std::size_t items = 0;
                 enbt::type_id current_type_id;
@@ -503,7 +968,7 @@ namespace enbt {
                 std::vector<std::string> collector_strict_order_data;
 
             public:
-                compound(std::istream& read_stream, enbt::type_id current_type_id, bool enable_collector_strict_order);
+                compound(Stream& read_stream, enbt::type_id current_type_id, bool enable_collector_strict_order);
                 ~compound();
                 size_t size() const noexcept;
                 size_t current_index() const noexcept;
@@ -1037,11 +1502,307 @@ namespace enbt {
             }
         };
 
+        using value_read_stream = basic_value_read_stream<std::istream>;
+        using span_value_read_stream = basic_value_read_stream<span_stream>;
+
+        extern template class basic_value_read_stream<std::istream>;
+        extern template class basic_value_read_stream<span_stream>;
+
+        //indexed list files are list files followed by an index of their records, written by indexed_list_writer
+        // the index is an sarray of record offsets and a footer sarray of {index offset, record count, indexed_list_magic},
+        // so read_list_file and other token readers still read the file, read_list_file drops the index
+        inline constexpr std::uint64_t indexed_list_magic = 0x31584449544E4245; //"ENBTIDX1" in little endian
+        //size of the footer token at the end of the file
+        inline constexpr std::size_t indexed_list_footer_size = 2 + 3 * sizeof(std::uint64_t);
+
+        //writes records of a list file and the index of them on finish
+        class indexed_list_writer {
+            std::vector<std::uint64_t> offsets;
+            //offset in the file where the sink starts
+            std::uint64_t base = 0;
+            output_sink sink;
+            bool finished = false;
+
+        public:
+            //starts a new list file at the position of the stream
+            indexed_list_writer(std::ostream& write_stream);
+            //continues the list file that starts at the position of the stream, an empty stream starts a new file,
+            // records are written over the old index and files without index are scanned once to build it
+            indexed_list_writer(std::iostream& stream);
+            indexed_list_writer(const indexed_list_writer&) = delete;
+            indexed_list_writer& operator=(const indexed_list_writer&) = delete;
+            //finishes the file when finish was not called, errors are swallowed, call finish to see them
+            ~indexed_list_writer();
+
+            void write(const value& val);
+
+            std::size_t size() const noexcept {
+                return offsets.size();
+            }
+
+            //writes the index, until then the file is read as a list file without index
+            void finish();
+        };
+
+        //random access to the records of a list file, files without index are scanned once on construction
+        template <class Stream>
+        class basic_indexed_list_reader {
+            Stream& read_stream;
+            std::streampos origin;
+            std::uint64_t records = 0;
+            //end of the last record, the index starts there
+            std::uint64_t records_end = 0;
+            //offset of the record offsets in the index, unused when the file had no index
+            std::uint64_t table = 0;
+            std::uint8_t offset_size = 0;
+            std::vector<std::uint64_t> scanned;
+
+            void seek(std::uint64_t offset);
+
+        public:
+            //the file starts at the position of the stream
+            basic_indexed_list_reader(Stream& read_stream);
+
+            std::size_t size() const noexcept {
+                return std::size_t(records);
+            }
+
+            //false when the offsets were found by scanning the file
+            bool indexed() const noexcept {
+                return offset_size;
+            }
+
+            std::uint64_t end_of_records() const noexcept {
+                return records_end;
+            }
+
+            std::uint64_t offset(std::size_t index);
+            std::vector<std::uint64_t> offsets();
+
+            //leaves the stream at the start of the record
+            void seek_record(std::size_t index);
+            value record(std::size_t index);
+
+            //reads records [first, last) in order with one seek, fn is called with the index and the record
+            template <class FN>
+            void read_range(std::size_t first, std::size_t last, FN&& fn)
+                requires(std::is_invocable_v<FN, std::size_t, value&&>)
+            {
+                if (last > size() || first > last)
+                    throw std::out_of_range("Record range is out of bounds");
+                if (first == last)
+                    return;
+                seek_record(first);
+                for (std::size_t i = first; i < last; i++)
+                    fn(i, read_token(read_stream));
+            }
+        };
+
+        using indexed_list_reader = basic_indexed_list_reader<std::istream>;
+        using span_indexed_list_reader = basic_indexed_list_reader<span_stream>;
+
+        extern template class basic_indexed_list_reader<std::istream>;
+        extern template class basic_indexed_list_reader<span_stream>;
+
+        //payloads of consecutive top level log items, found from their length prefixes without decoding them
+        // throws enbt::exception on other tokens or when the last item is cut off
+        std::vector<std::span<const std::byte>> scan_log_items(std::span<const std::byte> data);
+
+        //decodes the payloads of consecutive top level log items on threads, 0 threads uses every hardware thread
+        // results keep the order of the items, fn is called on the calling thread while later items are decoded,
+        // array compaction of the caller applies to the workers, its memory scopes do not
+        std::vector<value> read_log_items_parallel(std::span<const std::byte> data, std::size_t threads = 0);
+        void read_log_items_parallel(std::span<const std::byte> data, const std::function<void(value&&)>& fn, std::size_t threads = 0);
+        //reads the stream in blocks, the next block is read while the items of the last one are decoded
+        void read_log_items_parallel(std::istream& read_stream, const std::function<void(value&&)>& fn, std::size_t threads = 0);
+
+        //how value_write_stream writes the header of a compound or darray whose item count is known only on close
+        // backpatch reserves a type_len::Long header and seeks back to it, the target must be seekable
+        // buffered keeps the body in a pooled scratch buffer and writes it after the smallest header that fits
+        enum class container_mode : std::uint8_t {
+            backpatch,
+            buffered
+        };
+
+        namespace __impl__ {
+            //appends everything written through std::ostream to a vector
+            class vector_streambuf : public std::streambuf {
+                std::vector<std::uint8_t>& buffer;
+
+            protected:
+                int_type overflow(int_type ch) override {
+                    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                        buffer.push_back((std::uint8_t)ch);
+                    return traits_type::not_eof(ch);
+                }
+
+                std::streamsize xsputn(const char* data, std::streamsize size) override {
+                    buffer.insert(buffer.end(), (const std::uint8_t*)data, (const std::uint8_t*)data + size);
+                    return size;
+                }
+
+                pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override {
+                    if (off == 0 && dir == std::ios_base::cur)
+                        return pos_type(off_type(buffer.size()));
+                    return pos_type(off_type(-1));
+                }
+
+            public:
+                vector_streambuf(std::vector<std::uint8_t>& buffer)
+                    : buffer(buffer) {}
+            };
+
+            //header of a container opened inside a scratch body, it is written in front of the body byte at pos
+            struct scratch_header {
+                std::size_t pos;
+                std::uint64_t items;
+                enbt::type type;
+                bool type_id_written;
+                bool shared_type_id;
+            };
+
+            //body of a buffered compound or darray or of a log item, the header is written on close when the item count is known
+            template <class Stream>
+            struct container_scratch;
+
+            template <>
+            struct container_scratch<std::ostream> {
+                std::vector<std::uint8_t> data;
+                std::vector<scratch_header> headers;
+                vector_streambuf buffer{data};
+                std::ostream stream{&buffer};
+
+                std::ostream& open() {
+                    return stream;
+                }
+
+                std::ostream* current() noexcept {
+                    return &stream;
+                }
+
+                std::size_t tell() const noexcept {
+                    return data.size();
+                }
+
+                std::span<const std::uint8_t> close() {
+                    return data;
+                }
+
+                void reset() {
+                    data.clear();
+                    headers.clear();
+                    stream.clear();
+                }
+            };
+
+            template <>
+            struct container_scratch<output_sink> {
+                std::vector<std::uint8_t> data;
+                std::vector<scratch_header> headers;
+                std::optional<output_sink> sink;
+
+                output_sink& open() {
+                    return sink.emplace(data);
+                }
+
+                output_sink* current() noexcept {
+                    return sink ? &*sink : nullptr;
+                }
+
+                std::size_t tell() const noexcept {
+                    return sink ? (std::size_t)std::streamoff(sink->tellp()) : data.size();
+                }
+
+                std::span<const std::uint8_t> close() {
+                    sink.reset();
+                    return data;
+                }
+
+                void reset() {
+                    sink.reset();
+                    data.clear();
+                    headers.clear();
+                }
+            };
+
+            //per thread pool, buffers keep their capacity between containers
+            template <class Stream>
+            container_scratch<Stream>* acquire_scratch();
+            template <class Stream>
+            void release_scratch(container_scratch<Stream>* scratch);
+
+            //log_item written by a callback, a seekable output_sink gets a full width length slot patched on close
+            // other targets get the entry in a pooled scratch buffer that is copied out after its length
+            template <class Stream>
+            class log_item_frame {
+                Stream& target;
+                container_scratch<Stream>* scratch = nullptr;
+                Stream* stream;
+                std::size_t slot = 0;
+
+            public:
+                log_item_frame(Stream& target);
+                log_item_frame(const log_item_frame&) = delete;
+                log_item_frame& operator=(const log_item_frame&) = delete;
+                ~log_item_frame();
+
+                Stream& body() noexcept {
+                    return *stream;
+                }
+
+                void close();
+            };
+
+            extern template class log_item_frame<std::ostream>;
+            extern template class log_item_frame<output_sink>;
+
+            //compound or darray written by a value_write_stream, the header is written on close
+            // a container opened inside a scratch body records its header in it, whatever its mode,
+            // so the body is copied once by the outermost scratch however deep the containers nest
+            template <class Stream>
+            class container_frame {
+                Stream& target;
+                container_scratch<Stream>* scratch = nullptr;
+                Stream* stream;
+                //header position for backpatch, index of the recorded header when joined to a scratch
+                std::size_t slot = 0;
+                int uncaught_exceptions;
+                enbt::type type;
+                bool type_id_written;
+                bool shared_type_id;
+                bool joined = false;
+                bool open = true;
+
+            public:
+                std::size_t items = 0;
+
+                container_frame(Stream& target, enbt::type type, container_mode mode, bool type_id_written, bool shared_type_id);
+                container_frame(container_frame&& other) noexcept;
+                container_frame(const container_frame&) = delete;
+                container_frame& operator=(const container_frame&) = delete;
+                //closes an open frame, errors are dropped, the body is dropped when the frame is unwound by an exception
+                ~container_frame();
+
+                Stream& body() noexcept {
+                    return *stream;
+                }
+
+                void close();
+            };
+
+            extern template class container_frame<std::ostream>;
+            extern template class container_frame<output_sink>;
+        }
+
         //lightweight writer class for writing to stream without allocations
-        // this class requires ostream to support peek and seek operations for writing darray and compound
-        class value_write_stream {
-            std::ostream& write_stream;
+        // darray and compound headers are written by close or the destructor, see container_mode,
+        // the destructor drops errors so call close to see them
+        template <class Stream>
+        class basic_value_write_stream {
+            using value_write_stream = basic_value_write_stream;
+            Stream& write_stream;
             bool need_to_write_type_id;
+            bool shared_type_id;
             enbt::type_id written_type_id;
 
         public:
@@ -1050,15 +1811,17 @@ namespace enbt {
             }
 
             class darray {
-                std::ostream& write_stream;
-                std::ostream::pos_type type_size_field_pos;
-                std::size_t items = 0;
-                bool type_id_written;
+                __impl__::container_frame<Stream> frame;
+                Stream& write_stream;
 
             public:
-                darray(std::ostream& write_stream, bool write_type_id);
-                ~darray();
+                darray(Stream& write_stream, bool write_type_id, bool shared_type_id = false, container_mode mode = container_mode::backpatch);
+                darray(darray&& other) = default;
+                darray(const darray&) = delete;
+                ~darray() = default;
                 darray& write(const enbt::value&);
+                //writes the header, nothing is written to the darray after that
+                void close();
 
                 inline darray& write(bool res) {
                     return write([res](auto& s) { s.write(res); });
@@ -1122,7 +1885,7 @@ namespace enbt {
                 {
                     value_write_stream inner(write_stream);
                     fn(inner);
-                    items++;
+                    frame.items++;
                     return *this;
                 }
 
@@ -1148,8 +1911,104 @@ namespace enbt {
                 }
             };
 
+            //darray of a known item count, its header is written up front
+            class darray_fixed {
+                Stream& write_stream;
+                std::size_t items_to_write;
+
+            public:
+                darray_fixed(Stream& write_stream, size_t size, bool write_type_id);
+                ~darray_fixed();
+                darray_fixed& write(const enbt::value&);
+
+                inline darray_fixed& write(bool res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(uint8_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(uint16_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(uint32_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(uint64_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(int8_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(int16_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(int32_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(int64_t res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(float res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(double res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(enbt::raw_uuid res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(const std::string& res) {
+                    return write([&res](auto& s) { s.write(res); });
+                }
+
+                inline darray_fixed& write(std::string_view res) {
+                    return write([res](auto& s) { s.write(res); });
+                }
+
+                template <class FN>
+                darray_fixed& write(FN&& fn)
+                    requires(std::is_invocable_v<FN, value_write_stream&>)
+                {
+                    if (items_to_write == 0)
+                        throw std::invalid_argument("array is full");
+                    --items_to_write;
+                    value_write_stream inner(write_stream);
+                    fn(inner);
+                    return *this;
+                }
+
+                //fn(item, inner)
+                template <class Iterable, class FN>
+                darray_fixed& iterable(const Iterable& iter, FN&& fn) {
+                    for (const auto& item : iter)
+                        write([&](value_write_stream& inner) {
+                            fn(item, inner);
+                        });
+                    return *this;
+                }
+
+                template <class Iterable>
+                darray_fixed& iterable(const Iterable& iter) {
+                    for (const auto& item : iter)
+                        write(item);
+                    return *this;
+                }
+            };
+
             class array {
-                std::ostream& write_stream;
+                Stream& write_stream;
                 std::size_t items_to_write = 0;
                 ::enbt::type_id current_type_id;
                 std::int8_t bit_i = 0;
@@ -1157,7 +2016,7 @@ namespace enbt {
                 bool type_set = false;
 
             public:
-                array(std::ostream& write_stream, size_t size, bool write_type_id);
+                array(Stream& write_stream, size_t size, bool write_type_id);
                 ~array();
                 array& write(const enbt::value&);
 
@@ -1174,8 +2033,9 @@ namespace enbt {
                     if (bit_i >= 8) {
                         bit_i = 0;
                         write_stream.write((char*)&bit_value, sizeof(bit_value));
+                        bit_value = 0;
                     }
-                    bit_value = (((uint8_t)res) & (1 << bit_i));
+                    bit_value |= std::uint8_t(res) << bit_i++;
                     items_to_write--;
                     return *this;
                 }
@@ -1238,7 +2098,7 @@ namespace enbt {
                 {
                     if (items_to_write == 0)
                         throw std::invalid_argument("array is full");
-                    value_write_stream inner(write_stream, !type_set);
+                    value_write_stream inner(write_stream, !type_set, true);
                     fn(inner);
                     if (!type_set) {
                         current_type_id = inner.get_written_type_id();
@@ -1271,11 +2131,11 @@ namespace enbt {
 
             template <class T>
             class sarray {
-                std::ostream& write_stream;
+                Stream& write_stream;
                 std::size_t items_to_write;
 
             public:
-                sarray(std::ostream& write_stream, size_t size, bool write_type_id_)
+                sarray(Stream& write_stream, size_t size, bool write_type_id_)
                     : write_stream(write_stream), items_to_write(size) {
                     enbt::type_id tid = simple_array<T>::enbt_type;
                     if (write_type_id_)
@@ -1308,16 +2168,19 @@ namespace enbt {
             };
 
             class compound {
-                std::ostream& write_stream;
-                std::ostream::pos_type type_size_field_pos;
-                std::size_t items = 0;
-                bool type_id_written;
+                __impl__::container_frame<Stream> frame;
+                Stream& write_stream;
 
             public:
-                compound(std::ostream& write_stream, bool write_type_id);
-                ~compound();
+                //shared_type_id: the container is an array item, its length is always written as type_len::Long
+                compound(Stream& write_stream, bool write_type_id, bool shared_type_id = false, container_mode mode = container_mode::backpatch);
+                compound(compound&& other) = default;
+                compound(const compound&) = delete;
+                ~compound() = default;
 
                 compound& write(std::string_view filed_name, const enbt::value&);
+                //writes the header, nothing is written to the compound after that
+                void close();
 
                 inline compound& write(std::string_view filed_name, bool res) {
                     return write(filed_name, [res](auto& s) { s.write(res); });
@@ -1382,7 +2245,7 @@ namespace enbt {
                     write_string(write_stream, filed_name);
                     value_write_stream inner(write_stream);
                     fn(inner);
-                    items++;
+                    frame.items++;
                     return *this;
                 }
 
@@ -1407,11 +2270,11 @@ namespace enbt {
             };
 
             class compound_fixed {
-                std::ostream& write_stream;
+                Stream& write_stream;
                 std::size_t items_to_write;
 
             public:
-                compound_fixed(std::ostream& write_stream, size_t size, bool write_type_id);
+                compound_fixed(Stream& write_stream, size_t size, bool write_type_id);
                 ~compound_fixed();
 
                 compound_fixed& write(std::string_view filed_name, const enbt::value&);
@@ -1506,12 +2369,12 @@ namespace enbt {
             };
 
             class optional {
-                std::ostream& write_stream;
+                Stream& write_stream;
                 bool is_written = false;
                 bool has_value = false;
 
             public:
-                optional(std::ostream& write_stream, bool need_to_write_type_id);
+                optional(Stream& write_stream, bool need_to_write_type_id);
                 ~optional();
                 void write(const enbt::value&);
 
@@ -1602,9 +2465,10 @@ namespace enbt {
             void write(enbt::raw_uuid res);
             void write(const std::string& res);
             void write(std::string_view res);
-            compound write_compound();
+            compound write_compound(container_mode mode = container_mode::backpatch);
             compound_fixed write_compound(size_t size);
-            darray write_darray();
+            darray write_darray(container_mode mode = container_mode::backpatch);
+            darray_fixed write_darray(size_t size);
             array write_array(size_t size);
             optional write_optional();
             void write_log_item(const enbt::value&);
@@ -1616,11 +2480,12 @@ namespace enbt {
                 written_type_id = enbt::type_id(enbt::type::log_item);
                 if (need_to_write_type_id)
                     write_type_id(write_stream, written_type_id);
-                std::ostringstream temp_stream;
-                value_write_stream inner(temp_stream);
-                fn(inner);
-                write_compress_len(write_stream, temp_stream.tellp());
-                write_stream << temp_stream.rdbuf();
+                __impl__::log_item_frame<Stream> frame(write_stream);
+                {
+                    value_write_stream inner(frame.body());
+                    fn(inner);
+                }
+                frame.close();
             }
 
             template <class T, std::size_t N>
@@ -1649,9 +2514,15 @@ namespace enbt {
                 return sarray<T>(write_stream, size, need_to_write_type_id);
             }
 
-            value_write_stream(std::ostream& write_stream, bool need_to_write_type_id = true);
+            basic_value_write_stream(Stream& write_stream, bool need_to_write_type_id = true, bool shared_type_id = false);
         };
 
+        using value_write_stream = basic_value_write_stream<std::ostream>;
+        using sink_value_write_stream = basic_value_write_stream<output_sink>;
+
+        extern template class basic_value_write_stream<std::ostream>;
+        extern template class basic_value_write_stream<output_sink>;
+
         namespace collection {
             template <template <class...> class map_base = std::unordered_map>
             class compound_relaxed {
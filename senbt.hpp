@@ -29,8 +29,8 @@ namespace senbt {
     std::string serialize(const enbt::value& value, bool compressed = false, bool type_erasure = false);
     std::string serialize(const enbt::compound_ref& value, bool compressed = false, bool type_erasure = false);
     std::string serialize(const enbt::compound_const_ref& value, bool compressed = false, bool type_erasure = false);
-    std::string serialize(const enbt::fixed_array_ref& value, bool compressed = false, bool type_erasure = false);
-    std::string serialize(const enbt::dynamic_array_ref& value, bool compressed = false, bool type_erasure = false);
+    std::string serialize(const enbt::fixed_array_const_ref& value, bool compressed = false, bool type_erasure = false);
+    std::string serialize(const enbt::dynamic_array_const_ref& value, bool compressed = false, bool type_erasure = false);
     std::string serialize(const enbt::simple_array_const_ref_ui8& value, bool compressed = false, bool type_erasure = false);
     std::string serialize(const enbt::simple_array_const_ref_ui16& value, bool compressed = false, bool type_erasure = false);
     std::string serialize(const enbt::simple_array_const_ref_ui32& value, bool compressed = false, bool type_erasure = false);
@@ -0,0 +1,110 @@
+//checks that values written by async_value_writer through a small async_pipe are read back by async_value_reader
+#include "../async_io.hpp"
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static std::vector<enbt::value> make_values() {
+    std::vector<enbt::value> items;
+    for (std::int32_t i = 0; i < 50; i++)
+        items.push_back(enbt::value(i * 1000));
+    std::unordered_map<std::string, enbt::value> record{
+        {"name", enbt::value("record")},
+        {"text", enbt::value(std::string(500, 'x'))},
+        {"items", enbt::value(items)},
+        {"mixed", enbt::value(enbt::dynamic_array(std::vector<enbt::value>{enbt::value(std::int8_t(1)), enbt::value(std::string(100, 'y'))}))}
+    };
+    return {enbt::value(record), enbt::value(std::int64_t(-3), true), enbt::value(std::string(3, 'z')), enbt::value(record)};
+}
+
+static task<> produce(async_pipe& pipe, const std::vector<enbt::value>& values, std::size_t chunk_size) {
+    async_value_writer writer(pipe, chunk_size);
+    for (auto& val : values)
+        co_await writer.write(val);
+    co_await writer.flush();
+    pipe.close();
+}
+
+static task<std::vector<enbt::value>> consume(async_pipe& pipe, std::size_t chunk_size) {
+    async_value_reader reader(pipe, chunk_size);
+    std::vector<enbt::value> res;
+    while (auto val = co_await reader.try_read())
+        res.push_back(std::move(*val));
+    co_return res;
+}
+
+static task<> write_bytes(async_pipe& pipe, std::span<const std::byte> bytes) {
+    co_await pipe.write(bytes);
+    pipe.close();
+}
+
+template <class T>
+static bool throws_enbt(task<T>& running) {
+    try {
+        running.result();
+    } catch (const enbt::exception&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    std::vector<enbt::value> values = make_values();
+
+    //small pipes and chunks make both ends suspend on each other many times
+    for (std::size_t limit : {std::size_t(1), std::size_t(7), std::size_t(64), std::size_t(100000)})
+        for (std::size_t chunk_size : {std::size_t(1), std::size_t(16), std::size_t(4096)}) {
+            async_pipe pipe(limit);
+            auto reader = consume(pipe, chunk_size);
+            auto writer = produce(pipe, values, chunk_size);
+            reader.start();
+            assert(!reader.done());
+            writer.start();
+            assert(writer.done() && reader.done());
+            writer.result();
+            assert(reader.result() == values);
+        }
+
+    //the input ends inside a token
+    {
+        std::vector<std::uint8_t> bytes;
+        {
+            output_sink sink(bytes);
+            write_token(sink, values[0]);
+        }
+        async_pipe pipe(32);
+        auto reader = consume(pipe, 16);
+        auto writer = write_bytes(pipe, std::as_bytes(std::span(bytes.data(), bytes.size() / 2)));
+        reader.start();
+        writer.start();
+        assert(reader.done() && throws_enbt(reader));
+    }
+
+    //read throws at the end of input and read_compound on other tokens
+    {
+        //the writer is lazy, so its values must outlive the call
+        std::vector<enbt::value> number{enbt::value(std::int32_t(1))};
+        async_pipe pipe;
+        auto writer = produce(pipe, number, 16);
+        writer.start();
+        async_value_reader reader(pipe);
+        auto not_compound = reader.read_compound();
+        not_compound.start();
+        assert(not_compound.done() && throws_enbt(not_compound));
+        auto at_end = reader.read();
+        at_end.start();
+        assert(at_end.done() && throws_enbt(at_end));
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+//checks that nested open containers read back the same in both container modes, and that backpatch refuses unseekable targets
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+//a pipe like target, tellp fails because seekoff is not overridden
+class pipe_streambuf : public std::streambuf {
+public:
+    std::string bytes;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            bytes.push_back((char)ch);
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        bytes.append(data, (std::size_t)size);
+        return size;
+    }
+};
+
+static enbt::value expected() {
+    std::unordered_map<std::string, enbt::value> point{{"x", enbt::value(std::int32_t(2))}};
+    std::vector<enbt::value> items{
+        enbt::value(std::int32_t(1)),
+        enbt::value(point),
+        enbt::value(enbt::dynamic_array()),
+        //items of one type would make a fixed array, the writer makes a darray
+        enbt::value(enbt::dynamic_array(std::vector<enbt::value>{enbt::value("a"), enbt::value("b")}))
+    };
+    std::unordered_map<std::string, enbt::value> inner{{"flag", enbt::value(true)}};
+    std::unordered_map<std::string, enbt::value> root{
+        {"name", enbt::value("example")},
+        {"items", enbt::value(items)},
+        {"inner", enbt::value(inner)}
+    };
+    return enbt::value(root);
+}
+
+//mode is passed to every open container, the fixed darray has its count up front
+template <class Stream>
+static void write_nested(basic_value_write_stream<Stream>&& writer, container_mode mode) {
+    auto root = writer.write_compound(mode);
+    root.write("name", std::string_view("example"));
+    root.write("items", [mode](auto& items_writer) {
+        auto items = items_writer.write_darray(mode);
+        items.write(std::int32_t(1));
+        items.write([mode](auto& point_writer) {
+            auto point = point_writer.write_compound(mode);
+            point.write("x", std::int32_t(2));
+            point.close();
+        });
+        items.write([mode](auto& empty_writer) {
+            empty_writer.write_darray(mode).close();
+        });
+        items.write([](auto& letters_writer) {
+            auto letters = letters_writer.write_darray(2);
+            letters.write(enbt::value("a"));
+            letters.write(enbt::value("b"));
+        });
+        items.close();
+    });
+    root.write("inner", [mode](auto& inner_writer) {
+        auto inner = inner_writer.write_compound(mode);
+        inner.write("flag", true);
+        inner.close();
+    });
+    root.close();
+}
+
+template <class FN>
+static bool throws_enbt(FN&& fn) {
+    try {
+        fn();
+    } catch (const enbt::exception&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    enbt::value target = expected();
+
+    std::stringstream patched;
+    write_nested(value_write_stream(patched), container_mode::backpatch);
+    assert(read_token(patched) == target);
+
+    std::stringstream buffered;
+    write_nested(value_write_stream(buffered), container_mode::buffered);
+    assert(read_token(buffered) == target);
+    //buffered headers take the smallest type_len, backpatched ones are always Long
+    assert(buffered.str().size() < patched.str().size());
+
+    for (auto mode : {container_mode::backpatch, container_mode::buffered}) {
+        std::vector<std::uint8_t> bytes;
+        {
+            output_sink sink(bytes);
+            write_nested(sink_value_write_stream(sink), mode);
+        }
+        std::istringstream in(std::string(bytes.begin(), bytes.end()));
+        assert(read_token(in) == target);
+    }
+
+    //buffered and fixed containers need no positions
+    {
+        pipe_streambuf pipe;
+        std::ostream out(&pipe);
+        write_nested(value_write_stream(out), container_mode::buffered);
+        assert(pipe.bytes == buffered.str());
+
+        pipe_streambuf sink_pipe;
+        std::ostream sink_out(&sink_pipe);
+        {
+            output_sink sink(sink_out);
+            write_nested(sink_value_write_stream(sink), container_mode::buffered);
+        }
+        assert(sink_pipe.bytes == buffered.str());
+    }
+
+    //backpatch throws as the container is opened, before anything reaches the target
+    {
+        pipe_streambuf pipe;
+        std::ostream out(&pipe);
+        value_write_stream writer(out);
+        assert(throws_enbt([&] { writer.write_compound(); }));
+        assert(throws_enbt([&] { writer.write_darray(container_mode::backpatch); }));
+        assert(pipe.bytes.empty());
+
+        pipe_streambuf sink_pipe;
+        std::ostream sink_out(&sink_pipe);
+        output_sink sink(sink_out);
+        assert(!sink.seekable());
+        sink_value_write_stream sink_writer(sink);
+        assert(throws_enbt([&] { sink_writer.write_darray(); }));
+    }
+
+    //a fixed darray refuses items past its count
+    {
+        std::stringstream out;
+        value_write_stream writer(out);
+        auto letters = writer.write_darray(1);
+        letters.write(enbt::value("a"));
+        bool thrown = false;
+        try {
+            letters.write(enbt::value("b"));
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,34 @@
+//checks flat_compound against std::unordered_map across the switch from the sorted vector to the index
+#include "../enbt.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+int main() {
+    std::mt19937 random_bits(3);
+    for (std::size_t limit : {4, 16, 17, 64}) {
+        enbt::flat_compound flat;
+        std::unordered_map<std::string, enbt::value> map;
+        for (int round = 0; round < 2000; round++) {
+            //names of different lengths that share prefixes, so the length check and the bytes both decide
+            std::string name = std::string(random_bits() % 3 + 1, 'k') + std::to_string(random_bits() % limit);
+            if (random_bits() % 3) {
+                flat.insert_or_assign(name, enbt::value(std::int32_t(round)));
+                map.insert_or_assign(name, enbt::value(std::int32_t(round)));
+            } else
+                assert(flat.erase(name) == map.erase(name));
+            assert(flat.size() == map.size());
+            for (auto& [key, item] : map) {
+                auto found = flat.find(std::string_view(key));
+                assert(found != flat.end() && (std::int32_t)found->second == (std::int32_t)item);
+                assert(flat.contains(enbt::key(key)));
+            }
+            assert(!flat.contains(std::string_view("missing")) && !flat.contains(std::string_view("")));
+        }
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+//checks that indexed_list_writer files read back by record(n), also after reopening them to append more records
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static enbt::value make_record(std::int32_t id) {
+    std::unordered_map<std::string, enbt::value> record{
+        {"id", enbt::value(id)},
+        {"text", enbt::value(std::string(std::size_t(id % 7) * 20, 'r'))}
+    };
+    return enbt::value(record);
+}
+
+//reads every record back by index, out of order, then as a range and as a plain list file
+static void check(std::stringstream& file, std::int32_t count, bool indexed) {
+    file.seekg(0);
+    indexed_list_reader reader(file);
+    assert(reader.size() == std::size_t(count) && reader.indexed() == indexed);
+    for (std::int32_t i = count - 1; i >= 0; i--)
+        assert(reader.record(std::size_t(i)) == make_record(i));
+    std::size_t next = 1;
+    reader.read_range(1, std::size_t(count), [&](std::size_t i, enbt::value&& record) {
+        assert(i == next++ && record == make_record(std::int32_t(i)));
+    });
+    assert(next == std::size_t(count));
+    bool thrown = false;
+    try {
+        reader.record(std::size_t(count));
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::string bytes = file.str();
+    span_stream span((const std::uint8_t*)bytes.data(), bytes.size());
+    span_indexed_list_reader span_reader(span);
+    assert(span_reader.size() == std::size_t(count) && span_reader.indexed() == indexed);
+    for (std::int32_t i = 0; i < count; i++)
+        assert(span_reader.offset(std::size_t(i)) == reader.offset(std::size_t(i)));
+
+    file.seekg(0);
+    auto records = read_list_file(file);
+    assert(records.size() == std::size_t(count));
+    for (std::int32_t i = 0; i < count; i++)
+        assert(records[std::size_t(i)] == make_record(i));
+}
+
+int main() {
+    {
+        std::stringstream file;
+        {
+            indexed_list_writer writer(static_cast<std::ostream&>(file));
+            for (std::int32_t i = 0; i < 10; i++)
+                writer.write(make_record(i));
+            assert(writer.size() == 10);
+            writer.finish();
+        }
+        check(file, 10, true);
+
+        //appending writes over the old index and the new index covers every record
+        file.clear();
+        file.seekg(0);
+        file.seekp(0);
+        {
+            indexed_list_writer writer(static_cast<std::iostream&>(file));
+            assert(writer.size() == 10);
+            for (std::int32_t i = 10; i < 25; i++)
+                writer.write(make_record(i));
+        }
+        check(file, 25, true);
+    }
+
+    //a list file without index is scanned, reopening it adds the index
+    {
+        std::stringstream file;
+        initialize_version(file);
+        for (std::int32_t i = 0; i < 6; i++)
+            write_token(file, make_record(i));
+        check(file, 6, false);
+
+        file.clear();
+        file.seekg(0);
+        file.seekp(0);
+        {
+            indexed_list_writer writer(static_cast<std::iostream&>(file));
+            assert(writer.size() == 6);
+            writer.write(make_record(6));
+            writer.finish();
+        }
+        check(file, 7, true);
+    }
+
+    //an empty stream starts a new file
+    {
+        std::stringstream file;
+        {
+            indexed_list_writer writer(static_cast<std::iostream&>(file));
+            writer.write(make_record(0));
+        }
+        check(file, 1, true);
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+//checks the callback log_item writer on patched sinks and on scratch buffered targets against write_token,
+// compound keys may come in another order, so sizes and read back values are compared instead of bytes
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+//a pipe like target, tellp fails because seekoff is not overridden
+class pipe_streambuf : public std::streambuf {
+public:
+    std::string bytes;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            bytes.push_back((char)ch);
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        bytes.append(data, (std::size_t)size);
+        return size;
+    }
+};
+
+static enbt::value make_entry(std::size_t message_size) {
+    std::unordered_map<std::string, enbt::value> fields{
+        {"ts", enbt::value(std::int64_t(1700000000))},
+        {"msg", enbt::value(std::string(message_size, 'm'))}
+    };
+    return enbt::to_log_item(enbt::value(fields));
+}
+
+template <class Stream>
+static void write_entry(basic_value_write_stream<Stream>&& writer, std::size_t message_size) {
+    std::string message(message_size, 'm');
+    writer.write_log_item([&](auto& entry) {
+        auto fields = entry.write_compound(container_mode::buffered);
+        fields.write("ts", std::int64_t(1700000000));
+        fields.write("msg", std::string_view(message));
+        fields.close();
+    });
+}
+
+static std::string expected_bytes(std::size_t message_size) {
+    std::ostringstream out;
+    write_token(out, make_entry(message_size));
+    return out.str();
+}
+
+static enbt::value read_back(const std::string& bytes) {
+    std::istringstream in(bytes);
+    enbt::value res = read_token(in);
+    assert(in.tellg() == std::streampos(bytes.size()));
+    return res;
+}
+
+int main() {
+    for (std::size_t message_size : {std::size_t(10), std::size_t(200), std::size_t(20000)}) {
+        std::size_t expected = expected_bytes(message_size).size();
+
+        //patched slot, the entry is still in the vector so it is moved back over the unused slot bytes
+        {
+            std::vector<std::uint8_t> bytes;
+            {
+                output_sink sink(bytes);
+                write_entry(sink_value_write_stream(sink), message_size);
+            }
+            assert(bytes.size() == expected);
+            assert(read_back(std::string(bytes.begin(), bytes.end())) == make_entry(message_size));
+        }
+
+        //scratch buffer for plain streams and sinks over streams without positions
+        {
+            std::ostringstream out;
+            write_entry(value_write_stream(out), message_size);
+            assert(out.str().size() == expected && read_back(out.str()) == make_entry(message_size));
+
+            pipe_streambuf pipe;
+            std::ostream pipe_out(&pipe);
+            {
+                output_sink sink(pipe_out);
+                assert(!sink.seekable());
+                write_entry(sink_value_write_stream(sink), message_size);
+            }
+            assert(pipe.bytes == out.str());
+        }
+
+        //inside a buffered container the entry goes to the shared scratch, not to a patched slot
+        {
+            std::vector<std::uint8_t> bytes;
+            {
+                output_sink sink(bytes);
+                sink_value_write_stream writer(sink);
+                auto items = writer.write_darray(container_mode::buffered);
+                items.write([&](auto& item) { write_entry(std::move(item), message_size); });
+                items.write([&](auto& item) { write_entry(std::move(item), message_size); });
+                items.close();
+            }
+            enbt::value items = read_back(std::string(bytes.begin(), bytes.end()));
+            assert(items.size() == 2 && items[0] == make_entry(message_size) && items[1] == make_entry(message_size));
+        }
+    }
+
+    //an entry larger than the staging block is flushed before close, its slot is patched in place at full width
+    {
+        std::size_t message_size = 200000;
+        std::stringstream out;
+        {
+            output_sink sink(out);
+            write_entry(sink_value_write_stream(sink), message_size);
+        }
+        std::string bytes = out.str();
+        //the compact length of an entry this size takes 4 bytes
+        assert(bytes.size() == expected_bytes(message_size).size() + 8 - 4);
+        assert(read_back(bytes) == make_entry(message_size));
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
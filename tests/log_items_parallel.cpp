@@ -0,0 +1,87 @@
+//checks that read_log_items_parallel keeps the order of the items and rejects cut off input for every thread count
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static enbt::value make_item(std::int32_t id) {
+    if (id % 3)
+        return enbt::value(id);
+    std::unordered_map<std::string, enbt::value> record{
+        {"id", enbt::value(id)},
+        {"text", enbt::value(std::string(std::size_t(id % 50), 'l'))}
+    };
+    return enbt::value(record);
+}
+
+template <class FN>
+static bool throws_enbt(FN&& fn) {
+    try {
+        fn();
+    } catch (const enbt::exception&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    const std::int32_t count = 5000;
+    std::ostringstream out;
+    for (std::int32_t i = 0; i < count; i++)
+        write_token(out, enbt::to_log_item(make_item(i)));
+    std::string bytes = out.str();
+    std::span<const std::byte> data((const std::byte*)bytes.data(), bytes.size());
+    //the last item loses its last byte
+    std::span<const std::byte> cut = data.first(data.size() - 1);
+
+    for (std::size_t threads : {std::size_t(1), std::size_t(2), std::size_t(5), std::size_t(0)}) {
+        auto values = read_log_items_parallel(data, threads);
+        assert(values.size() == std::size_t(count));
+        for (std::int32_t i = 0; i < count; i++)
+            assert(values[std::size_t(i)] == make_item(i));
+
+        std::int32_t next = 0;
+        read_log_items_parallel(data, [&](enbt::value&& val) { assert(val == make_item(next++)); }, threads);
+        assert(next == count);
+
+        next = 0;
+        std::istringstream in(bytes);
+        read_log_items_parallel(in, [&](enbt::value&& val) { assert(val == make_item(next++)); }, threads);
+        assert(next == count);
+
+        //empty input has no items
+        assert(read_log_items_parallel(std::span<const std::byte>(), threads).empty());
+        std::istringstream empty;
+        read_log_items_parallel(empty, [&](enbt::value&&) { assert(false); }, threads);
+
+        //a span is scanned before decoding, so cut off input throws before any item is passed
+        next = 0;
+        assert(throws_enbt([&] { read_log_items_parallel(cut, threads); }));
+        assert(throws_enbt([&] { read_log_items_parallel(cut, [&](enbt::value&&) { next++; }, threads); }));
+        assert(next == 0);
+
+        //a stream passes the complete items first
+        std::istringstream cut_in(std::string((const char*)cut.data(), cut.size()));
+        assert(throws_enbt([&] { read_log_items_parallel(cut_in, [&](enbt::value&& val) { assert(val == make_item(next++)); }, threads); }));
+        assert(next == count - 1);
+    }
+
+    //other tokens are not log items
+    {
+        std::ostringstream other;
+        write_token(other, enbt::value(std::int32_t(1)));
+        std::string other_bytes = other.str();
+        assert(throws_enbt([&] { read_log_items_parallel(std::span<const std::byte>((const std::byte*)other_bytes.data(), other_bytes.size())); }));
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
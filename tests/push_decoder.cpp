@@ -0,0 +1,101 @@
+//checks that push_decoder yields the tokens of read_token however the bytes are split between feed calls
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static std::vector<enbt::value> make_tokens() {
+    std::vector<enbt::value> bits;
+    for (int i = 0; i < 19; i++)
+        bits.push_back(enbt::value(i % 3 == 0));
+    std::unordered_map<std::string, enbt::value> inner{
+        {"id", enbt::value(std::uint64_t(1) << 40)},
+        {"ratio", enbt::value(0.25)},
+        {"ints", enbt::value(std::vector<enbt::value>{enbt::value(std::int32_t(-1)), enbt::value(std::int32_t(2)), enbt::value(std::int32_t(300))})}
+    };
+    std::unordered_map<std::string, enbt::value> record{
+        {"name", enbt::value("short")},
+        {"text", enbt::value(std::string(300, 't'))},
+        {"inner", enbt::value(inner)},
+        {"mixed", enbt::value(enbt::dynamic_array(std::vector<enbt::value>{enbt::value(std::int8_t(1)), enbt::value("two"), enbt::value(inner)}))},
+        {"bits", enbt::value(bits)},
+        {"bytes", enbt::value(std::vector<std::uint8_t>(70, 9))},
+        {"some", enbt::value(true, enbt::value(std::int16_t(7)))},
+        {"none", enbt::value(false, enbt::value())}
+    };
+    return {
+        enbt::value(record),
+        enbt::value(std::int64_t(-5), true),
+        enbt::value(enbt::raw_uuid{}),
+        enbt::to_log_item(enbt::value(inner)),
+        enbt::value(std::uint8_t(3)),
+        enbt::value(std::string(2, 's'))
+    };
+}
+
+struct collector {
+    std::vector<enbt::value> tokens;
+    push_decoder decoder{[this](enbt::value&& token) { tokens.push_back(std::move(token)); }};
+};
+
+int main() {
+    std::stringstream stream;
+    for (auto& token : make_tokens())
+        write_token(stream, token);
+    std::string bytes = stream.str();
+    const std::uint8_t* data = (const std::uint8_t*)bytes.data();
+
+    std::vector<enbt::value> expected;
+    while (stream.tellg() < std::streampos(bytes.size()))
+        expected.push_back(read_token(stream));
+    assert(expected.size() == make_tokens().size());
+
+    //every split into two pieces, the decoder is idle only between tokens
+    for (std::size_t split = 0; split <= bytes.size(); split++) {
+        collector result;
+        result.decoder.feed(data, split);
+        result.decoder.feed(data + split, bytes.size() - split);
+        assert(result.decoder.idle());
+        assert(result.tokens == expected);
+    }
+
+    //byte by byte and in random pieces
+    {
+        collector result;
+        for (std::size_t i = 0; i < bytes.size(); i++)
+            result.decoder.feed(data + i, 1);
+        assert(result.decoder.idle() && result.tokens == expected);
+    }
+    std::mt19937 random_sizes(22);
+    for (int round = 0; round < 50; round++) {
+        collector result;
+        for (std::size_t pos = 0; pos < bytes.size();) {
+            std::size_t size = std::min<std::size_t>(random_sizes() % 40, bytes.size() - pos);
+            result.decoder.feed(data + pos, size);
+            pos += size;
+        }
+        assert(result.decoder.idle() && result.tokens == expected);
+    }
+
+    //a partial token is kept until reset, then the decoder starts over
+    {
+        collector result;
+        result.decoder.feed(data, 5);
+        assert(!result.decoder.idle() && result.tokens.empty());
+        result.decoder.reset();
+        assert(result.decoder.idle());
+        result.decoder.feed(data, bytes.size());
+        assert(result.tokens == expected);
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
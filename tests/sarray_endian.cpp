@@ -0,0 +1,49 @@
+//checks that sarrays with a non native endian flag compare and order by their item values
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+static enbt::value round_trip(const enbt::value& val) {
+    std::stringstream stream;
+    enbt::io_helper::write_token(stream, val);
+    return enbt::io_helper::read_token(stream);
+}
+
+static enbt::value foreign(const std::uint32_t* items, std::size_t size) {
+    constexpr std::endian other = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+    std::uint32_t swapped[8];
+    for (std::size_t i = 0; i < size; i++)
+        swapped[i] = enbt::endian_helpers::convert_endian(other, items[i]);
+    return enbt::value(swapped, size, other, true);
+}
+
+int main() {
+    //0x100 > 0x1 but its lowest byte is smaller, a byte swapped compare would order them the other way
+    std::uint32_t low[3] = {1, 2, 0x1};
+    std::uint32_t high[3] = {1, 2, 0x100};
+    enbt::value foreign_low = foreign(low, 3);
+    enbt::value foreign_high = foreign(high, 3);
+    assert(foreign_low.type_id().get_endian() != std::endian::native);
+
+    auto ref = enbt::simple_array_const_ref<std::uint32_t>::make_ref(foreign_high);
+    assert(ref[2] == 0x100);
+    assert(ref.max() == 0x100);
+
+    assert(foreign_low < foreign_high);
+    assert(!(foreign_low == foreign_high));
+    assert(foreign_low == foreign(low, 3));
+    assert((foreign_low <=> foreign(low, 3)) == 0);
+
+    enbt::value decoded_low = round_trip(foreign_low);
+    enbt::value decoded_high = round_trip(foreign_high);
+    assert(decoded_low.type_id().endian == foreign_low.type_id().endian);
+    assert(decoded_low == foreign_low);
+    assert(decoded_low < decoded_high);
+    assert(foreign_low.hash() == decoded_low.hash());
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+//checks the sarray kernels of the build target against the standard algorithms, every length crosses the vector tails
+#include "../enbt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace enbt::__impl__;
+
+static std::mt19937_64 random_bits(5);
+
+template <class T>
+static T swapped(T item) {
+    using U = std::make_unsigned_t<T>;
+    U res = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++)
+        res = U(res << 8) | U((U)item >> (8 * i) & 0xFF);
+    return (T)res;
+}
+
+template <class T>
+static void check() {
+    for (std::size_t size = 0; size < 300; size++)
+        for (int round = 0; round < 4; round++) {
+            //small ranges repeat items, so find and count see several matches
+            std::vector<T> items(size);
+            for (auto& item : items)
+                item = round < 2 ? T(random_bits() % 5) : T(random_bits());
+            T needle = size ? items[random_bits() % size] : T(1);
+
+            assert(sarray_find(items.data(), size, needle) == std::size_t(std::find(items.begin(), items.end(), needle) - items.begin()));
+            assert(sarray_count(items.data(), size, needle) == std::size_t(std::count(items.begin(), items.end(), needle)));
+            std::uint64_t total = 0;
+            for (auto item : items)
+                total += (std::uint64_t)item;
+            assert((std::uint64_t)sarray_sum(items.data(), size) == total);
+            if (size) {
+                assert(sarray_min(items.data(), size) == *std::min_element(items.begin(), items.end()));
+                assert(sarray_max(items.data(), size) == *std::max_element(items.begin(), items.end()));
+            }
+
+            std::vector<T> other = items;
+            if (size)
+                other[random_bits() % size] ^= T(1);
+            assert(sarray_mismatch(items.data(), other.data(), size) == std::size_t(std::mismatch(items.begin(), items.end(), other.begin()).first - items.begin()));
+
+            if constexpr (sizeof(T) > 1) {
+                std::vector<T> out(size);
+                enbt::endian_helpers::byteswap_items(out.data(), items.data(), sizeof(T), size);
+                for (std::size_t i = 0; i < size; i++)
+                    assert(out[i] == swapped(items[i]));
+            }
+        }
+}
+
+int main() {
+    check<std::uint8_t>();
+    check<std::uint16_t>();
+    check<std::uint32_t>();
+    check<std::uint64_t>();
+    check<std::int8_t>();
+    check<std::int16_t>();
+    check<std::int32_t>();
+    check<std::int64_t>();
+
+    std::vector<std::uint8_t> in(16 * 7), out(16 * 7);
+    for (auto& byte : in)
+        byte = std::uint8_t(random_bits());
+    enbt::endian_helpers::byteswap_items(out.data(), in.data(), 16, 7);
+    for (std::size_t i = 0; i < in.size(); i++)
+        assert(out[i] == in[i / 16 * 16 + 15 - i % 16]);
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
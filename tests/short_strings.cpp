@@ -0,0 +1,35 @@
+//checks what the const and non-const accessors return for inline and heap strings
+#include "../enbt.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <variant>
+
+int main() {
+    const enbt::value short_text("tag");
+    const enbt::value long_text(std::string(40, 'x'));
+
+    //const content() hands out the inline chars of a short string and the std::string of a long one
+    auto short_content = short_text.content();
+    assert(std::holds_alternative<std::uint8_t*>(short_content));
+    assert(std::strcmp((const char*)std::get<std::uint8_t*>(short_content), "tag") == 0);
+    assert(std::holds_alternative<std::string*>(long_text.content()));
+
+    //the readers accept both forms
+    assert(std::strcmp((const char*)short_text, "tag") == 0);
+    assert(std::strlen((const char*)long_text) == 40);
+    assert(short_text.as_string_view() == "tag" && (std::string)long_text == std::string(40, 'x'));
+
+    //the value_variants constructor takes either form back
+    enbt::value rebuilt(short_content, short_text.type_id(), 0);
+    assert(rebuilt == short_text);
+
+    //the non-const overload boxes so it can return the std::string
+    enbt::value mutable_text("tag");
+    std::get<std::string*>(mutable_text.content())->append("s");
+    assert(mutable_text.as_string_view() == "tags");
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+//checks that operator==, hash and operator<=> agree for values built in different ways
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static void check_same(const enbt::value& left, const enbt::value& right) {
+    assert(left == right);
+    assert((left <=> right) == 0);
+    assert((right <=> left) == 0);
+    assert(left.hash() == right.hash());
+    assert(std::hash<enbt::value>{}(left) == std::hash<enbt::value>{}(right));
+}
+
+static void check_different(const enbt::value& left, const enbt::value& right) {
+    assert(!(left == right));
+    assert((left <=> right) != 0);
+    assert((left < right) != (right < left));
+}
+
+static enbt::value round_trip(const enbt::value& val) {
+    std::stringstream stream;
+    enbt::io_helper::write_token(stream, val);
+    return enbt::io_helper::read_token(stream);
+}
+
+int main() {
+    std::vector<enbt::value> items{enbt::value(std::int32_t(1)), enbt::value(std::int32_t(2)), enbt::value(std::int32_t(3))};
+    std::vector<enbt::value> mixed{enbt::value(std::int32_t(1)), enbt::value("two"), enbt::value()};
+
+    //arrays, data_len is set by some constructors and left 0 by others
+    auto array_moved = enbt::value(std::vector<enbt::value>(items));
+    enbt::value array_copied(items);
+    enbt::value array_typed(std::vector<enbt::value>(items), enbt::type_id{enbt::type::array});
+    enbt::value array_template(std::vector<std::int32_t>{1, 2, 3});
+    check_same(array_moved, array_copied);
+    check_same(array_moved, array_typed);
+    check_same(array_copied, array_typed);
+    check_same(array_moved, array_template);
+    check_same(array_moved, round_trip(array_moved));
+    check_same(array_typed, round_trip(array_typed));
+
+    auto darray_moved = enbt::value(std::vector<enbt::value>(mixed));
+    enbt::value darray_typed(std::vector<enbt::value>(mixed), enbt::type_id{enbt::type::darray});
+    check_same(darray_moved, darray_typed);
+    check_same(darray_moved, round_trip(darray_typed));
+
+    //the same arrays nested in compounds
+    std::unordered_map<std::string, enbt::value> left{{"a", array_moved}, {"d", darray_moved}};
+    std::unordered_map<std::string, enbt::value> right{{"a", array_typed}, {"d", darray_typed}};
+    check_same(enbt::value(left), enbt::value(right));
+
+    //values that differ must not compare equal and must order one way
+    check_different(array_moved, enbt::value(std::vector<enbt::value>{enbt::value(std::int32_t(1)), enbt::value(std::int32_t(2))}));
+    check_different(array_moved, darray_moved);
+    check_different(enbt::value(std::int32_t(1)), enbt::value(std::int64_t(1)));
+    check_different(enbt::value("a"), enbt::value("b"));
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+//checks that value_path_set::extract finds the same values as get_value_path, over streams and spans
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace enbt::io_helper;
+
+static enbt::value make_record(std::int64_t id) {
+    std::unordered_map<std::string, enbt::value> user{
+        {"id", enbt::value(id)},
+        {"name", enbt::value(std::string(40, char('a' + id)))}
+    };
+    std::unordered_map<std::string, enbt::value> record{
+        {"user", enbt::value(user)},
+        {"tags", enbt::value(enbt::dynamic_array(std::vector<enbt::value>{enbt::value("red"), enbt::value(std::int32_t(5))}))},
+        {"scores", enbt::value(std::vector<enbt::value>{enbt::value(std::int32_t(7)), enbt::value(std::int32_t(8)), enbt::value(std::int32_t(9 + id))})}
+    };
+    return enbt::value(record);
+}
+
+int main() {
+    std::vector<value_path> found{
+        value_path("user.id"),
+        value_path("user.name"),
+        value_path("user"),
+        value_path("tags.0"),
+        value_path("tags.1"),
+        value_path("scores.2")
+    };
+    value_path_set paths;
+    for (auto& path : found)
+        paths.add(path);
+    std::size_t missing = paths.add(value_path("user.missing"));
+    std::size_t missing_root = paths.add(value_path("missing"));
+    assert(paths.size() == found.size() + 2);
+
+    std::stringstream stream;
+    for (std::int64_t id = 0; id < 3; id++)
+        write_token(stream, make_record(id));
+    std::string bytes = stream.str();
+
+    //extract leaves the cursor after each record, get_value_path leaves it where it was
+    span_stream span((const std::uint8_t*)bytes.data(), bytes.size());
+    for (std::int64_t id = 0; id < 3; id++) {
+        auto start = stream.tellg();
+        std::vector<enbt::value> expected;
+        for (auto& path : found) {
+            expected.push_back(get_value_path(stream, path));
+            assert(stream.tellg() == start);
+        }
+        assert((std::int64_t)expected[0] == id);
+        assert(expected[2] == make_record(id)["user"]);
+
+        auto from_stream = paths.extract(stream);
+        auto from_span = paths.extract(span);
+        assert(from_stream.size() == paths.size() && from_span.size() == paths.size());
+        for (std::size_t i = 0; i < found.size(); i++) {
+            assert(from_stream[i] && *from_stream[i] == expected[i]);
+            assert(from_span[i] && *from_span[i] == expected[i]);
+        }
+        assert(!from_stream[missing] && !from_stream[missing_root]);
+        assert(!from_span[missing] && !from_span[missing_root]);
+    }
+    assert(stream.tellg() == std::streampos(bytes.size()));
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
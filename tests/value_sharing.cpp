@@ -0,0 +1,117 @@
+//checks that copies of a shared value stay isolated whichever accessor mutates them
+#include "../enbt.hpp"
+#include <cassert>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+template <class Ref>
+concept can_push_back = requires(Ref ref) { ref.push_back(enbt::value(1)); };
+
+static enbt::value make_array() {
+    return enbt::value(std::vector<enbt::value>{enbt::value(std::int32_t(1)), enbt::value(std::int32_t(2))});
+}
+
+int main() {
+    //the const overloads hand out refs that cannot mutate the payload
+    static_assert(!can_push_back<decltype(std::declval<const enbt::value&>().as_array())>);
+    static_assert(!can_push_back<decltype(std::declval<const enbt::value&>().as_fixed_array())>);
+    static_assert(can_push_back<decltype(std::declval<enbt::value&>().as_array())>);
+
+    {
+        enbt::value a = make_array();
+        a.share();
+        enbt::value b = a;
+        assert(a.is_shared() && b.is_shared());
+        std::get<std::vector<enbt::value>*>(b.content())->push_back(enbt::value(std::int32_t(3)));
+        assert(a.size() == 2 && b.size() == 3);
+        assert(!a.is_shared());
+    }
+    {
+        enbt::value a = make_array();
+        a.share();
+        enbt::value b = a;
+        std::vector<std::int32_t> items = b;
+        assert(items.size() == 2);
+        enbt::dynamic_array_ref ref = b.as_array();
+        ref.push_back(std::int32_t(3));
+        assert(a.size() == 2 && b.size() == 3);
+    }
+    {
+        enbt::value e = make_array();
+        e.share();
+        const enbt::value f = e;
+        enbt::dynamic_array copy(f.as_array());
+        copy.push_back(std::int32_t(3));
+        assert(e.size() == 2 && f.size() == 2);
+    }
+    {
+        std::unordered_map<std::string, enbt::value> fields{{"name", enbt::value("a string too long to be inline")}, {"items", make_array()}};
+        enbt::value a(fields);
+        a.share();
+        enbt::value b = a;
+        b.as_compound()["added"] = enbt::value(true);
+        b["items"].push(enbt::value(std::int32_t(3)));
+        assert(a.size() == 2 && b.size() == 3);
+        assert(a["items"].size() == 2 && b["items"].size() == 3);
+        const enbt::value c = a;
+        bool thrown = false;
+        try {
+            (void)c.as_compound()["missing"];
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown && a.size() == 2);
+    }
+    {
+        enbt::value inner = make_array();
+        inner.share();
+        enbt::value a(true, inner);
+        enbt::value b = a;
+        b.get_optional()->push(enbt::value(std::int32_t(3)));
+        assert(inner.size() == 2 && a.get_optional()->size() == 2 && b.get_optional()->size() == 3);
+
+        enbt::value log = enbt::to_log_item(inner);
+        log.get_log_value().push(enbt::value(std::int32_t(3)));
+        assert(inner.size() == 2 && log.get_log_value().size() == 3);
+    }
+    {
+        std::string long_text(100, 'x');
+        enbt::value a(long_text);
+        a.share();
+        enbt::value b = a;
+        ((std::string&)b).push_back('y');
+        assert(a.size() == 100 && b.size() == 101);
+    }
+    {
+        //share moves the bare payloads of the whole subtree, copies then retain the elements too
+        std::unordered_map<std::string, enbt::value> fields{{"items", make_array()}, {"bytes", enbt::value(std::vector<std::uint8_t>(32, 7))}};
+        enbt::value a(fields);
+        assert(!a.is_shared());
+        a.share();
+        enbt::value b = a;
+        assert(a.is_shared() && b.is_shared());
+        b["items"].push(enbt::value(std::int32_t(3)));
+        assert(a["items"].size() == 2 && b["items"].size() == 3);
+        assert(a.hash() == enbt::value(a).hash());
+    }
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        enbt::value a;
+        {
+            enbt::memory_scope scope(&arena);
+            a = make_array();
+            a.share();
+        }
+        enbt::value b = a;
+        assert(a.is_shared());
+        b.push(enbt::value(std::int32_t(3)));
+        assert(a.size() == 2 && b.size() == 3);
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,41 @@
+//checks that var_integers are written as raw varint bytes to streams and sinks
+#include "../enbt.hpp"
+#include "../io.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+int main() {
+    for (std::int64_t number : {std::int64_t(0), std::int64_t(1), std::int64_t(-1), std::int64_t(63), std::int64_t(64), std::int64_t(300), std::int64_t(-70000), INT64_MAX, INT64_MIN}) {
+        enbt::value item(number, true);
+
+        std::ostringstream stream;
+        enbt::io_helper::write_token(stream, item);
+        std::string bytes = stream.str();
+
+        std::vector<std::uint8_t> buffer;
+        {
+            enbt::io_helper::output_sink sink(buffer);
+            enbt::io_helper::write_token(sink, item);
+        }
+        assert(std::string(buffer.begin(), buffer.end()) == bytes);
+
+        //type id, then a zigzag varint with continuation bits on every byte but the last
+        std::uint64_t zigzag = (std::uint64_t(number) << 1) ^ std::uint64_t(number >> 63);
+        std::size_t expected = 1;
+        while (zigzag >>= 7)
+            expected++;
+        assert(bytes.size() == 1 + expected);
+        for (std::size_t i = 1; i + 1 < bytes.size(); i++)
+            assert(std::uint8_t(bytes[i]) & 0x80);
+        assert(!(std::uint8_t(bytes.back()) & 0x80));
+
+        std::istringstream in(bytes);
+        assert((std::int64_t)enbt::io_helper::read_token(in) == number);
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}
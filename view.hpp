@@ -0,0 +1,149 @@
+#ifndef ENBT_VIEW
+#define ENBT_VIEW
+#include "io.hpp"
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace enbt {
+    //non owning read only view over encoded enbt, values are decoded on access
+    // the viewed bytes must outlive the view and all views obtained from it, a view holds no state besides
+    // the bytes, so it is cheap to copy and can be read from several threads
+    class value_view {
+        const std::byte* begin = nullptr; //first byte of the value, after its type id
+        const std::byte* end = nullptr;
+        enbt::type_id tid;
+
+        value_view(const std::byte* begin, const std::byte* end, enbt::type_id tid)
+            : begin(begin), end(end), tid(tid) {}
+
+        io_helper::span_stream stream_at(std::size_t offset) const;
+        value_view child_at(std::size_t offset) const;
+        std::optional<value_view> find(std::string_view key) const;
+
+    public:
+        value_view() = default;
+        //view over a token, type id followed by the value
+        explicit value_view(std::span<const std::byte> token);
+        //view over a value whose type id is stored elsewhere
+        value_view(std::span<const std::byte> value_bytes, enbt::type_id tid);
+
+        enbt::type_id type_id() const {
+            return tid;
+        }
+
+        bool is_log_item() const {
+            return tid.type == enbt::type::log_item;
+        }
+
+        bool is_string() const {
+            return tid.type == enbt::type::string;
+        }
+
+        bool is_uuid() const {
+            return tid.type == enbt::type::uuid;
+        }
+
+        bool is_compound() const {
+            return tid.type == enbt::type::compound;
+        }
+
+        bool is_array() const {
+            return tid.type == enbt::type::array || tid.type == enbt::type::darray;
+        }
+
+        bool is_dyn_array() const {
+            return tid.type == enbt::type::darray;
+        }
+
+        bool is_fixed_array() const {
+            return tid.type == enbt::type::array;
+        }
+
+        bool is_sarray() const {
+            return tid.type == enbt::type::sarray;
+        }
+
+        bool is_numeric() const {
+            return tid.type == enbt::type::integer || tid.type == enbt::type::var_integer || tid.type == enbt::type::comp_integer || tid.type == enbt::type::floating;
+        }
+
+        bool is_bit() const {
+            return tid.type == enbt::type::bit;
+        }
+
+        bool is_none() const {
+            return tid.type == enbt::type::none;
+        }
+
+        bool is_optional() const {
+            return tid.type == enbt::type::optional;
+        }
+
+        std::size_t size() const;
+
+        //index and key access is always range checked, throws std::out_of_range,
+        // items of darrays and arrays of variable size items, and compound keys, are found by skipping the ones before
+        value_view operator[](std::size_t index) const;
+
+        value_view operator[](int index) const {
+            return operator[]((std::size_t)index);
+        }
+
+        value_view operator[](std::string_view key) const;
+
+        value_view operator[](const char* key) const {
+            return operator[](std::string_view(key));
+        }
+
+        value_view at(std::size_t index) const {
+            return operator[](index);
+        }
+
+        value_view at(std::string_view key) const {
+            return operator[](key);
+        }
+
+        value get_index(std::size_t index) const;
+
+        //views of every item or entry found in one pass, keep them to index a large container many times
+        std::vector<value_view> items() const;
+        std::vector<std::pair<std::string_view, value_view>> entries() const;
+
+        bool contains() const;
+        bool contains(std::string_view key) const;
+        std::optional<value_view> get_optional() const;
+        value_view get_log_value() const;
+
+        //zero copy, points into the viewed bytes
+        std::string_view as_string() const;
+        //encoded bytes of the value, without the type id
+        std::span<const std::byte> raw() const;
+
+        //decodes the viewed value into an owning value
+        value to_value() const;
+
+        explicit operator value() const {
+            return to_value();
+        }
+
+        operator bool() const;
+        operator std::int8_t() const;
+        operator std::int16_t() const;
+        operator std::int32_t() const;
+        operator std::int64_t() const;
+        operator std::uint8_t() const;
+        operator std::uint16_t() const;
+        operator std::uint32_t() const;
+        operator std::uint64_t() const;
+        operator float() const;
+        operator double() const;
+        operator enbt::raw_uuid() const;
+        operator std::string_view() const;
+        explicit operator std::string() const;
+    };
+}
+
+#endif /* ENBT_VIEW */